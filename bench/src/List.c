@@ -0,0 +1,730 @@
+#define _POSIX_C_SOURCE 200112L /* clock_gettime, getopt */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../include/List.h"
+
+
+/**
+ * @brief - how many measured runs an operation gets for each size, unless
+ * 	the size is too big for the values budget
+ */
+#define BENCH_DEFAULT_RUNS 20
+
+
+/**
+ * @brief - how many runs an operation gets before being measured, so caches,
+ * 	allocator and page tables are warm
+ */
+#define BENCH_DEFAULT_WARMUPS 3
+
+
+/**
+ * @brief - how many values a run handles at least: runs on small lists
+ * 	handle several lists, so they last well over the clock resolution
+ */
+#define BENCH_MIN_VALUES_PER_RUN 100000
+
+
+/**
+ * @brief - how many values the measured runs of a size handle at most, big
+ * 	lists get fewer runs, and a single warm-up
+ */
+#define BENCH_VALUES_BUDGET 200000000UL
+
+
+/**
+ * @brief - the fewest measured runs an operation gets, whatever the budget
+ */
+#define BENCH_MIN_RUNS 3
+
+
+/**
+ * @brief - how many sizes are measured by default, from 10 to 10^8
+ */
+#define BENCH_DEFAULT_SIZES_COUNT 8
+
+
+
+
+/**
+ * @brief - the lists a run works on, all of the same size
+ */
+typedef struct bench_lists
+{
+	/**
+	 * @brief - the lists, NULL once deleted or not created yet
+	 */
+	linked_list ** lists;
+
+	/**
+	 * @brief - how many lists there are
+	 */
+	size_t count;
+
+	/**
+	 * @brief - how many values each list holds once filled
+	 */
+	size_t size;
+} bench_lists;
+
+
+/**
+ * @brief - a measured operation
+ */
+typedef struct bench_operation
+{
+	/**
+	 * @brief - the name of the operation, in the report
+	 */
+	char const * name;
+
+	/**
+	 * @brief - 1 if the lists are filled before the run, 0 if it starts
+	 * 	from empty lists
+	 */
+	int needs_filled_lists;
+
+	/**
+	 * @brief - the timed part of a run, applying the operation on every
+	 * 	value of every list, returns 0 if allocation failed
+	 */
+	int (* run)(bench_lists * lists);
+} bench_operation;
+
+
+/**
+ * @brief - the timings of an operation for a size, in nanoseconds per value
+ */
+typedef struct bench_result
+{
+	/**
+	 * @brief - the measured operation
+	 */
+	char const * operation;
+
+	/**
+	 * @brief - how many values each list held
+	 */
+	size_t size;
+
+	/**
+	 * @brief - how many lists each run handled
+	 */
+	size_t lists;
+
+	/**
+	 * @brief - how many runs were measured, and made before
+	 */
+	size_t runs;
+	size_t warmups;
+
+	/**
+	 * @brief - the statistics of the runs
+	 */
+	double min;
+	double p50;
+	double p90;
+	double p99;
+	double max;
+	double mean;
+
+	/**
+	 * @brief - 1 if the lists couldn't be allocated, statistics are then
+	 * 	meaningless
+	 */
+	int skipped;
+} bench_result;
+
+
+/**
+ * @brief - the settings of a benchmark session
+ */
+typedef struct bench_options
+{
+	/**
+	 * @brief - how many runs are measured and made before
+	 */
+	size_t runs;
+	size_t warmups;
+
+	/**
+	 * @brief - the file the results are written to, NULL if none
+	 */
+	char const * output;
+
+	/**
+	 * @brief - the sizes to measure
+	 */
+	size_t * sizes;
+	size_t sizes_count;
+} bench_options;
+
+
+
+
+/**
+ * @brief - the value stored in every node, read by the reducer
+ */
+static int bench_value = 1;
+
+
+/**
+ * @brief - where results of timed loops go, so they aren't optimized away
+ */
+static volatile size_t bench_sink;
+
+
+/**
+ * @brief - the sizes measured when none is given
+ */
+static size_t default_sizes[BENCH_DEFAULT_SIZES_COUNT] = {
+	10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+
+
+
+/**
+ * @brief - reads a monotonic clock
+ *
+ * @return double - the current time, in nanoseconds
+ */
+static double now(void)
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, & time);
+	return (double) time.tv_sec * 1e9 + (double) time.tv_nsec;
+}
+
+
+/**
+ * @brief - appends values to every list until it holds its size
+ *
+ * @param lists - the lists to fill
+ *
+ * @return int - 1 if every list was filled, 0 if allocation failed
+ */
+static int fill_lists(bench_lists * lists)
+{
+	size_t list;
+	size_t value;
+
+	for (list = 0; list < lists->count; list++)
+	{
+		for (value = list_size(lists->lists[list]); value < lists->size;
+			value++)
+			list_append(& lists->lists[list], & bench_value);
+
+		if (list_size(lists->lists[list]) != lists->size)
+			return 0;
+	}
+
+	return 1;
+}
+
+
+/**
+ * @brief - deletes every list left by a run
+ *
+ * @param lists - the lists to delete
+ */
+static void delete_lists(bench_lists * lists)
+{
+	size_t list;
+
+	for (list = 0; list < lists->count; list++)
+		list_delete(& lists->lists[list]);
+}
+
+
+/**
+ * @brief - appends every value, one by one
+ *
+ * @param lists - the empty lists to append to
+ *
+ * @return int - 1 if every value was appended, 0 if allocation failed
+ */
+static int run_append(bench_lists * lists)
+{
+	size_t list;
+	size_t value;
+
+	for (list = 0; list < lists->count; list++)
+	{
+		for (value = 0; value < lists->size; value++)
+			list_append(& lists->lists[list], & bench_value);
+	}
+
+	return list_size(lists->lists[lists->count - 1]) == lists->size;
+}
+
+
+/**
+ * @brief - prepends every value, one by one
+ *
+ * @param lists - the empty lists to prepend to
+ *
+ * @return int - 1 if every value was prepended, 0 if allocation failed
+ */
+static int run_prepend(bench_lists * lists)
+{
+	size_t list;
+	size_t value;
+
+	for (list = 0; list < lists->count; list++)
+	{
+		for (value = 0; value < lists->size; value++)
+			list_prepend(& lists->lists[list], & bench_value);
+	}
+
+	return list_size(lists->lists[lists->count - 1]) == lists->size;
+}
+
+
+/**
+ * @brief - removes every node, one by one from the head
+ *
+ * @param lists - the filled lists to empty
+ *
+ * @return int - 1
+ */
+static int run_remove(bench_lists * lists)
+{
+	size_t list;
+
+	for (list = 0; list < lists->count; list++)
+	{
+		while (lists->lists[list] != NULL)
+			list_remove_node(& lists->lists[list]);
+	}
+
+	return 1;
+}
+
+
+/**
+ * @brief - sums the values it is given
+ *
+ * @param accumulator - the sum
+ * @param value - the value to add
+ */
+static void sum_reducer(void * accumulator, void const * value)
+{
+	* (size_t *) accumulator += (size_t) * (int const *) value;
+}
+
+
+/**
+ * @brief - sums every value with list_reduce
+ *
+ * @param lists - the filled lists to reduce
+ *
+ * @return int - 1
+ */
+static int run_reduce(bench_lists * lists)
+{
+	size_t list;
+	size_t sum = 0;
+
+	for (list = 0; list < lists->count; list++)
+		list_reduce(lists->lists[list], & sum, sum_reducer);
+	bench_sink = sum;
+
+	return 1;
+}
+
+
+/**
+ * @brief - deletes every list at once
+ *
+ * @param lists - the filled lists to delete
+ *
+ * @return int - 1
+ */
+static int run_delete(bench_lists * lists)
+{
+	delete_lists(lists);
+
+	return 1;
+}
+
+
+/**
+ * @brief - measures every list as many times as it holds values
+ *
+ * @param lists - the filled lists to measure
+ *
+ * @return int - 1
+ */
+static int run_size(bench_lists * lists)
+{
+	size_t list;
+	size_t value;
+	size_t sizes = 0;
+
+	for (list = 0; list < lists->count; list++)
+	{
+		for (value = 0; value < lists->size; value++)
+			sizes += list_size(lists->lists[list]);
+	}
+	bench_sink = sizes;
+
+	return 1;
+}
+
+
+/**
+ * @brief - the measured operations, in report order
+ */
+static bench_operation const operations[] = {
+	{ "append", 0, run_append },
+	{ "prepend", 0, run_prepend },
+	{ "remove", 1, run_remove },
+	{ "reduce", 1, run_reduce },
+	{ "delete", 1, run_delete },
+	{ "size", 1, run_size }
+};
+
+
+
+
+/**
+ * @brief - orders timings, for qsort
+ */
+static int compare_timings(void const * first, void const * second)
+{
+	double a = * (double const *) first;
+	double b = * (double const *) second;
+
+	return (a > b) - (a < b);
+}
+
+
+/**
+ * @brief - gives the nearest rank percentile of sorted timings
+ *
+ * @param timings - the sorted timings
+ * @param count - how many timings there are, not 0
+ * @param percent - the percentile, from 1 to 100
+ *
+ * @return double - the smallest timing at least percent of timings don't
+ * 	exceed
+ */
+static double percentile(double const * timings, size_t count, size_t percent)
+{
+	size_t rank = (count * percent + 99) / 100;
+
+	return timings[(rank > 0) ? rank - 1 : 0];
+}
+
+
+/**
+ * @brief - makes one run of an operation: lists are filled beforehand and
+ * 	deleted afterwards, only the operation itself is timed
+ *
+ * @param operation - the operation to run
+ * @param lists - the lists to run it on, deleted when it returns
+ * @param timing - set to the time the operation took, in nanoseconds
+ *
+ * @return int - 1 if the run was made, 0 if allocation failed
+ */
+static int run_once(
+	bench_operation const * operation,
+	bench_lists * lists,
+	double * timing)
+{
+	double start;
+	int is_run = 0;
+
+	if (! operation->needs_filled_lists || fill_lists(lists))
+	{
+		start = now();
+		is_run = operation->run(lists);
+		* timing = now() - start;
+	}
+
+	delete_lists(lists);
+	return is_run;
+}
+
+
+/**
+ * @brief - measures an operation on lists of the given size
+ *
+ * @param operation - the operation to measure
+ * @param size - how many values each list holds
+ * @param options - the runs to make
+ * @param result - set to the timings of the operation
+ */
+static void measure(
+	bench_operation const * operation,
+	size_t size,
+	bench_options const * options,
+	bench_result * result)
+{
+	bench_lists lists;
+	double * timings;
+	double total = 0;
+	size_t run;
+
+	memset(result, 0, sizeof(* result));
+	result->operation = operation->name;
+	result->size = size;
+	result->lists = (BENCH_MIN_VALUES_PER_RUN + size - 1) / size;
+	result->runs = options->runs;
+	result->warmups = options->warmups;
+	if (result->runs * result->lists * size > BENCH_VALUES_BUDGET)
+	{
+		result->runs = BENCH_VALUES_BUDGET / (result->lists * size);
+		if (result->runs < BENCH_MIN_RUNS)
+			result->runs = BENCH_MIN_RUNS;
+		if (result->warmups > 1)
+			result->warmups = 1;
+	}
+
+	lists.count = result->lists;
+	lists.size = size;
+	lists.lists = calloc(lists.count, sizeof(* lists.lists));
+	timings = malloc(result->runs * sizeof(* timings));
+	result->skipped = (lists.lists == NULL || timings == NULL);
+
+	for (run = 0; ! result->skipped && run < result->warmups; run++)
+		result->skipped = ! run_once(operation, & lists, & timings[0]);
+
+	for (run = 0; ! result->skipped && run < result->runs; run++)
+	{
+		result->skipped = ! run_once(operation, & lists, & timings[run]);
+		timings[run] /= (double) (lists.count * size);
+		total += timings[run];
+	}
+
+	if (! result->skipped)
+	{
+		qsort(timings, result->runs, sizeof(* timings), compare_timings);
+		result->min = timings[0];
+		result->p50 = percentile(timings, result->runs, 50);
+		result->p90 = percentile(timings, result->runs, 90);
+		result->p99 = percentile(timings, result->runs, 99);
+		result->max = timings[result->runs - 1];
+		result->mean = total / (double) result->runs;
+	}
+
+	free(lists.lists);
+	free(timings);
+}
+
+
+
+
+/**
+ * @brief - prints a result as a line of the report table
+ *
+ * @param result - the result to print
+ */
+static void print_result(bench_result const * result)
+{
+	if (result->skipped)
+	{
+		printf("%-8s %10lu   skipped, lists couldn't be allocated\n",
+			result->operation,
+			(unsigned long) result->size);
+		return;
+	}
+
+	printf("%-8s %10lu %5lu %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+		result->operation,
+		(unsigned long) result->size,
+		(unsigned long) result->runs,
+		result->min,
+		result->p50,
+		result->p90,
+		result->p99,
+		result->max);
+	fflush(stdout);
+}
+
+
+/**
+ * @brief - writes every result to a JSON file
+ *
+ * @param path - the path of the file
+ * @param options - the settings the results were measured with
+ * @param results - the results to write
+ * @param count - how many results there are
+ *
+ * @return int - 1 if the file was written, 0 otherwise
+ */
+static int write_results(
+	char const * path,
+	bench_options const * options,
+	bench_result const * results,
+	size_t count)
+{
+	FILE * file = fopen(path, "w");
+	time_t seconds = time(NULL);
+	char date[32];
+	size_t index;
+	int is_written;
+
+	if (file == NULL)
+		return 0;
+
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(& seconds));
+	fprintf(file, "{\n");
+	fprintf(file, "\t\"date\": \"%s\",\n", date);
+#ifdef __VERSION__
+	fprintf(file, "\t\"compiler\": \"%s\",\n", __VERSION__);
+#endif
+	fprintf(file, "\t\"unit\": \"ns per value\",\n");
+	fprintf(file, "\t\"runs\": %lu,\n", (unsigned long) options->runs);
+	fprintf(file, "\t\"warmups\": %lu,\n", (unsigned long) options->warmups);
+	fprintf(file, "\t\"results\": [");
+
+	for (index = 0; index < count; index++)
+	{
+		fprintf(file, "%s\n\t\t{ \"operation\": \"%s\", \"size\": %lu",
+			(index > 0) ? "," : "",
+			results[index].operation,
+			(unsigned long) results[index].size);
+		if (results[index].skipped)
+		{
+			fprintf(file, ", \"skipped\": true }");
+			continue;
+		}
+
+		fprintf(file, ", \"lists\": %lu, \"runs\": %lu, \"warmups\": %lu",
+			(unsigned long) results[index].lists,
+			(unsigned long) results[index].runs,
+			(unsigned long) results[index].warmups);
+		fprintf(file, ", \"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f",
+			results[index].min,
+			results[index].p50,
+			results[index].p90);
+		fprintf(file, ", \"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f }",
+			results[index].p99,
+			results[index].max,
+			results[index].mean);
+	}
+
+	fprintf(file, "\n\t]\n}\n");
+	is_written = ! ferror(file);
+
+	return (fclose(file) == 0) && is_written;
+}
+
+
+/**
+ * @brief - reads the settings from the command line:
+ * 	[-r runs] [-w warm-ups] [-o results.json] [sizes...]
+ *
+ * @param argc - how many arguments there are
+ * @param argv - the arguments
+ * @param options - set to the settings read
+ *
+ * @return int - 1 if the arguments are valid, 0 otherwise
+ */
+static int read_options(int argc, char ** argv, bench_options * options)
+{
+	char * end;
+	int option;
+	int index;
+
+	options->runs = BENCH_DEFAULT_RUNS;
+	options->warmups = BENCH_DEFAULT_WARMUPS;
+	options->output = NULL;
+	options->sizes = default_sizes;
+	options->sizes_count = BENCH_DEFAULT_SIZES_COUNT;
+
+	while ((option = getopt(argc, argv, "r:w:o:")) != -1)
+	{
+		if (option == 'r')
+			options->runs = strtoul(optarg, & end, 10);
+		else if (option == 'w')
+			options->warmups = strtoul(optarg, & end, 10);
+		else if (option == 'o')
+			options->output = optarg;
+		else
+			return 0;
+
+		if (option != 'o' && * end != '\0')
+			return 0;
+	}
+
+	if (options->runs == 0)
+		return 0;
+	if (optind == argc)
+		return 1;
+
+	options->sizes_count = (size_t) (argc - optind);
+	options->sizes = malloc(options->sizes_count * sizeof(size_t));
+	if (options->sizes == NULL)
+		return 0;
+
+	for (index = optind; index < argc; index++)
+	{
+		options->sizes[index - optind] = strtoul(argv[index], & end, 10);
+		if (* end != '\0' || options->sizes[index - optind] == 0)
+			return 0;
+	}
+
+	return 1;
+}
+
+
+
+
+int main(int argc, char ** argv)
+{
+	size_t operations_count = sizeof(operations) / sizeof(operations[0]);
+	bench_options options;
+	bench_result * results;
+	size_t operation;
+	size_t size;
+	size_t count = 0;
+
+	if (! read_options(argc, argv, & options))
+	{
+		fprintf(stderr,
+			"usage: %s [-r runs] [-w warm-ups] [-o results.json] [sizes...]\n",
+			argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	results = malloc(options.sizes_count * operations_count * sizeof(* results));
+	if (results == NULL)
+		return EXIT_FAILURE;
+
+	printf("%-8s %10s %5s %10s %10s %10s %10s %10s   (ns per value)\n",
+		"op", "size", "runs", "min", "p50", "p90", "p99", "max");
+	for (size = 0; size < options.sizes_count; size++)
+	{
+		for (operation = 0; operation < operations_count; operation++)
+		{
+			measure(
+				& operations[operation],
+				options.sizes[size],
+				& options,
+				& results[count]);
+			print_result(& results[count++]);
+		}
+	}
+
+	if (options.output != NULL
+		&& ! write_results(options.output, & options, results, count))
+	{
+		fprintf(stderr, "%s: can't write %s\n", argv[0], options.output);
+		free(results);
+		return EXIT_FAILURE;
+	}
+
+	if (options.sizes != default_sizes)
+		free(options.sizes);
+	free(results);
+	return EXIT_SUCCESS;
+}
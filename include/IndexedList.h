@@ -0,0 +1,193 @@
+
+#ifndef INDEXED_LIST_HEADER
+#define INDEXED_LIST_HEADER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * @brief - the position returned when there is no node to point to
+ */
+#define INDEXED_LIST_NOWHERE ((uint32_t) -1)
+
+
+
+
+/**
+ * @brief - a doubly linked list whose nodes live in a single growable array
+ * 	and are linked by 32 bits indexes, positions are stable until compaction
+ */
+typedef struct indexed_list indexed_list;
+
+
+
+
+/**
+ * @brief - creates an empty list and returns it
+ * 	Complexity: O(1)
+ *
+ * @return indexed_list * - the created list, NULL if allocation failed
+ */
+indexed_list * indexed_list_create(void);
+
+
+/**
+ * @brief - deletes the list and sets it to NULL
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to delete
+ */
+void indexed_list_delete(indexed_list ** list);
+
+
+/**
+ * @brief - measures the size of the list
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to measure
+ *
+ * @return size_t - how many nodes are in the list
+ */
+size_t indexed_list_size(indexed_list const * list);
+
+
+/**
+ * @brief - adds a node at the end of the list
+ * 	Complexity: O(1) amortized
+ *
+ * @param list - the list to append a node to
+ * @param value - the value to store in the list
+ *
+ * @return uint32_t - the position of the node, INDEXED_LIST_NOWHERE if
+ * 	allocation failed or if the list is full
+ */
+uint32_t indexed_list_append(indexed_list * list, void * value);
+
+
+/**
+ * @brief - adds a node at the beginning of the list
+ * 	Complexity: O(1) amortized
+ *
+ * @param list - the list to prepend a node to
+ * @param value - the value to store in the list
+ *
+ * @return uint32_t - the position of the node, INDEXED_LIST_NOWHERE if
+ * 	allocation failed or if the list is full
+ */
+uint32_t indexed_list_prepend(indexed_list * list, void * value);
+
+
+/**
+ * @brief - removes the node at the given position, the position may be
+ * 	reused by next insertions
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to remove the node from
+ * @param position - the position of the node to remove
+ *
+ * @return uint32_t - the position of the next node, INDEXED_LIST_NOWHERE if
+ * 	none
+ */
+uint32_t indexed_list_remove(indexed_list * list, uint32_t position);
+
+
+/**
+ * @brief - returns the position of the first node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to get the first node from
+ *
+ * @return uint32_t - the first position, INDEXED_LIST_NOWHERE if empty
+ */
+uint32_t indexed_list_head(indexed_list const * list);
+
+
+/**
+ * @brief - returns the position of the last node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to get the last node from
+ *
+ * @return uint32_t - the last position, INDEXED_LIST_NOWHERE if empty
+ */
+uint32_t indexed_list_tail(indexed_list const * list);
+
+
+/**
+ * @brief - returns the position of the next node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list the node belongs to
+ * @param position - the position to get the next one from
+ *
+ * @return uint32_t - the next position, INDEXED_LIST_NOWHERE if none
+ */
+uint32_t indexed_list_next(indexed_list const * list, uint32_t position);
+
+
+/**
+ * @brief - returns the position of the previous node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list the node belongs to
+ * @param position - the position to get the previous one from
+ *
+ * @return uint32_t - the previous position, INDEXED_LIST_NOWHERE if none
+ */
+uint32_t indexed_list_previous(indexed_list const * list, uint32_t position);
+
+
+/**
+ * @brief - returns the value stored at the given position
+ * 	Complexity: O(1)
+ *
+ * @param list - the list the node belongs to
+ * @param position - the position to get the value from
+ *
+ * @return void * - the value, NULL if the position is out of the list
+ */
+void * indexed_list_content(indexed_list const * list, uint32_t position);
+
+
+/**
+ * @brief - collects every value stored in the list, in order, sweeping the
+ * 	array sequentially while the list is still in compacted order
+ * 	Complexity: O(n)
+ *
+ * @param list - the list to iterate
+ * @param accumulator - the initial value of the accumulator
+ * @param reducer - the callback to apply on every value
+ *
+ * @return - the accumulator
+ */
+void * indexed_list_reduce(
+	indexed_list const * list,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * value));
+
+
+/**
+ * @brief - renumbers the nodes in traversal order and drops unused slots,
+ * 	every previously returned position is invalidated, the head is then at
+ * 	position 0 and each next node right after its previous one
+ * 	Complexity: O(n)
+ *
+ * @param list - the list to compact
+ *
+ * @return int - 1 if the list was compacted, 0 if allocation failed
+ */
+int indexed_list_compact(indexed_list * list);
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
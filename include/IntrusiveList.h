@@ -0,0 +1,68 @@
+
+#ifndef INTRUSIVE_LIST_HEADER
+#define INTRUSIVE_LIST_HEADER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#include "List.h"
+#include "ListNode.h"
+
+
+
+
+/**
+ * @brief - a node embedded in a user structure, so adding the structure to a
+ * 	list doesn't allocate a node
+ * 	A hook stores itself as value: list_content and list_reduce give the hook,
+ * 	use list_container_of to get the structure back
+ * 	Hooks can be mixed with regular nodes, list functions never release them
+ */
+typedef linked_list list_hook;
+
+
+/**
+ * @brief - returns the structure a hook is embedded in
+ *
+ * @param hook - the hook, or a node / value given by the list functions
+ * @param type - the type of the structure the hook is embedded in
+ * @param member - the name of the hook in the structure
+ *
+ * @return type * - the structure holding the hook
+ */
+#define list_container_of(hook, type, member) \
+	((type *) ((char *) (hook) - offsetof(type, member)))
+
+
+
+
+/**
+ * @brief - adds a hook at the end of the list, without allocating a node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to append the hook to
+ * @param hook - the hook to append, not part of any list
+ */
+void list_append_hook(linked_list ** list, list_hook * hook);
+
+
+/**
+ * @brief - adds a hook at the beginning of the list, without allocating a node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to prepend the hook to
+ * @param hook - the hook to prepend, not part of any list
+ */
+void list_prepend_hook(linked_list ** list, list_hook * hook);
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,6 +9,12 @@ extern "C" {
 #include <stddef.h>
 
 
+/**
+ * @brief - the most values list_reduce_batch gives to its reducer at once
+ */
+#define LIST_BATCH_SIZE 64
+
+
 
 
 /**
@@ -17,6 +23,35 @@ extern "C" {
 typedef struct linked_list linked_list;
 
 
+/**
+ * @brief - an immutable view of a list, as it was when the snapshot was taken
+ */
+typedef struct list_view list_view;
+
+
+/**
+ * @brief - the memory functions a list gets its header and nodes from
+ */
+typedef struct list_allocator
+{
+	/**
+	 * @brief - allocates memory, returns NULL if allocation failed
+	 */
+	void * (* allocate)(size_t size, void * context);
+
+	/**
+	 * @brief - releases memory given by allocate, NULL if the memory is
+	 * 	dropped all at once by the owner of the context (arenas)
+	 */
+	void (* release)(void * memory, void * context);
+
+	/**
+	 * @brief - the user data given to both functions
+	 */
+	void * context;
+} list_allocator;
+
+
 
 
 /**
@@ -29,8 +64,91 @@ linked_list * list_create(void);
 
 
 /**
- * @brief - deletes the list and sets the current node to NULL
- * 	Complexity: O(n)
+ * @brief - creates an empty pooled list and returns it, its nodes are carved
+ * 	out of big chunks owned by the list, removed nodes are reused by next
+ * 	insertions and every chunk is released at once when the list is deleted
+ * 	The returned list isn't NULL but behaves as an empty one until a node is
+ * 	added, and is handed back by removals emptying it again, so the pool is
+ * 	kept until the list is deleted
+ * 	Complexity: O(1)
+ *
+ * @param nodes_per_chunk - how many nodes a chunk holds, 0 for the default
+ *
+ * @return linked_list * - the created list, NULL if allocation failed
+ */
+linked_list * list_create_pooled(size_t nodes_per_chunk);
+
+
+/**
+ * @brief - creates an empty list which gets its header and nodes from the
+ * 	given allocator and returns it, if the allocator can't release memory
+ * 	the whole list can be dropped along with it, without deleting the list
+ * 	The returned list isn't NULL but behaves as an empty one until a node is
+ * 	added, and is handed back by removals emptying it again, so the allocator
+ * 	is kept until the list is deleted
+ * 	Complexity: O(1)
+ *
+ * @param allocator - the allocator to use, copied into the list
+ *
+ * @return linked_list * - the created list, NULL if allocation failed or if
+ * 	the allocator has no allocation function
+ */
+linked_list * list_create_with_allocator(list_allocator const * allocator);
+
+
+/**
+ * @brief - creates an empty concurrent list and returns it, any number of
+ * 	threads can append and prepend nodes to it at once, without locking,
+ * 	while a single consumer thread drains them with list_drain
+ * 	The returned list isn't NULL and always behaves as an empty one, except
+ * 	for its size, the count of nodes added and not drained yet
+ * 	Complexity: O(1)
+ *
+ * @return linked_list * - the created list, NULL if allocation failed
+ */
+linked_list * list_create_concurrent(void);
+
+
+/**
+ * @brief - creates an empty synchronized list and returns it, its writers
+ * 	take a lock alone, so several threads can use it at once
+ * 	The returned list isn't NULL and stays the handle of the whole list:
+ * 	appending to it doesn't replace it, it leads to the first node and the
+ * 	list is only released by deleting it
+ * 	Removed nodes are released once no reader can reach them anymore, so
+ * 	reductions, list_head, list_tail, list_size, list_at and list_to_array
+ * 	don't lock, and other walks can be done between list_enter_epoch and
+ * 	list_leave_epoch while writers go on, or between list_lock_reading and
+ * 	list_unlock_reading to hold writers back
+ * 	Writers never wait on readers: a removal that can't allocate room to
+ * 	keep its nodes until they are released removes nothing
+ * 	Complexity: O(1)
+ *
+ * @return linked_list * - the created list, NULL if allocation failed
+ */
+linked_list * list_create_synchronized(void);
+
+
+/**
+ * @brief - detaches every node added so far to a concurrent list, and returns
+ * 	them as a regular list, nodes added while draining may only be given by
+ * 	the next call, must not be called by several threads at once
+ * 	Complexity: O(number of drained nodes)
+ *
+ * @param list - the concurrent list to drain
+ *
+ * @return linked_list * - the first drained node, NULL if none or if the list
+ * 	isn't concurrent
+ */
+linked_list * list_drain(linked_list * list);
+
+
+/**
+ * @brief - deletes the list and sets the current node to NULL, uses constant
+ * 	stack space whatever the size of the list
+ * 	Complexity: O(n), O(number of chunks) for lists whose nodes were all
+ * 	carved out of chunks and O(1) for lists whose allocator can't release
+ * 	memory
  *
  * @param list - the list to delete
  */
@@ -39,7 +157,7 @@ void list_delete(linked_list ** list);
 
 /**
  * @brief - measures the size of the list, from its first node to its last node
- * 	Complexity: O(1)
+ * 	Complexity: O(1), O(n) once after nodes moved to or from another list
  *
  * @param list - the list to measure
  *
@@ -50,7 +168,7 @@ size_t list_size(linked_list const * list);
 
 /**
  * @brief - measures the size of the list, from given node to the end
- * 	Complexity: O(n)
+ * 	Complexity: O(n), O(log n) if the list has a position index
  *
  * @param list - the node to measure from
  *
@@ -61,7 +179,7 @@ size_t list_size_forward(linked_list const * list);
 
 /**
  * @brief - measures the size of the list, from its start node to the given node
- * 	Complexity: O(n)
+ * 	Complexity: O(n), O(log n) if the list has a position index
  *
  * @param list - the node to measure to
  *
@@ -71,7 +189,8 @@ size_t list_size_backward(linked_list const * list);
 
 
 /**
- * @brief - adds a node at the end of the list
+ * @brief - adds a node at the end of the list, several threads can do it
+ * 	at once on a concurrent list
  * 	Complexity: O(1)
  *
  * @param list - the list to append a node to
@@ -81,7 +200,8 @@ void list_append(linked_list ** list, void * value);
 
 
 /**
- * @brief - adds a node at the beginning of the list
+ * @brief - adds a node at the beginning of the list, several threads can do it
+ * 	at once on a concurrent list
  * 	Complexity: O(1)
  *
  * @param list - the list to prepend a node to
@@ -90,15 +210,316 @@ void list_append(linked_list ** list, void * value);
 void list_prepend(linked_list ** list, void * value);
 
 
+/**
+ * @brief - adds nodes storing the given values at the end of the list, in the
+ * 	same order, the nodes are allocated at once, if the list releases its
+ * 	nodes they are carved out of a chunk kept until the list is deleted, and
+ * 	removed ones are reused by later insertions
+ * 	Complexity: O(count)
+ *
+ * @param list - the list to append nodes to
+ * @param values - the values to store in the list
+ * @param count - how many values to store
+ */
+void list_append_array(
+	linked_list ** list,
+	void * const * values,
+	size_t count);
+
+
+/**
+ * @brief - adds nodes storing the given values at the beginning of the list,
+ * 	in the same order, the nodes are allocated at once, if the list releases
+ * 	its nodes they are carved out of a chunk kept until the list is deleted,
+ * 	and removed ones are reused by later insertions
+ * 	Complexity: O(count)
+ *
+ * @param list - the list to prepend nodes to
+ * @param values - the values to store in the list
+ * @param count - how many values to store
+ */
+void list_prepend_array(
+	linked_list ** list,
+	void * const * values,
+	size_t count);
+
+
+/**
+ * @brief - creates a list storing the given values, in the same order, its
+ * 	nodes are allocated at once in a chunk kept until the list is deleted,
+ * 	the list isn't pooled
+ * 	Complexity: O(count)
+ *
+ * @param values - the values to store in the list
+ * @param count - how many values to store
+ *
+ * @return linked_list * - the created list, NULL if count is 0 or if
+ * 	allocation failed
+ */
+linked_list * list_from_array(void * const * values, size_t count);
+
+
+/**
+ * @brief - copies every value stored in the list into a new array, from the
+ * 	first node to the last one
+ * 	Synchronized lists are copied without locking, as many values as their
+ * 	size when the copy starts
+ * 	Complexity: O(n)
+ *
+ * @param list - any node of the list to copy
+ *
+ * @return void ** - the values, list_size(list) of them, to be released with
+ * 	free, NULL if the list is empty or if allocation failed
+ */
+void ** list_to_array(linked_list const * list);
+
+
+/**
+ * @brief - writes every value of the list to the file descriptor, in chunks
+ * 	of about 64 KiB buffered one at a time: the count of values first, then
+ * 	each value prefixed by its size
+ * 	Synchronized lists are locked for reading along, concurrent ones can't be
+ * 	written
+ * 	Complexity: O(n)
+ *
+ * @param fd - the file descriptor to write to
+ * @param list - any node of the list to write, NULL for an empty list
+ * @param encode - writes the value into bytes if its size fits in capacity,
+ * 	returns its size either way
+ *
+ * @return int - 1 if the list was written, 0 otherwise
+ */
+int list_write(
+	int fd,
+	linked_list const * list,
+	size_t (* encode)(void const * value, void * bytes, size_t capacity));
+
+
+/**
+ * @brief - appends every value written by list_write to the list, chunk by
+ * 	chunk, the file descriptor is left right after the written list
+ * 	Nodes of lists releasing their nodes are allocated in blocks growing
+ * 	with the values read so far, never from the count the stream claims
+ * 	alone, a list created by this call isn't pooled
+ * 	Complexity: O(n)
+ *
+ * @param fd - the file descriptor to read from
+ * @param list - the list to append the values to, pointing to NULL to create
+ * 	one
+ * @param decode - creates a value from the bytes it was written as, returns
+ * 	NULL if they are invalid
+ *
+ * @return int - 1 if every value was read, 0 otherwise: the values decoded
+ * 	so far stay in the list
+ */
+int list_read(
+	int fd,
+	linked_list ** list,
+	void * (* decode)(void const * bytes, size_t size));
+
+
+/**
+ * @brief - adds nodes storing the given values right after the given node, in
+ * 	the same order, the nodes are allocated at once unless the list releases
+ * 	its nodes one by one
+ * 	Complexity: O(count)
+ *
+ * @param node - the node to insert after
+ * @param values - the values to store in the list
+ * @param count - how many values to store
+ */
+void list_insert_array_after(
+	linked_list * node,
+	void * const * values,
+	size_t count);
+
+
 /**
  * @brief - removes the given node from the list
+ * 	Nothing is done if a synchronized list can't keep the node until no
+ * 	reader can reach it, for lack of memory
  * 	Complexity: O(1)
  *
- * @param node - the node to remove
+ * @param node - the node to remove, set to the next one, to the anchor of a
+ * 	configured list it empties, which then has to be deleted, or to NULL,
+ * 	left as is if nothing was removed
  */
 void list_remove_node(linked_list ** node);
 
 
+/**
+ * @brief - removes every node whose value matches the predicate, in a single
+ * 	walk: runs of matching nodes are linked over at once and the header is
+ * 	updated once, positions are found again on their next query
+ * 	On synchronized lists, values are destroyed once no reader walking
+ * 	without locking can reach them anymore, at the latest when the list is
+ * 	deleted, and nothing is removed if there's no memory to keep them
+ * 	Concurrent lists are left as is
+ * 	Complexity: O(n)
+ *
+ * @param list - any node of the list, set to the first node left unless it's
+ * 	an anchor, to its anchor if a configured list got empty, which then has
+ * 	to be deleted, NULL if another list got empty
+ * @param predicate - returns non 0 for values to remove
+ * @param context - given to the predicate and the destructor
+ * @param destructor - called on the value of every removed node, NULL if
+ * 	values don't have to be released
+ *
+ * @return size_t - how many nodes were removed
+ */
+size_t list_remove_if(
+	linked_list ** list,
+	int (* predicate)(void const * value, void * context),
+	void * context,
+	void (* destructor)(void * value, void * context));
+
+
+/**
+ * @brief - moves every node of the other list to the end of the list, without
+ * 	walking them: their header gets bound to the one of the list
+ * 	Both lists must have the same allocator, and neither be shared, pooled
+ * 	and plain lists can be mixed: each node is released the way it was
+ * 	allocated, and the chunks of both lists are kept until the list is
+ * 	deleted
+ * 	Positions of the list are found again on their next query
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to append the nodes to, set to its head if it was
+ * 	an empty configured list
+ * @param other - the list to take the nodes from, set to NULL once taken
+ *
+ * @return int - 1 if the nodes were moved, 0 if the lists can't share them
+ */
+int list_concat(linked_list ** list, linked_list ** other);
+
+
+/**
+ * @brief - moves a range of nodes, from its first to its last node, right
+ * 	after a node of the same or another list
+ * 	The range isn't walked: moved nodes find their new list on their next
+ * 	lookup, walking to the closest node bound to it, and the size of both
+ * 	lists is counted again when next asked for, unless a single node moved
+ * 	Shared lists can't give nodes, and lists must have the same allocator,
+ * 	chunks pooled nodes come from are kept until both lists are deleted, as
+ * 	well as the headers moved nodes may be bound to
+ * 	Complexity: O(1)
+ *
+ * @param first - the first node of the range, set to the node that followed
+ * 	the range, or to the anchor of the configured list it empties, like
+ * 	list_remove_node does
+ * @param last - the last node of the range, after or equal to the first one,
+ * 	which isn't checked
+ * @param after - the node to insert the range after, or the anchor of a
+ * 	configured list to insert it at its head, out of the range, which is
+ * 	only checked against the ends of the range
+ *
+ * @return int - 1 if the range was moved, 0 if the target is an end of the
+ * 	range, if the lists can't share nodes or if allocation failed
+ */
+int list_splice(linked_list ** first, linked_list * last, linked_list * after);
+
+
+/**
+ * @brief - splits the list in 2, the node and the following ones make a new
+ * 	list while the previous ones stay in their list
+ * 	The new list gets a header configured like the list, so shared lists
+ * 	can't be split, nodes find their list on their next lookup like spliced
+ * 	ones, and the size of both lists is counted again when next asked for,
+ * 	chunks pooled nodes come from are kept until both lists are deleted
+ * 	Complexity: O(1)
+ *
+ * @param node - the node to split the list at
+ *
+ * @return linked_list * - the node, head of its list, NULL if the list can't
+ * 	be split or if allocation failed, the list is left as is then
+ */
+linked_list * list_split_at(linked_list * node);
+
+
+/**
+ * @brief - sorts the list in place, relinking its nodes with a bottom-up
+ * 	merge sort: stable, iterative and without allocation
+ * 	Shared lists are left as is
+ * 	Complexity: O(n log n)
+ *
+ * @param list - any node of the list to sort, set to the first node unless
+ * 	it's the anchor of a configured list
+ * @param comparator - compares 2 values, negative if the first one goes
+ * 	first, positive if it goes after, 0 to keep their order
+ */
+void list_sort(
+	linked_list ** list,
+	int (* comparator)(void const * first, void const * second));
+
+
+/**
+ * @brief - sorts the list in place with several threads: it's cut in a run
+ * 	per thread in one pass, runs are sorted at once, then each thread
+ * 	merges the values between 2 splitters sampled from every run
+ * 	Stable, runs hold at least 64 nodes so smaller lists use fewer threads,
+ * 	down to list_sort, which is also used if allocation fails
+ * 	Shared lists are left as is
+ * 	Complexity: O(n log n / threads_count + n)
+ *
+ * @param list - any node of the list to sort, set to the first node unless
+ * 	it's the anchor of a configured list
+ * @param threads_count - how many threads to sort with
+ * @param comparator - compares 2 values, negative if the first one goes
+ * 	first, positive if it goes after, 0 to keep their order
+ */
+void list_sort_parallel(
+	linked_list ** list,
+	size_t threads_count,
+	int (* comparator)(void const * first, void const * second));
+
+
+/**
+ * @brief - starts walking a synchronized list: until list_unlock_reading,
+ * 	other readers go on but writers, removals included, wait, the calling
+ * 	thread must not write to the list meanwhile
+ * 	Does nothing for other lists
+ * 	Complexity: O(1)
+ *
+ * @param list - any node of the list to walk
+ */
+void list_lock_reading(linked_list const * list);
+
+
+/**
+ * @brief - ends walking a synchronized list, started by list_lock_reading
+ * 	Complexity: O(1)
+ *
+ * @param list - any node of the list walked
+ */
+void list_unlock_reading(linked_list const * list);
+
+
+/**
+ * @brief - starts walking a synchronized list without locking: writers go
+ * 	on, and nodes they remove meanwhile are only released once the walk is
+ * 	over, so it can go on from them, but may not see nodes added meanwhile
+ * 	Nodes must not be kept after list_leave_epoch, the calling thread may
+ * 	write to the list meanwhile
+ * 	Does nothing for other lists
+ * 	Complexity: O(1)
+ *
+ * @param list - any node of the list to walk
+ *
+ * @return size_t - the epoch entered, to give to list_leave_epoch
+ */
+size_t list_enter_epoch(linked_list const * list);
+
+
+/**
+ * @brief - ends walking a synchronized list, started by list_enter_epoch
+ * 	Complexity: O(1)
+ *
+ * @param list - any node of the list walked
+ * @param epoch - the epoch returned by list_enter_epoch
+ */
+void list_leave_epoch(linked_list const * list, size_t epoch);
+
+
 /**
  * @brief - returns the previous node
  * 	Complexity: O(1)
@@ -143,6 +564,212 @@ linked_list * list_head(linked_list const * list);
 linked_list * list_tail(linked_list const * list);
 
 
+/**
+ * @brief - builds a position index for the list, maintained by appends,
+ * 	prepends and removals, so positions are found in O(log n)
+ * 	Inserting in the middle of the list, or appending once spare positions
+ * 	are used up, makes the next query renumber the whole list in O(n)
+ * 	The index is dropped along with the list once it gets empty
+ * 	Complexity: O(n)
+ *
+ * @param list - any node of the list to index
+ *
+ * @return int - 1 if the list is indexed, 0 if allocation failed
+ */
+int list_enable_position_index(linked_list * list);
+
+
+/**
+ * @brief - drops the position index of the list, if any
+ * 	Complexity: O(1)
+ *
+ * @param list - any node of the list
+ */
+void list_disable_position_index(linked_list * list);
+
+
+/**
+ * @brief - returns the node at the given position
+ * 	Complexity: O(log n) if the list has a position index, O(n) otherwise
+ *
+ * @param list - any node of the list
+ * @param position - the position of the node, 0 for the first one
+ *
+ * @return linked_list * - the node at this position, NULL if out of the list
+ */
+linked_list * list_at(linked_list const * list, size_t position);
+
+
+/**
+ * @brief - returns the position of the node in its list
+ * 	Complexity: O(log n) if the list has a position index, O(n) otherwise
+ *
+ * @param node - the node to get the position of
+ *
+ * @return size_t - the position of the node, 0 for the first one, (size_t) -1
+ * 	if the list is empty
+ */
+size_t list_index_of(linked_list const * node);
+
+
+/**
+ * @brief - builds a hash index from the keys of the values to the nodes
+ * 	holding them, maintained by appends, prepends and removals, so lookups
+ * 	take O(1) expected time
+ * 	Inserting in the middle of the list, moving nodes around, or appending
+ * 	once spare entries are used up, makes the next lookup rebuild the index
+ * 	in O(n), shared lists can't be indexed
+ * 	Values mustn't change their key while in the list, and the index is
+ * 	dropped along with the list once it gets empty
+ * 	Complexity: O(n)
+ *
+ * @param list - any node of the list to index
+ * @param hash - hashes a key, NULL to hash the address of the key
+ * @param key_of - gives the key of a value, NULL if values are their own keys
+ *
+ * @return int - 1 if the list is indexed, 0 if allocation failed or if the
+ * 	list is shared
+ */
+int list_enable_value_index(
+	linked_list * list,
+	size_t (* hash)(void const * key),
+	void const * (* key_of)(void const * value));
+
+
+/**
+ * @brief - drops the value index of the list, if any
+ * 	Complexity: O(1)
+ *
+ * @param list - any node of the list
+ */
+void list_disable_value_index(linked_list * list);
+
+
+/**
+ * @brief - finds the first node whose value matches the key
+ * 	With a value index, a value matching a key must have a key hashing like
+ * 	it, without comparison function the key is a value, hashed as such
+ * 	Complexity: O(1) expected if the list has a value index, O(n) otherwise
+ *
+ * @param list - any node of the list
+ * @param key - the key to look for
+ * @param eq - returns non 0 if the value matches the key, NULL to look for
+ * 	the value at the address of the key
+ *
+ * @return linked_list * - the first matching node, NULL if none
+ */
+linked_list * list_find(
+	linked_list const * list,
+	void const * key,
+	int (* eq)(void const * value, void const * key));
+
+
+/**
+ * @brief - keeps the values of the list in a persistent tree, so snapshots
+ * 	take O(1): appends, prepends and removals change the tree in O(log n),
+ * 	copying the nodes of the path they change only if a snapshot leads to
+ * 	them, the tree is shared with snapshots for the rest
+ * 	Removals use the position index, enabled along unless the list is
+ * 	shared: without it, and after inserting in the middle of the list or
+ * 	moving nodes around, the next snapshot rebuilds the tree in O(n)
+ * 	Complexity: O(n)
+ *
+ * @param list - any node of the list
+ *
+ * @return int - 1 if snapshots are enabled, 0 if allocation failed or if the
+ * 	list is concurrent
+ */
+int list_enable_snapshots(linked_list * list);
+
+
+/**
+ * @brief - drops the tree snapshots are taken from, if any, views already
+ * 	taken are kept
+ * 	Complexity: O(n) at worst, for nodes no view leads to
+ *
+ * @param list - any node of the list
+ */
+void list_disable_snapshots(linked_list * list);
+
+
+/**
+ * @brief - takes an immutable view of the list, which can be read by any
+ * 	thread without lock while the list keeps changing, and outlives it
+ * 	Snapshots of lists which aren't synchronized have to be taken by the
+ * 	thread changing them
+ * 	Complexity: O(1) if snapshots are enabled and the tree is up to date,
+ * 	O(n) otherwise
+ *
+ * @param list - any node of the list, NULL for an empty view
+ *
+ * @return list_view * - the view, to release with list_view_release, NULL if
+ * 	allocation failed or if the list is concurrent
+ */
+list_view * list_snapshot(linked_list const * list);
+
+
+/**
+ * @brief - releases the view and sets it to NULL, along with the nodes
+ * 	neither the list nor other views lead to
+ * 	Complexity: O(n) at worst, O(1) if the list still has the same values
+ *
+ * @param view - the view to release
+ */
+void list_view_release(list_view ** view);
+
+
+/**
+ * @brief - measures the size of the list when the view was taken
+ * 	Complexity: O(1)
+ *
+ * @param view - the view to measure
+ *
+ * @return size_t - how many values the view holds
+ */
+size_t list_view_size(list_view const * view);
+
+
+/**
+ * @brief - gives the version of the list the view was taken from: views of
+ * 	a same list with the same version hold the same values, the version
+ * 	grows as the list changes
+ * 	Complexity: O(1)
+ *
+ * @param view - the view to get the version of
+ *
+ * @return size_t - the version, 0 if snapshots weren't enabled
+ */
+size_t list_view_version(list_view const * view);
+
+
+/**
+ * @brief - returns the value at the given position in the view
+ * 	Complexity: O(log n) expected
+ *
+ * @param view - the view to get the value from
+ * @param position - the position of the value, 0 for the first one
+ *
+ * @return void * - the value, NULL if out of the view
+ */
+void * list_view_at(list_view const * view, size_t position);
+
+
+/**
+ * @brief - collects every value held by the view, in order
+ * 	Complexity: O(n)
+ *
+ * @param view - the view to iterate
+ * @param accumulator - the initial value of the accumulator
+ * @param reducer - the callback to apply on every value
+ *
+ * @return - the accumulator
+ */
+void * list_view_reduce(
+	list_view const * view,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * node_content));
+
+
 /**
  * @brief - returns the value stored in the node
  * 	Complexity: O(1)
@@ -170,6 +797,77 @@ void * list_reduce(
 	void (* reducer)(void * accumulator, void const * node_content));
 
 
+/**
+ * @brief - collects every value stored in the list, like list_reduce, while
+ * 	a cursor walks a few nodes ahead and prefetches them and their values,
+ * 	so cache misses overlap with the reducer instead of stalling it
+ * 	Worth it on big lists whose nodes or values are scattered in memory,
+ * 	and when the reducer reads the values
+ * 	Complexity: O(n)
+ *
+ * @param list - the list to iterate
+ * @param distance - how many nodes the cursor runs ahead, 0 to not prefetch
+ * @param accumulator - the initial value of the accumulator
+ * @param reducer - the callback to apply on every node
+ *
+ * @return - the accumulator
+ */
+void * list_reduce_prefetch(
+	linked_list const * list,
+	size_t distance,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * node_content));
+
+
+/**
+ * @brief - collects every value stored in the list, gathering them in batches
+ * 	of up to LIST_BATCH_SIZE values so the reducer is called once per batch
+ * 	and can process them with SIMD instructions, see ListKernels.h
+ * 	Complexity: O(n)
+ *
+ * @param list - the list to iterate
+ * @param accumulator - the initial value of the accumulator
+ * @param batch_reducer - the callback to apply on every batch of values, in
+ * 	list order, count is never 0
+ *
+ * @return - the accumulator
+ */
+void * list_reduce_batch(
+	linked_list const * list,
+	void * accumulator,
+	void (* batch_reducer)(
+		void * accumulator,
+		void const * const * values,
+		size_t count));
+
+
+/**
+ * @brief - collects every value stored in the list, from its first node to
+ * 	its last one, splitting it in balanced ranges reduced by several threads
+ * 	Ranges are found thanks to nodes recorded while appending, a removal
+ * 	makes the next call walk the list once to find them again
+ * 	Complexity: O(n / threads_count), O(n) after a removal
+ *
+ * @param list - any node of the list to iterate
+ * @param threads_count - how many threads to use, the calling one included
+ * @param accumulator - the accumulator every partial one is combined into
+ * @param init - the callback creating the partial accumulator of a thread
+ * @param reducer - the callback to apply on every node, into the partial
+ * 	accumulator of its range
+ * @param combiner - the callback merging a partial accumulator into the
+ * 	accumulator, called in list order and in charge of releasing it
+ *
+ * @return - the accumulator
+ */
+void * list_reduce_parallel(
+	linked_list const * list,
+	size_t threads_count,
+	void * accumulator,
+	void * (* init)(void),
+	void (* reducer)(void * accumulator, void const * node_content),
+	void (* combiner)(void * accumulator, void * partial_accumulator));
+
+
 
 
 #ifdef __cplusplus
@@ -0,0 +1,116 @@
+
+#ifndef LIST_INLINE_HEADER
+#define LIST_INLINE_HEADER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "List.h"
+#include "ListNode.h"
+
+
+
+
+/**
+ * Accessors inlined in the calling code, so tight loops walk the list with
+ * bare pointer reads instead of calling the library for every node
+ * Unlike their library counterparts, they don't check their node, which must
+ * not be NULL, and they don't order their reads with writers: walks of a
+ * synchronized list have to be done between list_lock_reading and
+ * list_unlock_reading
+ * Linking with lib/liblist.a, built with link time optimization, lets the
+ * compiler inline the other functions as well
+ */
+
+
+
+
+/**
+ * @brief - how functions of this header get inlined, static inline since C99,
+ * 	the GNU keyword before, or as static functions the compiler may inline
+ */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define LIST_INLINE static inline
+#elif defined(__GNUC__)
+#define LIST_INLINE static __inline__
+#else
+#define LIST_INLINE static
+#endif
+
+
+
+
+/**
+ * @brief - returns the next node
+ * 	Complexity: O(1)
+ *
+ * @param list - the node to get the next one from, not NULL
+ *
+ * @return linked_list * - the next node, NULL if none
+ */
+LIST_INLINE linked_list * list_fast_next(linked_list const * list)
+{
+	return list->next;
+}
+
+
+/**
+ * @brief - returns the previous node
+ * 	Complexity: O(1)
+ *
+ * @param list - the node to get the previous one from, not NULL
+ *
+ * @return linked_list * - the previous node, NULL if none
+ */
+LIST_INLINE linked_list * list_fast_previous(linked_list const * list)
+{
+	return list->previous;
+}
+
+
+/**
+ * @brief - returns the value stored in the node
+ * 	Complexity: O(1)
+ *
+ * @param list - the node to get the value from, not NULL
+ *
+ * @return void * - the value stored in the node
+ */
+LIST_INLINE void * list_fast_content(linked_list const * list)
+{
+	return list->value;
+}
+
+
+/**
+ * @brief - walks the whole list from its head, the library is only called to
+ * 	find the head
+ * 	Complexity: O(n)
+ *
+ * @param node - the linked_list * variable set to every node in turn
+ * @param list - any node of the list, or its anchor
+ */
+#define list_for_each(node, list) \
+	for ((node) = list_head(list); (node) != NULL; (node) = (node)->next)
+
+
+/**
+ * @brief - walks the whole list from its tail, the library is only called to
+ * 	find the tail
+ * 	Complexity: O(n)
+ *
+ * @param node - the linked_list * variable set to every node in turn
+ * @param list - any node of the list, or its anchor
+ */
+#define list_for_each_reverse(node, list) \
+	for ((node) = list_tail(list); (node) != NULL; (node) = (node)->previous)
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
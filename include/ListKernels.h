@@ -0,0 +1,121 @@
+
+#ifndef LIST_KERNELS_HEADER
+#define LIST_KERNELS_HEADER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "List.h"
+
+
+
+
+/**
+ * Batch reducers for list_reduce_batch, for lists whose values point to
+ * numbers: each one reduces a batch of values into the accumulator, with AVX2
+ * gathers when the CPU supports them, SSE2 on x86-64 otherwise and plain C on
+ * other targets
+ * Accumulators have to be initialized by the caller: 0 for sums, the first
+ * value (or the greatest/lowest number of the type) for minimums/maximums
+ * NaN doubles aren't supported by minimums and maximums
+ */
+
+
+
+
+/**
+ * @brief - adds every int to the accumulator
+ * 	Complexity: O(count)
+ *
+ * @param accumulator - the sum, an int64_t *
+ * @param values - the values of the batch, int const *
+ * @param count - how many values are in the batch
+ */
+void list_sum_ints(
+	void * accumulator,
+	void const * const * values,
+	size_t count);
+
+
+/**
+ * @brief - adds every double to the accumulator, partial sums are added in a
+ * 	different order than a sequential sum would, so the last bits may differ
+ * 	Complexity: O(count)
+ *
+ * @param accumulator - the sum, a double *
+ * @param values - the values of the batch, double const *
+ * @param count - how many values are in the batch
+ */
+void list_sum_doubles(
+	void * accumulator,
+	void const * const * values,
+	size_t count);
+
+
+/**
+ * @brief - keeps the lowest int in the accumulator
+ * 	Complexity: O(count)
+ *
+ * @param accumulator - the minimum, an int *
+ * @param values - the values of the batch, int const *
+ * @param count - how many values are in the batch
+ */
+void list_min_ints(
+	void * accumulator,
+	void const * const * values,
+	size_t count);
+
+
+/**
+ * @brief - keeps the greatest int in the accumulator
+ * 	Complexity: O(count)
+ *
+ * @param accumulator - the maximum, an int *
+ * @param values - the values of the batch, int const *
+ * @param count - how many values are in the batch
+ */
+void list_max_ints(
+	void * accumulator,
+	void const * const * values,
+	size_t count);
+
+
+/**
+ * @brief - keeps the lowest double in the accumulator
+ * 	Complexity: O(count)
+ *
+ * @param accumulator - the minimum, a double *
+ * @param values - the values of the batch, double const *
+ * @param count - how many values are in the batch
+ */
+void list_min_doubles(
+	void * accumulator,
+	void const * const * values,
+	size_t count);
+
+
+/**
+ * @brief - keeps the greatest double in the accumulator
+ * 	Complexity: O(count)
+ *
+ * @param accumulator - the maximum, a double *
+ * @param values - the values of the batch, double const *
+ * @param count - how many values are in the batch
+ */
+void list_max_doubles(
+	void * accumulator,
+	void const * const * values,
+	size_t count);
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
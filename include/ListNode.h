@@ -0,0 +1,42 @@
+
+#ifndef LIST_NODE_HEADER
+#define LIST_NODE_HEADER
+
+#include "List.h"
+
+
+
+
+/**
+ * @brief - the layout of a node, exposed so nodes can be embedded in other
+ * 	structures, its fields are only meant to be changed by the list functions
+ */
+struct linked_list
+{
+	/**
+	 * @brief - the header shared by every node in the list, or one leading
+	 * 	to its header, found again by walking the list after nodes moved
+	 * 	between lists
+	 */
+	struct list_header * header;
+
+	/**
+	 * @brief - the value stored in the node
+	 */
+	void * value;
+
+	/**
+	 * @brief - the previous node, NULL if none
+	 */
+	linked_list * previous;
+
+	/**
+	 * @brief - the next node, NULL if none
+	 */
+	linked_list * next;
+};
+
+
+
+
+#endif
@@ -0,0 +1,208 @@
+
+#ifndef MAPPED_LIST_HEADER
+#define MAPPED_LIST_HEADER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * @brief - the offset returned when there is no node to point to
+ */
+#define MAPPED_LIST_NOWHERE ((uint64_t) 0)
+
+
+
+
+/**
+ * @brief - a doubly linked list living in a memory mapped file, usable as soon
+ * 	as the file is mapped: the header and the nodes are stored in the file,
+ * 	linked by their offsets from its start, and values of a fixed size are
+ * 	copied into their nodes
+ * 	The file grows as nodes are added, offsets are stable as long as their
+ * 	node stays in the list, but pointers to values may change when it grows
+ * 	Files are stored with the byte order of the host, and aren't meant to be
+ * 	shared between processes writing at the same time
+ */
+typedef struct mapped_list mapped_list;
+
+
+
+
+/**
+ * @brief - opens the list stored in the file, creating the file if it
+ * 	doesn't exist, and maps it: nothing is read until nodes are walked
+ * 	Complexity: O(1)
+ *
+ * @param path - the path of the file holding the list
+ * @param value_size - how many bytes each value takes, must match the one
+ * 	the file was created with
+ *
+ * @return mapped_list * - the opened list, NULL if the file can't be opened
+ * 	or mapped, or if it doesn't hold a list of such values
+ */
+mapped_list * mapped_list_open(char const * path, size_t value_size);
+
+
+/**
+ * @brief - unmaps the list and sets it to NULL, the file is kept and is
+ * 	written back by the system
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to close
+ */
+void mapped_list_close(mapped_list ** list);
+
+
+/**
+ * @brief - writes the changes made to the list back to its file, waiting for
+ * 	them to be stored
+ * 	Complexity: O(n) at worst, for modified pages
+ *
+ * @param list - the list to write back
+ *
+ * @return int - 1 if the changes were stored, 0 otherwise
+ */
+int mapped_list_sync(mapped_list * list);
+
+
+/**
+ * @brief - measures the size of the list
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to measure
+ *
+ * @return size_t - how many nodes are in the list
+ */
+size_t mapped_list_size(mapped_list const * list);
+
+
+/**
+ * @brief - adds a node at the end of the list, copying the value into it
+ * 	Complexity: O(1) amortized
+ *
+ * @param list - the list to append a node to
+ * @param value - the value to copy, value_size bytes, not read from the list
+ * 	itself since the file may be mapped elsewhere once grown
+ *
+ * @return uint64_t - the offset of the node, MAPPED_LIST_NOWHERE if the file
+ * 	couldn't grow
+ */
+uint64_t mapped_list_append(mapped_list * list, void const * value);
+
+
+/**
+ * @brief - adds a node at the beginning of the list, copying the value into
+ * 	it
+ * 	Complexity: O(1) amortized
+ *
+ * @param list - the list to prepend a node to
+ * @param value - the value to copy, value_size bytes, not read from the list
+ * 	itself since the file may be mapped elsewhere once grown
+ *
+ * @return uint64_t - the offset of the node, MAPPED_LIST_NOWHERE if the file
+ * 	couldn't grow
+ */
+uint64_t mapped_list_prepend(mapped_list * list, void const * value);
+
+
+/**
+ * @brief - removes the node at the given offset, the offset may be reused by
+ * 	next insertions
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to remove the node from
+ * @param offset - the offset of the node to remove
+ *
+ * @return uint64_t - the offset of the next node, MAPPED_LIST_NOWHERE if
+ * 	none
+ */
+uint64_t mapped_list_remove(mapped_list * list, uint64_t offset);
+
+
+/**
+ * @brief - returns the offset of the first node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to get the first node from
+ *
+ * @return uint64_t - the first offset, MAPPED_LIST_NOWHERE if empty
+ */
+uint64_t mapped_list_head(mapped_list const * list);
+
+
+/**
+ * @brief - returns the offset of the last node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to get the last node from
+ *
+ * @return uint64_t - the last offset, MAPPED_LIST_NOWHERE if empty
+ */
+uint64_t mapped_list_tail(mapped_list const * list);
+
+
+/**
+ * @brief - returns the offset of the next node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list the node belongs to
+ * @param offset - the offset to get the next one from
+ *
+ * @return uint64_t - the next offset, MAPPED_LIST_NOWHERE if none
+ */
+uint64_t mapped_list_next(mapped_list const * list, uint64_t offset);
+
+
+/**
+ * @brief - returns the offset of the previous node
+ * 	Complexity: O(1)
+ *
+ * @param list - the list the node belongs to
+ * @param offset - the offset to get the previous one from
+ *
+ * @return uint64_t - the previous offset, MAPPED_LIST_NOWHERE if none
+ */
+uint64_t mapped_list_previous(mapped_list const * list, uint64_t offset);
+
+
+/**
+ * @brief - returns the value stored at the given offset, in the mapped file
+ * 	Complexity: O(1)
+ *
+ * @param list - the list the node belongs to
+ * @param offset - the offset to get the value from
+ *
+ * @return void * - the value, valid until the list grows or is closed, NULL
+ * 	if the offset is out of the list
+ */
+void * mapped_list_content(mapped_list const * list, uint64_t offset);
+
+
+/**
+ * @brief - collects every value stored in the list, in order
+ * 	Complexity: O(n)
+ *
+ * @param list - the list to iterate
+ * @param accumulator - the initial value of the accumulator
+ * @param reducer - the callback to apply on every value
+ *
+ * @return - the accumulator
+ */
+void * mapped_list_reduce(
+	mapped_list const * list,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * value));
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
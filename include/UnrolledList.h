@@ -0,0 +1,183 @@
+
+#ifndef UNROLLED_LIST_HEADER
+#define UNROLLED_LIST_HEADER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+
+
+
+/**
+ * @brief - a doubly linked list storing several values per node, so scanning
+ * 	it walks through contiguous values instead of one node per value
+ */
+typedef struct unrolled_list unrolled_list;
+
+
+/**
+ * @brief - a node of an unrolled list, holding a few values
+ */
+typedef struct unrolled_node unrolled_node;
+
+
+/**
+ * @brief - the position of a value in an unrolled list
+ */
+typedef struct unrolled_cursor
+{
+	/**
+	 * @brief - the node holding the value, NULL if the cursor points nowhere
+	 */
+	unrolled_node * node;
+
+	/**
+	 * @brief - the index of the value in the node
+	 */
+	size_t index;
+} unrolled_cursor;
+
+
+
+
+/**
+ * @brief - creates an empty unrolled list and returns it
+ * 	Complexity: O(1)
+ *
+ * @return unrolled_list * - the created list, NULL if allocation failed
+ */
+unrolled_list * unrolled_list_create(void);
+
+
+/**
+ * @brief - deletes the list and sets it to NULL
+ * 	Complexity: O(n / values per node)
+ *
+ * @param list - the list to delete
+ */
+void unrolled_list_delete(unrolled_list ** list);
+
+
+/**
+ * @brief - measures the size of the list
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to measure
+ *
+ * @return size_t - how many values are stored in the list
+ */
+size_t unrolled_list_size(unrolled_list const * list);
+
+
+/**
+ * @brief - adds a value at the end of the list
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to append a value to
+ * @param value - the value to store in the list
+ */
+void unrolled_list_append(unrolled_list * list, void * value);
+
+
+/**
+ * @brief - adds a value at the beginning of the list
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to prepend a value to
+ * @param value - the value to store in the list
+ */
+void unrolled_list_prepend(unrolled_list * list, void * value);
+
+
+/**
+ * @brief - removes the value the cursor points to, and moves the cursor to
+ * 	the next value
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to remove the value from
+ * @param cursor - the position of the value to remove
+ */
+void unrolled_list_remove(unrolled_list * list, unrolled_cursor * cursor);
+
+
+/**
+ * @brief - returns the position of the first value of the list
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to get the first value from
+ *
+ * @return unrolled_cursor - the first position, pointing nowhere if empty
+ */
+unrolled_cursor unrolled_list_head(unrolled_list const * list);
+
+
+/**
+ * @brief - returns the position of the last value of the list
+ * 	Complexity: O(1)
+ *
+ * @param list - the list to get the last value from
+ *
+ * @return unrolled_cursor - the last position, pointing nowhere if empty
+ */
+unrolled_cursor unrolled_list_tail(unrolled_list const * list);
+
+
+/**
+ * @brief - returns the position of the next value
+ * 	Complexity: O(1)
+ *
+ * @param cursor - the position to get the next one from
+ *
+ * @return unrolled_cursor - the next position, pointing nowhere if none
+ */
+unrolled_cursor unrolled_list_next(unrolled_cursor cursor);
+
+
+/**
+ * @brief - returns the position of the previous value
+ * 	Complexity: O(1)
+ *
+ * @param cursor - the position to get the previous one from
+ *
+ * @return unrolled_cursor - the previous position, pointing nowhere if none
+ */
+unrolled_cursor unrolled_list_previous(unrolled_cursor cursor);
+
+
+/**
+ * @brief - returns the value at the given position
+ * 	Complexity: O(1)
+ *
+ * @param cursor - the position to get the value from
+ *
+ * @return void * - the value, NULL if the cursor points nowhere
+ */
+void * unrolled_list_content(unrolled_cursor cursor);
+
+
+/**
+ * @brief - collects every value stored in the list, in order
+ * 	Complexity: O(n)
+ *
+ * @param list - the list to iterate
+ * @param accumulator - the initial value of the accumulator
+ * @param reducer - the callback to apply on every value
+ *
+ * @return - the accumulator
+ */
+void * unrolled_list_reduce(
+	unrolled_list const * list,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * value));
+
+
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
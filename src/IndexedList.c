@@ -0,0 +1,421 @@
+
+#include <stdlib.h>
+
+#include "../include/IndexedList.h"
+
+
+/**
+ * @brief - marks unused slots, stored as previous position, also the maximum
+ * 	number of nodes a list can hold
+ */
+#define FREE_SLOT ((uint32_t) -2)
+
+
+/**
+ * @brief - how many slots are allocated on first insertion
+ */
+#define INITIAL_CAPACITY 16
+
+
+
+
+/**
+ * @brief - a node, stored in the array of its list
+ */
+typedef struct indexed_node
+{
+	/**
+	 * @brief - the value stored in the node
+	 */
+	void * value;
+
+	/**
+	 * @brief - the position of the previous node, INDEXED_LIST_NOWHERE if
+	 * 	none, FREE_SLOT if the slot is unused
+	 */
+	uint32_t previous;
+
+	/**
+	 * @brief - the position of the next node, INDEXED_LIST_NOWHERE if none,
+	 * 	the next unused slot if the slot is unused
+	 */
+	uint32_t next;
+} indexed_node;
+
+
+struct indexed_list
+{
+	/**
+	 * @brief - every slot of the list, used or not
+	 */
+	indexed_node * nodes;
+
+	/**
+	 * @brief - how many slots are allocated
+	 */
+	uint32_t capacity;
+
+	/**
+	 * @brief - how many slots were handed out at least once, from the start
+	 */
+	uint32_t used;
+
+	/**
+	 * @brief - how many nodes are in the list
+	 */
+	uint32_t size;
+
+	/**
+	 * @brief - the position of the first node, INDEXED_LIST_NOWHERE if none
+	 */
+	uint32_t first;
+
+	/**
+	 * @brief - the position of the last node, INDEXED_LIST_NOWHERE if none
+	 */
+	uint32_t last;
+
+	/**
+	 * @brief - the first removed slot, INDEXED_LIST_NOWHERE if none
+	 */
+	uint32_t free_slots;
+
+	/**
+	 * @brief - 1 if every node is stored at its rank in the list, so the list
+	 * 	can be swept as an array, 0 otherwise
+	 */
+	int in_order;
+};
+
+
+
+
+/**
+ * @brief - checks if the position points to a node of the list
+ *
+ * @param list - the list to check the position in
+ * @param position - the position to check
+ *
+ * @return int - 1 if a node lives at this position, 0 otherwise
+ */
+static int is_valid_position(indexed_list const * list, uint32_t position)
+{
+	return position < list->used && list->nodes[position].previous != FREE_SLOT;
+}
+
+
+/**
+ * @brief - allocates more slots, doubling the capacity
+ *
+ * @param list - the list to grow
+ *
+ * @return int - 1 if the list has grown, 0 if allocation failed or if the list
+ * 	can't hold more nodes
+ */
+static int grow(indexed_list * list)
+{
+	indexed_node * nodes;
+	uint32_t capacity;
+	size_t bytes;
+
+	if (list->capacity == FREE_SLOT)
+		return 0;
+
+	if (list->capacity == 0)
+		capacity = INITIAL_CAPACITY;
+	else if (list->capacity > FREE_SLOT / 2)
+		capacity = FREE_SLOT;
+	else
+		capacity = list->capacity * 2;
+
+	bytes = (size_t) capacity * sizeof(indexed_node);
+	if (bytes / sizeof(indexed_node) != capacity) /* overflow on 32 bits */
+		return 0;
+
+	nodes = realloc(list->nodes, bytes);
+	if (nodes == NULL)
+		return 0;
+
+	list->nodes = nodes;
+	list->capacity = capacity;
+
+	return 1;
+}
+
+
+/**
+ * @brief - takes an unused slot, reusing a removed one if any
+ *
+ * @param list - the list to take the slot from
+ *
+ * @return uint32_t - the position of the slot, INDEXED_LIST_NOWHERE if none
+ * 	is available
+ */
+static uint32_t take_slot(indexed_list * list)
+{
+	uint32_t position = list->free_slots;
+
+	if (position != INDEXED_LIST_NOWHERE)
+	{
+		list->free_slots = list->nodes[position].next;
+		return position;
+	}
+
+	if (list->used == list->capacity && ! grow(list))
+		return INDEXED_LIST_NOWHERE;
+
+	return list->used++;
+}
+
+
+/**
+ * @brief - gives the slot back, so it's reused by next insertions
+ *
+ * @param list - the list the slot belongs to
+ * @param position - the position of the slot
+ */
+static void release_slot(indexed_list * list, uint32_t position)
+{
+	list->nodes[position].value = NULL;
+	list->nodes[position].previous = FREE_SLOT;
+	list->nodes[position].next = list->free_slots;
+	list->free_slots = position;
+}
+
+
+/**
+ * @brief - link 2 nodes
+ *
+ * @param list - the list the nodes belong to
+ * @param before - the position of the previous node
+ * @param after - the position of the next node
+ */
+static void link_nodes(indexed_list * list, uint32_t before, uint32_t after)
+{
+	if (before != INDEXED_LIST_NOWHERE)
+		list->nodes[before].next = after;
+	else
+		list->first = after;
+
+	if (after != INDEXED_LIST_NOWHERE)
+		list->nodes[after].previous = before;
+	else
+		list->last = before;
+}
+
+
+
+
+indexed_list * indexed_list_create(void)
+{
+	indexed_list * list = calloc(1, sizeof(indexed_list));
+	if (list == NULL)
+		return NULL;
+
+	list->first = INDEXED_LIST_NOWHERE;
+	list->last = INDEXED_LIST_NOWHERE;
+	list->free_slots = INDEXED_LIST_NOWHERE;
+	list->in_order = 1;
+
+	return list;
+}
+
+
+void indexed_list_delete(indexed_list ** list)
+{
+	if (list == NULL || * list == NULL)
+		return;
+
+	free((* list)->nodes);
+
+	free(* list);
+	* list = NULL;
+}
+
+
+size_t indexed_list_size(indexed_list const * list)
+{
+	if (list == NULL)
+		return 0;
+
+	return list->size;
+}
+
+
+uint32_t indexed_list_append(indexed_list * list, void * value)
+{
+	uint32_t position;
+
+	if (list == NULL)
+		return INDEXED_LIST_NOWHERE;
+
+	position = take_slot(list);
+	if (position == INDEXED_LIST_NOWHERE)
+		return INDEXED_LIST_NOWHERE;
+
+	list->nodes[position].value = value;
+	link_nodes(list, list->last, position);
+	link_nodes(list, position, INDEXED_LIST_NOWHERE);
+
+	list->in_order = list->in_order && position == list->size;
+	list->size++;
+
+	return position;
+}
+
+
+uint32_t indexed_list_prepend(indexed_list * list, void * value)
+{
+	uint32_t position;
+
+	if (list == NULL)
+		return INDEXED_LIST_NOWHERE;
+
+	position = take_slot(list);
+	if (position == INDEXED_LIST_NOWHERE)
+		return INDEXED_LIST_NOWHERE;
+
+	list->nodes[position].value = value;
+	link_nodes(list, position, list->first);
+	link_nodes(list, INDEXED_LIST_NOWHERE, position);
+
+	list->in_order = list->in_order && list->size == 0 && position == 0;
+	list->size++;
+
+	return position;
+}
+
+
+uint32_t indexed_list_remove(indexed_list * list, uint32_t position)
+{
+	uint32_t next;
+
+	if (list == NULL || ! is_valid_position(list, position))
+		return INDEXED_LIST_NOWHERE;
+
+	next = list->nodes[position].next;
+	link_nodes(list, list->nodes[position].previous, next);
+
+	/* the removed tail slot is the next one appended, order is kept */
+	list->in_order = list->in_order && next == INDEXED_LIST_NOWHERE;
+	list->size--;
+
+	release_slot(list, position);
+
+	return next;
+}
+
+
+uint32_t indexed_list_head(indexed_list const * list)
+{
+	if (list == NULL)
+		return INDEXED_LIST_NOWHERE;
+
+	return list->first;
+}
+
+
+uint32_t indexed_list_tail(indexed_list const * list)
+{
+	if (list == NULL)
+		return INDEXED_LIST_NOWHERE;
+
+	return list->last;
+}
+
+
+uint32_t indexed_list_next(indexed_list const * list, uint32_t position)
+{
+	if (list == NULL || ! is_valid_position(list, position))
+		return INDEXED_LIST_NOWHERE;
+
+	return list->nodes[position].next;
+}
+
+
+uint32_t indexed_list_previous(indexed_list const * list, uint32_t position)
+{
+	if (list == NULL || ! is_valid_position(list, position))
+		return INDEXED_LIST_NOWHERE;
+
+	return list->nodes[position].previous;
+}
+
+
+void * indexed_list_content(indexed_list const * list, uint32_t position)
+{
+	if (list == NULL || ! is_valid_position(list, position))
+		return NULL;
+
+	return list->nodes[position].value;
+}
+
+
+void * indexed_list_reduce(
+	indexed_list const * list,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * value))
+{
+	uint32_t position;
+
+	if (list == NULL)
+		return accumulator;
+
+	if (list->in_order)
+	{
+		for (position = 0; position < list->size; position++)
+			reducer(accumulator, list->nodes[position].value);
+		return accumulator;
+	}
+
+	for (position = list->first;
+		position != INDEXED_LIST_NOWHERE;
+		position = list->nodes[position].next)
+		reducer(accumulator, list->nodes[position].value);
+
+	return accumulator;
+}
+
+
+int indexed_list_compact(indexed_list * list)
+{
+	indexed_node * nodes = NULL;
+	uint32_t old_position;
+	uint32_t position;
+
+	if (list == NULL)
+		return 0;
+
+	if (list->size > 0)
+	{
+		nodes = malloc(list->size * sizeof(indexed_node));
+		if (nodes == NULL)
+			return 0;
+	}
+
+	old_position = list->first;
+	for (position = 0; position < list->size; position++)
+	{
+		nodes[position].value = list->nodes[old_position].value;
+		nodes[position].previous = position - 1;
+		nodes[position].next = position + 1;
+		old_position = list->nodes[old_position].next;
+	}
+
+	if (list->size > 0)
+	{
+		nodes[0].previous = INDEXED_LIST_NOWHERE;
+		nodes[list->size - 1].next = INDEXED_LIST_NOWHERE;
+	}
+
+	free(list->nodes);
+	list->nodes = nodes;
+	list->capacity = list->size;
+	list->used = list->size;
+	list->free_slots = INDEXED_LIST_NOWHERE;
+	list->first = (list->size > 0) ? 0 : INDEXED_LIST_NOWHERE;
+	list->last = (list->size > 0) ? list->size - 1 : INDEXED_LIST_NOWHERE;
+	list->in_order = 1;
+
+	return 1;
+}
@@ -1,441 +1,2465 @@
 
+#define _POSIX_C_SOURCE 200112L /* pthread_rwlock_t */
+
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "../include/IntrusiveList.h"
 #include "../include/List.h"
+#include "../include/ListNode.h"
+#include "ListPrivate.h"
+
+
+/**
+ * @brief - how many nodes a chunk holds when a pooled list doesn't specify it
+ */
+#define LIST_DEFAULT_NODES_PER_CHUNK 1024
+
+
+/**
+ * @brief - how many nodes ahead walks copying the list prefetch
+ */
+#define LIST_COPY_PREFETCH_DISTANCE 8
 
 
+/**
+ * @brief - set in the header link of nodes carved out of a chunk, headers
+ * 	being aligned, so a node knows how to be released in any list it moves to
+ */
+#define LIST_CHUNK_NODE ((size_t) 1)
 
 
 /**
- * @brief - data shared by every node of a same list
+ * @brief - a block of nodes allocated at once, nodes are stored right after it
  */
-typedef struct list_header
+typedef struct node_chunk
 {
 	/**
-	 * @brief - the first node of the list
+	 * @brief - the previously allocated chunk, NULL if none
 	 */
-	linked_list * first_node;
+	struct node_chunk * next;
 
 	/**
-	 * @brief - the last node of the list
+	 * @brief - how many nodes are stored after the chunk
 	 */
-	linked_list * last_node;
+	size_t capacity;
+} node_chunk;
+
 
+/**
+ * @brief - chunks allocated by a list, shared with the lists its nodes moved
+ * 	to, and released once none of them leads to it anymore
+ */
+typedef struct chunk_store
+{
 	/**
-	 * @brief - the whole size of the list, from first to last node
+	 * @brief - every chunk allocated so far, most recent first
 	 */
-	size_t size;
-} header;
+	node_chunk * chunks;
 
+	/**
+	 * @brief - how many lists lead to the store
+	 */
+	size_t references;
+} chunk_store;
 
-struct linked_list
+
+/**
+ * @brief - a store some nodes of a list were carved out of
+ */
+typedef struct store_reference
 {
 	/**
-	 * @brief - the header shared by every node in the list
+	 * @brief - the referenced store
 	 */
-	header * header;
+	chunk_store * store;
+
+	/**
+	 * @brief - the next store of the same list, NULL if none
+	 */
+	struct store_reference * next;
+} store_reference;
+
 
+/**
+ * @brief - nodes storage of a list, from which pooled lists take every node
+ * 	and other lists the nodes they create in batches
+ */
+typedef struct node_pool
+{
 	/**
-	 * @brief - the value stored in the node
+	 * @brief - the store new chunks go to, NULL until the first one
 	 */
-	void * value;
+	chunk_store * store;
 
 	/**
-	 * @brief - the previous node, NULL if none
+	 * @brief - the removed nodes, ready to be reused, chained by their next
 	 */
-	linked_list * previous;
+	linked_list * free_nodes;
 
 	/**
-	 * @brief - the next node, NULL if none
+	 * @brief - the first never used node of the most recent chunk
 	 */
-	linked_list * next;
-};
+	linked_list * unused_nodes;
 
+	/**
+	 * @brief - how many never used nodes are left in the most recent chunk
+	 */
+	size_t unused_count;
 
+	/**
+	 * @brief - how many nodes a new chunk holds, 0 if the list isn't pooled
+	 */
+	size_t chunk_capacity;
+} node_pool;
 
 
 /**
- * @brief - creates a blank header
- *
- * @return header * - the created header
+ * @brief - lists which moved nodes between them, nodes of each one may still
+ * 	be bound to headers of the others, so the headers of the family are kept
+ * 	until its last list is deleted
  */
-static header * create_blank_header(void)
+typedef struct list_family
 {
-	return calloc(1, sizeof(header));
-}
+	/**
+	 * @brief - how many lists of the family are not deleted yet
+	 */
+	size_t lists;
+
+	/**
+	 * @brief - the headers of deleted lists and the ones binding nodes for
+	 * 	lists, chained by their next absorbed header
+	 */
+	header * headers;
+
+	/**
+	 * @brief - the family this one was merged into, NULL if none
+	 */
+	struct list_family * merged;
+
+	/**
+	 * @brief - the families merged into this one, chained by their next
+	 * 	joined family
+	 */
+	struct list_family * joined;
+
+	/**
+	 * @brief - the next family merged into the same one
+	 */
+	struct list_family * next_joined;
+
+	/**
+	 * @brief - the memory functions the family comes from
+	 */
+	list_allocator allocator;
+} list_family;
+
+
+/**
+ * @brief - the clock ordering moves of nodes between lists, each tick is
+ * 	taken once
+ */
+static size_t moves_clock = 0;
+
+
 
 
 /**
- * @brief - creates a node without bound header
+ * @brief - default allocation function, backed by malloc
  *
- * @param value - the value to store in the node
+ * @param size - the size of the memory to allocate
+ * @param context - unused
  *
- * @return linked_list * - the created node
+ * @return void * - the allocated memory, NULL if allocation failed
  */
-static linked_list * create_headerless_node(void * value)
+static void * default_allocate(size_t size, void * context)
 {
-	linked_list * list = calloc(1, sizeof(linked_list));
-	if (list != NULL)
-		list->value = value;
+	(void) context;
 
-	return list;
+	return malloc(size);
 }
 
 
 /**
- * @brief - deletes the header and sets it to NULL
+ * @brief - default release function, backed by free
  *
- * @param header - the header to delete
+ * @param memory - the memory to release
+ * @param context - unused
  */
-static void delete_header(header ** header)
+static void default_release(void * memory, void * context)
 {
-	free(* header);
-	* header = NULL;
+	(void) context;
+
+	free(memory);
 }
 
 
-/**
- * @brief - updates the header, setting last node and incrementing size
- *
- * @param node_to_append - the node that will be appended
- */
-static void update_header_append(linked_list * node_to_append)
+list_allocator const list_default_allocator = {
+	default_allocate,
+	default_release,
+	NULL
+};
+
+
+void * list_allocate(list_allocator const * allocator, size_t size)
 {
-	header * header = node_to_append->header;
+	return allocator->allocate(size, allocator->context);
+}
 
-	if (header->first_node == NULL)
-		header->first_node = node_to_append;
 
-	header->last_node = node_to_append;
-	header->size++;
+void list_release(list_allocator const * allocator, void * memory)
+{
+	if (allocator->release != NULL && memory != NULL)
+		allocator->release(memory, allocator->context);
 }
 
 
-/**
- * @brief - updates the header, setting first node and incrementing size
- *
- * @param node_to_append - the node that will be prepended
- */
-static void update_header_prepend(linked_list * node_to_prepend)
+header * list_create_blank_header(list_allocator const * allocator)
 {
-	header * header = node_to_prepend->header;
+	header * header = list_allocate(allocator, sizeof(* header));
+	if (header == NULL)
+		return NULL;
 
-	if (header->last_node == NULL)
-		header->last_node = node_to_prepend;
+	memset(header, 0, sizeof(* header));
+	header->allocator = * allocator;
 
-	header->first_node = node_to_prepend;
-	header->size++;
+	return header;
 }
 
 
-/**
- * @brief - updates the header, setting first/last nodes and decrementing size
- *
- * @param node_to_remove - the node that will be removed
- */
-static void update_header_removal(linked_list * node_to_remove)
+header * list_create_anchored_header(list_allocator const * allocator)
 {
-	header * header = node_to_remove->header;
-
-	if (node_to_remove == header->first_node && node_to_remove->next != NULL)
-		header->first_node = node_to_remove->next;
-	if (node_to_remove == header->last_node && node_to_remove->previous != NULL)
-		header->last_node = node_to_remove->previous;
+	header * header = list_create_blank_header(allocator);
+	if (header != NULL)
+		header->anchor.header = header;
 
-	header->size--;
+	return header;
 }
 
 
 /**
- * @brief - creates a node to be bound with the given header and returns it,
- * 	the header to be bound will be updated
+ * @brief - gives the pool of the list, created along the first nodes the list
+ * 	takes from a chunk
  *
- * @param value - the value to store in the node
- * @param header - the header to bind and update
+ * @param header - the header of the list
  *
- * @return linked_list * - the created node
+ * @return node_pool * - the pool of the list, NULL if allocation failed
  */
-static linked_list * create_node_and_update_header_append(
-	void * value,
-	header * header)
+static node_pool * pool_of(header * header)
 {
-	linked_list * node = create_headerless_node(value);
-	if (node == NULL)
-		return NULL;
-
-	node->header = header;
-
-	update_header_append(node);
+	if (header->pool == NULL)
+	{
+		header->pool = list_allocate(& header->allocator, sizeof(node_pool));
+		if (header->pool != NULL)
+			memset(header->pool, 0, sizeof(node_pool));
+	}
 
-	return node;
+	return header->pool;
 }
 
 
 /**
- * @brief - creates a node to be bound with the given header and returns it,
- * 	the header to be bound will be updated
+ * @brief - creates a blank header whose nodes will be taken from a pool
  *
- * @param value - the value to store in the node
- * @param header - the header to bind and update
+ * @param nodes_per_chunk - how many nodes a chunk holds, 0 for the default
  *
- * @return linked_list * - the created node
+ * @return header * - the created header, NULL if allocation failed
  */
-static linked_list * create_node_and_update_header_prepend(
-	void * value,
-	header * header)
+static header * create_pooled_header(size_t nodes_per_chunk)
 {
-	linked_list * node = create_headerless_node(value);
-	if (node == NULL)
+	header * header = list_create_anchored_header(& list_default_allocator);
+	if (header == NULL)
 		return NULL;
 
-	node->header = header;
+	if (pool_of(header) == NULL)
+	{
+		list_delete_header(& header);
+		return NULL;
+	}
 
-	update_header_prepend(node);
+	if (nodes_per_chunk == 0)
+		nodes_per_chunk = LIST_DEFAULT_NODES_PER_CHUNK;
+	header->pool->chunk_capacity = nodes_per_chunk;
 
-	return node;
+	return header;
 }
 
 
 /**
- * @brief - deletes the current node and every previous ones,
- * 	doesn't check for NULL argument
+ * @brief - gives the header the node is bound to, which may have been
+ * 	concatenated to another one since
  *
- * @param list - the list to delete, from the beginning to given node
+ * @param node - the node to read the header of
+ *
+ * @return header * - the header the node is bound to
  */
-static void list_delete_backward(linked_list ** list)
+static header * bound_header(linked_list const * node)
 {
-	if (* list == NULL)
-		return;
-
-	list_delete_backward(& (* list)->previous);
-
-	free(* list);
-	* list = NULL;
+	return (header *) ((size_t) node->header & ~LIST_CHUNK_NODE);
 }
 
 
 /**
- * @brief - deletes the current node and every next ones,
- * 	doesn't check for NULL argument
+ * @brief - checks if the node was carved out of a chunk, rather than
+ * 	allocated alone or embedded by the user
  *
- * @param list - the list to delete, from given node to the end
+ * @param node - the node to check
+ *
+ * @return int - 1 if the node lives in a chunk, 0 otherwise
  */
-static void list_delete_forward(linked_list ** list)
+static int is_chunk_node(linked_list const * node)
 {
-	if (* list == NULL)
-		return;
-
-	list_delete_forward(& (* list)->next);
-
-	free(* list);
-	* list = NULL;
+	return ((size_t) node->header & LIST_CHUNK_NODE) != 0;
 }
 
 
 /**
- * @brief - link 2 nodes
+ * @brief - gives the next tick of the clock ordering moves between lists
  *
- * @param before - the previous node
- * @param after - the next node
+ * @return size_t - the tick, never 0
  */
-static void link_nodes(linked_list * before, linked_list * after)
-{
-	if (before != NULL)
-		before->next = after;
-	if (after != NULL)
-		after->previous = before;
-}
-
-
-
-
-linked_list * list_create(void)
+static size_t tick(void)
 {
-	return NULL;
+	return __atomic_add_fetch(& moves_clock, 1, __ATOMIC_RELAXED);
 }
 
 
-void list_delete(linked_list ** list)
+/**
+ * @brief - gives the header new nodes of the list are bound to
+ *
+ * @param header - the header of the list
+ *
+ * @return header * - the binding header, the list header itself if it never
+ * 	gave nodes away
+ */
+static header * binding_of(header * header)
 {
-	if (list == NULL)
-		return;
-
-	if (* list == NULL)
-		return;
-
-	list_delete_backward(& (* list)->previous);
-	list_delete_forward(& (* list)->next);
-
-	free((* list)->header);
-	(* list)->header = NULL;
-
-	free(* list);
-	* list = NULL;
+	return (header->binding != NULL) ? header->binding : header;
 }
 
 
-size_t list_size(linked_list const * list)
+void list_bind_node(linked_list * node, header * header, int is_chunk)
 {
-	if (list == NULL)
-		return 0;
+	size_t tag = is_chunk ? LIST_CHUNK_NODE : 0;
 
-	return list->header->size;
+	node->header = (struct list_header *) ((size_t) binding_of(header) | tag);
 }
 
 
-size_t list_size_forward(linked_list const * list)
+/**
+ * @brief - checks if nodes bound to a header still belong to the list it
+ * 	leads to: neither the header nor the ones it leads to gave nodes away
+ * 	since they were joined
+ *
+ * @param bound - the header nodes are bound to
+ *
+ * @return int - 1 if the header can be trusted, 0 otherwise
+ */
+static int is_trusted(header const * bound)
 {
-	size_t size = 1;
-	if (list == NULL)
+	if (bound->scattered_at != 0)
 		return 0;
 
-	while ((list = list->next) != NULL)
-		size++;
+	for (; bound->forward != NULL; bound = bound->forward)
+	{
+		if (bound->forward->scattered_at >= bound->joined_at)
+			return 0;
+	}
 
-	return size;
+	return 1;
 }
 
 
-size_t list_size_backward(linked_list const * list)
+/**
+ * @brief - follows the headers leading from a header to the last one
+ *
+ * @param header - the header to start from
+ *
+ * @return header * - the header leading nowhere
+ */
+static header * root_of(header * header)
 {
-	size_t size = 1;
-	if (list == NULL)
-		return 0;
+	while (header->forward != NULL)
+		header = header->forward;
 
-	while ((list = list->previous) != NULL)
-		size++;
-
-	return size;
+	return header;
 }
 
 
-void list_append(linked_list ** list, void * value)
+/**
+ * @brief - makes trusted headers lead straight to their root, so later
+ * 	lookups are immediate, they stay trusted until the root gives nodes away
+ *
+ * @param bound - the header to start from, trusted
+ * @param root - the header it leads to
+ */
+static void lead_to_root(header * bound, header * root)
 {
-	linked_list * old_tail;
-	linked_list * new_tail;
-	header * header;
+	header * next;
+	size_t now;
 
-	if (list == NULL)
+	if (bound->forward == root)
 		return;
 
-	if (* list == NULL)
+	now = tick();
+	for (; bound != root; bound = next)
 	{
-		* list = create_node_and_update_header_append(
-			value,
-			create_blank_header());
-		return;
+		next = bound->forward;
+		bound->forward = root;
+		bound->joined_at = now;
 	}
-
-	header = (* list)->header;
-
-	old_tail = header->last_node;
-	new_tail = create_node_and_update_header_append(value, header);
-	link_nodes(old_tail, new_tail);
 }
 
 
-void list_prepend(linked_list ** list, void * value)
+/**
+ * @brief - finds the list of a node whose header can't be trusted, walking
+ * 	both ways to the closest node whose header can, then binds the walked
+ * 	nodes to that list
+ *
+ * @param node - the node to find the list of
+ *
+ * @return header * - the header of the list
+ */
+static header * resolve_by_walking(linked_list * node)
 {
-	linked_list * old_head;
-	linked_list * new_head;
-	header * header;
+	linked_list * front = node;
+	linked_list * back = node;
+	linked_list * known = NULL;
+	linked_list * walked;
+	header * root;
+
+	/* the ends of a list are always bound to it, so one of the walks stops */
+	while (known == NULL && (front != NULL || back != NULL))
+	{
+		if (front != NULL)
+			front = front->previous;
+		if (front != NULL && is_trusted(bound_header(front)))
+			known = front;
+		else if (back != NULL)
+			back = back->next;
+		if (known == NULL && back != NULL && is_trusted(bound_header(back)))
+			known = back;
+	}
 
-	if (list == NULL)
-		return;
+	if (known == NULL)
+		return root_of(bound_header(node));
 
-	if (* list == NULL)
+	root = list_header_of(known);
+	for (walked = node; walked != front; walked = walked->previous)
+		list_bind_node(walked, root, is_chunk_node(walked));
+	for (walked = node; walked != back; walked = walked->next)
 	{
-		* list = create_node_and_update_header_prepend(
-			value,
-			create_blank_header());
-		return;
+		if (walked != node)
+			list_bind_node(walked, root, is_chunk_node(walked));
 	}
 
-	header = (* list)->header;
-
-	old_head = header->first_node;
-	new_head = create_node_and_update_header_prepend(value, header);
-	link_nodes(old_head, new_head);
+	return root;
 }
 
 
-void list_remove_node(linked_list ** list)
+header * list_header_of(linked_list const * node)
 {
-	linked_list * node_to_remove;
-	header * header;
+	header * bound = bound_header(node);
+	header * root;
 
-	if (list == NULL)
-		return;
+	if (bound->forward == NULL && bound->scattered_at == 0)
+		return bound;
 
-	node_to_remove = * list;
-	header = (* list)->header;
+	if (list_is_anchor(node)) /* anchors never leave their header */
+		return root_of(bound);
 
-	link_nodes(node_to_remove->previous, node_to_remove->next);
-	update_header_removal(node_to_remove);
+	if (! is_trusted(bound))
+		return resolve_by_walking((linked_list *) node);
 
-	if (header->size == 0) /* last node removed = orphan header */
-		delete_header(& header);
+	root = root_of(bound);
+	lead_to_root(bound, root);
+	if (bound != binding_of(root))
+		list_bind_node((linked_list *) node, root, is_chunk_node(node));
 
-	* list = node_to_remove->next;
-	free(node_to_remove);
+	return root;
 }
 
 
-linked_list * list_next(linked_list const * list)
+int list_is_anchor(linked_list const * list)
 {
-	if (list == NULL)
-		return NULL;
-
-	return list->next;
+	return list == & bound_header(list)->anchor;
 }
 
 
-linked_list * list_previous(linked_list const * list)
+/**
+ * @brief - checks if the list was created with a configuration, an allocator,
+ * 	a pool or sharing, which its header keeps while the list is empty
+ *
+ * @param header - the header of the list to check
+ *
+ * @return int - 1 if the list has an anchor, 0 otherwise
+ */
+static int is_configured(header const * header)
 {
-	if (list == NULL)
-		return NULL;
-
-	return list->previous;
+	return header->anchor.header == header;
 }
 
 
-linked_list * list_head(linked_list const * list)
+/**
+ * @brief - checks if the nodes of the list are taken from a pool
+ *
+ * @param header - the header of the list to check
+ *
+ * @return int - 1 if the list is pooled, 0 otherwise
+ */
+static int is_pooled(header const * header)
 {
-	if (list == NULL)
-		return NULL;
-
-	return list->header->first_node;
+	return header->pool != NULL && header->pool->chunk_capacity != 0;
 }
 
 
-linked_list * list_tail(linked_list const * list)
+/**
+ * @brief - makes the list lead to the store, unless it already does
+ *
+ * @param header - the header of the list
+ * @param store - the store to reference
+ *
+ * @return int - 1 if the list leads to the store, 0 if allocation failed
+ */
+static int reference_store(header * header, chunk_store * store)
 {
-	if (list == NULL)
-		return NULL;
+	store_reference * reference;
 
-	return list->header->last_node;
-}
+	for (reference = header->stores; reference != NULL; reference = reference->next)
+	{
+		if (reference->store == store)
+			return 1;
+	}
 
+	reference = list_allocate(& header->allocator, sizeof(* reference));
+	if (reference == NULL)
+		return 0;
 
-void * list_content(linked_list const * list)
+	__atomic_add_fetch(& store->references, 1, __ATOMIC_RELAXED);
+	reference->store = store;
+	reference->next = header->stores;
+	header->stores = reference;
+
+	return 1;
+}
+
+
+/**
+ * @brief - makes the list lead to every store the other one leads to, before
+ * 	nodes of the other list are moved to it
+ *
+ * @param header - the header of the list taking the nodes
+ * @param other - the header of the list giving them
+ *
+ * @return int - 1 if the list leads to every store, 0 if allocation failed
+ */
+static int share_stores(header * header, struct list_header const * other)
+{
+	store_reference const * reference;
+
+	for (reference = other->stores; reference != NULL; reference = reference->next)
+	{
+		if (! reference_store(header, reference->store))
+			return 0;
+	}
+
+	return 1;
+}
+
+
+/**
+ * @brief - hands the references of the other list to its stores over to the
+ * 	list, when it takes every node of the other one
+ *
+ * @param header - the header of the list taking the nodes
+ * @param other - the header of the list giving them, left without stores
+ */
+static void take_stores(header * header, struct list_header * other)
+{
+	store_reference * last = other->stores;
+
+	if (last == NULL)
+		return;
+
+	while (last->next != NULL)
+		last = last->next;
+
+	last->next = header->stores;
+	header->stores = other->stores;
+	other->stores = NULL;
+}
+
+
+/**
+ * @brief - drops the references of the list to its stores, releasing every
+ * 	chunk of the stores no list leads to anymore, and so the nodes taken
+ * 	from them
+ *
+ * @param header - the header of the list
+ */
+static void release_stores(header * header)
+{
+	store_reference * reference;
+	chunk_store * store;
+	node_chunk * chunk;
+
+	while ((reference = header->stores) != NULL)
+	{
+		header->stores = reference->next;
+		store = reference->store;
+		list_release(& header->allocator, reference);
+
+		if (__atomic_sub_fetch(& store->references, 1, __ATOMIC_ACQ_REL) > 0)
+			continue;
+
+		while ((chunk = store->chunks) != NULL)
+		{
+			store->chunks = chunk->next;
+			list_release(& header->allocator, chunk);
+		}
+		list_release(& header->allocator, store);
+	}
+
+	if (header->pool == NULL)
+		return;
+
+	header->pool->store = NULL;
+	header->pool->free_nodes = NULL;
+	header->pool->unused_nodes = NULL;
+	header->pool->unused_count = 0;
+}
+
+
+/**
+ * @brief - allocates a new chunk and makes it the one nodes are taken from,
+ * 	the store of the list is created along its first chunk
+ *
+ * @param header - the header of the list whose pool grows
+ * @param capacity - how many nodes the chunk holds
+ *
+ * @return int - 1 if the pool has grown, 0 if allocation failed
+ */
+static int grow_pool(header * header, size_t capacity)
+{
+	node_pool * pool = header->pool;
+	node_chunk * chunk;
+
+	if (pool->store == NULL)
+	{
+		pool->store = list_allocate(& header->allocator, sizeof(chunk_store));
+		if (pool->store == NULL)
+			return 0;
+
+		pool->store->chunks = NULL;
+		pool->store->references = 0;
+		if (! reference_store(header, pool->store))
+		{
+			list_release(& header->allocator, pool->store);
+			pool->store = NULL;
+			return 0;
+		}
+	}
+
+	chunk = list_allocate(
+		& header->allocator,
+		sizeof(node_chunk) + capacity * sizeof(linked_list));
+	if (chunk == NULL)
+		return 0;
+
+	chunk->capacity = capacity;
+	chunk->next = pool->store->chunks;
+	pool->store->chunks = chunk;
+
+	pool->unused_nodes = (linked_list *) (chunk + 1);
+	pool->unused_count = chunk->capacity;
+
+	return 1;
+}
+
+
+/**
+ * @brief - takes a node from the pool, reusing a removed one if any
+ *
+ * @param header - the header of the list to take the node from
+ *
+ * @return linked_list * - the uninitialized node, NULL if allocation failed
+ */
+static linked_list * take_pooled_node(header * header)
+{
+	node_pool * pool = header->pool;
+	linked_list * node = pool->free_nodes;
+
+	if (node != NULL)
+	{
+		pool->free_nodes = node->next;
+		return node;
+	}
+
+	if (pool->unused_count == 0 && ! grow_pool(header, pool->chunk_capacity))
+		return NULL;
+
+	pool->unused_count--;
+	return pool->unused_nodes++;
+}
+
+
+/**
+ * @brief - moves the never used nodes of the most recent chunk to the free
+ * 	nodes, so they aren't lost when a new chunk is allocated
+ *
+ * @param pool - the pool whose most recent chunk is left
+ */
+static void recycle_unused_nodes(node_pool * pool)
+{
+	while (pool->unused_count > 0)
+	{
+		pool->unused_count--;
+		pool->unused_nodes->next = pool->free_nodes;
+		pool->free_nodes = pool->unused_nodes++;
+	}
+}
+
+
+/**
+ * @brief - takes contiguous nodes from the pool, free nodes are skipped since
+ * 	they are scattered
+ *
+ * @param header - the header of the list to take the nodes from
+ * @param count - how many nodes to take
+ *
+ * @return linked_list * - the uninitialized nodes, NULL if allocation failed
+ */
+static linked_list * take_pooled_nodes(header * header, size_t count)
+{
+	node_pool * pool = pool_of(header);
+	linked_list * nodes;
+
+	if (pool == NULL)
+		return NULL;
+
+	if (pool->unused_count < count)
+	{
+		recycle_unused_nodes(pool);
+		if (! grow_pool(
+			header,
+			count > pool->chunk_capacity ? count : pool->chunk_capacity))
+			return NULL;
+	}
+
+	nodes = pool->unused_nodes;
+	pool->unused_nodes += count;
+	pool->unused_count -= count;
+
+	return nodes;
+}
+
+
+linked_list * list_create_node(void * value, header * header)
+{
+	int is_chunk = header->pool != NULL
+		&& (header->pool->chunk_capacity != 0 || header->pool->free_nodes != NULL);
+	linked_list * node;
+
+	if (is_chunk)
+		node = take_pooled_node(header);
+	else
+		node = list_allocate(& header->allocator, sizeof(linked_list));
+
+	if (node == NULL)
+		return NULL;
+
+	if (! is_chunk && ! header->has_loose_nodes)
+		header->has_loose_nodes = 1;
+
+	list_bind_node(node, header, is_chunk);
+	node->value = value;
+	node->previous = NULL;
+	node->next = NULL;
+
+	return node;
+}
+
+
+int list_is_hook(linked_list const * node)
+{
+	return node->value == node;
+}
+
+
+/**
+ * @brief - binds a hook to the given header, without updating it
+ *
+ * @param hook - the hook to bind, storing itself as value
+ * @param header - the header the hook will belong to
+ */
+static void bind_hook(linked_list * hook, header * header)
+{
+	list_bind_node(hook, header, 0);
+	hook->value = hook;
+	hook->previous = NULL;
+	hook->next = NULL;
+}
+
+
+void list_release_node(header * header, linked_list * node)
+{
+	if (list_is_hook(node))
+		return;
+
+	if (! is_chunk_node(node))
+	{
+		list_release(& header->allocator, node);
+		return;
+	}
+
+	/* without a pool to reuse it, the node is left to its chunk */
+	if (pool_of(header) == NULL)
+		return;
+
+	node->next = header->pool->free_nodes;
+	header->pool->free_nodes = node;
+}
+
+
+/**
+ * @brief - releases the headers concatenated to the list, and the ones
+ * 	concatenated to them, whose stores were handed over to the list
+ *
+ * @param header - the header of the list
+ */
+static void release_absorbed_headers(header * header)
+{
+	struct list_header * absorbed;
+	struct list_header * nested;
+
+	while ((absorbed = header->absorbed) != NULL)
+	{
+		header->absorbed = absorbed->next_absorbed;
+
+		/* nested headers join the ones left to release, without recursing */
+		while ((nested = absorbed->absorbed) != NULL)
+		{
+			absorbed->absorbed = nested->next_absorbed;
+			nested->next_absorbed = header->absorbed;
+			header->absorbed = nested;
+		}
+
+		release_stores(absorbed);
+		list_release(& absorbed->allocator, absorbed);
+	}
+}
+
+
+/**
+ * @brief - gives the family of the list, once merged families are followed
+ *
+ * @param header - the header of the list
+ *
+ * @return list_family * - the family, NULL if the list never exchanged nodes
+ * 	with another one
+ */
+static list_family * family_of(header * header)
+{
+	list_family * family = header->family;
+	if (family == NULL)
+		return NULL;
+
+	while (family->merged != NULL)
+		family = family->merged;
+	header->family = family;
+
+	return family;
+}
+
+
+/**
+ * @brief - creates a family without lists
+ *
+ * @param allocator - the allocator of the lists joining it
+ *
+ * @return list_family * - the created family, NULL if allocation failed
+ */
+static list_family * create_family(list_allocator const * allocator)
+{
+	list_family * family = list_allocate(allocator, sizeof(* family));
+	if (family == NULL)
+		return NULL;
+
+	memset(family, 0, sizeof(* family));
+	family->allocator = * allocator;
+
+	return family;
+}
+
+
+/**
+ * @brief - adds a list to a family, merging the family it was in
+ *
+ * @param family - the family the list joins
+ * @param header - the header of the list
+ */
+static void join_family(list_family * family, header * header)
+{
+	list_family * former = family_of(header);
+
+	if (former == family)
+		return;
+
+	if (former == NULL)
+		family->lists++;
+	else
+	{
+		former->merged = family;
+		former->next_joined = family->joined;
+		family->joined = former;
+		family->lists += former->lists;
+	}
+
+	header->family = family;
+}
+
+
+/**
+ * @brief - releases a family whose lists are all deleted, along with the
+ * 	families merged into it and the headers they kept
+ *
+ * @param family - the family to release
+ */
+static void release_family(list_family * family)
+{
+	list_family * joined;
+	header * header;
+
+	while (family != NULL)
+	{
+		/* merged families join the ones left to release, without recursing */
+		while ((joined = family->joined) != NULL)
+		{
+			family->joined = joined->next_joined;
+			joined->next_joined = family->next_joined;
+			family->next_joined = joined;
+		}
+
+		while ((header = family->headers) != NULL)
+		{
+			family->headers = header->next_absorbed;
+			release_absorbed_headers(header);
+			list_release(& header->allocator, header);
+		}
+
+		joined = family->next_joined;
+		list_release(& family->allocator, family);
+		family = joined;
+	}
+}
+
+
+/**
+ * @brief - keeps a header with a family, until the family is released
+ *
+ * @param family - the family keeping the header
+ * @param header - the header to keep, not part of any chain
+ */
+static void keep_header(list_family * family, header * header)
+{
+	header->next_absorbed = family->headers;
+	family->headers = header;
+}
+
+
+void list_delete_header(header ** header)
+{
+	list_allocator allocator = (* header)->allocator;
+	list_family * family = family_of(* header);
+
+	/* retired nodes may be carved out of chunks, released with the stores */
+	list_release_concurrency(* header);
+
+	release_stores(* header);
+	list_release(& allocator, (* header)->pool);
+	(* header)->pool = NULL;
+	list_release_milestones(* header);
+	list_release_index(* header);
+	list_release_value_index(* header);
+	list_release_snapshots(* header);
+
+	/* nodes of other lists of the family may still be bound to the header, or
+	 * to the ones it absorbed */
+	if (family != NULL)
+	{
+		keep_header(family, * header);
+		if (--family->lists == 0)
+			release_family(family);
+	}
+	else
+	{
+		release_absorbed_headers(* header);
+		list_release(& allocator, * header);
+	}
+
+	* header = NULL;
+}
+
+
+size_t list_spread_hash(size_t hash)
+{
+	hash ^= hash >> 15;
+	hash *= 0x2C1B3C6DU;
+	hash ^= hash >> 12;
+	hash *= 0x297A2D39U;
+	hash ^= hash >> 15;
+
+	return hash;
+}
+
+
+/**
+ * @brief - binds an end of the list to it, so walks looking for the list of
+ * 	a node can stop there, nodes of shared lists are never bound again
+ *
+ * @param header - the header of the list
+ * @param node - the first or last node of the list, NULL if it is empty
+ */
+static void bind_end(header * header, linked_list * node)
+{
+	if (node != NULL && bound_header(node) != binding_of(header))
+		list_bind_node(node, header, is_chunk_node(node));
+}
+
+
+void list_set_first_node(header * header, linked_list * node)
+{
+	bind_end(header, node);
+	STORE_LINK(header->first_node, node);
+	STORE_LINK(header->anchor.next, node);
+}
+
+
+void list_set_last_node(header * header, linked_list * node)
+{
+	bind_end(header, node);
+	STORE_LINK(header->last_node, node);
+}
+
+
+/**
+ * @brief - sets the size of the list, loaded by readers of synchronized lists
+ * 	without locking
+ *
+ * @param header - the header of the list
+ * @param size - how many nodes the list holds
+ */
+static void set_size(header * header, size_t size)
+{
+	__atomic_store_n(& header->size, size, __ATOMIC_RELEASE);
+}
+
+
+int list_is_shared(header const * header)
+{
+	return header->lock != NULL || header->concurrent != NULL;
+}
+
+
+size_t list_size_of(header * header)
+{
+	linked_list const * node;
+	size_t size = 0;
+
+	/* shared lists never take part in moves, so are never counted here */
+	if (header->stale_size)
+	{
+		for (node = header->first_node; node != NULL; node = node->next)
+			size++;
+		set_size(header, size);
+		header->stale_size = 0;
+	}
+
+	/* written alone by writers, counted ahead by concurrent producers */
+	return __atomic_load_n(& header->size, __ATOMIC_ACQUIRE);
+}
+
+
+/**
+ * @brief - updates the header, setting last node and incrementing size
+ *
+ * @param node_to_append - the node that will be appended
+ */
+static void update_header_append(linked_list * node_to_append)
+{
+	header * header = list_header_of(node_to_append);
+
+	if (header->index != NULL)
+		list_index_chain(header, header->last_node, NULL, node_to_append, 1);
+	if (header->keys != NULL)
+		list_index_value(header, node_to_append, 1);
+	if (header->snapshots != NULL)
+		list_snapshot_value(header, node_to_append, 1);
+
+	if (header->first_node == NULL)
+		list_set_first_node(header, node_to_append);
+
+	list_set_last_node(header, node_to_append);
+	set_size(header, header->size + 1);
+
+	list_record_milestone_if_due(header, node_to_append);
+}
+
+
+/**
+ * @brief - updates the header, setting first node and incrementing size
+ *
+ * @param node_to_append - the node that will be prepended
+ */
+static void update_header_prepend(linked_list * node_to_prepend)
+{
+	header * header = list_header_of(node_to_prepend);
+
+	if (header->index != NULL)
+		list_index_chain(header, NULL, header->first_node, node_to_prepend, 1);
+	if (header->keys != NULL)
+		list_index_value(header, node_to_prepend, 0);
+	if (header->snapshots != NULL)
+		list_snapshot_value(header, node_to_prepend, 0);
+
+	if (header->last_node == NULL)
+		list_set_last_node(header, node_to_prepend);
+
+	/* readers reaching the node from the anchor go on to the old head */
+	node_to_prepend->next = header->first_node;
+	list_set_first_node(header, node_to_prepend);
+	set_size(header, header->size + 1);
+}
+
+
+/**
+ * @brief - updates the header, setting first/last nodes and decrementing size
+ *
+ * @param header - the header of the list
+ * @param node_to_remove - the node that will be removed
+ */
+static void update_header_removal(header * header, linked_list * node_to_remove)
+{
+	if (node_to_remove == header->first_node)
+		list_set_first_node(header, node_to_remove->next);
+	if (node_to_remove == header->last_node)
+		list_set_last_node(header, node_to_remove->previous);
+
+	set_size(header, header->size - 1);
+	if (header->milestones != NULL)
+		list_forget_milestones(header);
+
+	/* snapshots find the position of the node in the index, so go first */
+	if (header->snapshots != NULL)
+		list_unsnapshot_value(header, node_to_remove);
+	if (header->index != NULL)
+		list_unindex_node(header, node_to_remove);
+	if (header->keys != NULL)
+		list_unindex_value(header, node_to_remove);
+}
+
+
+/**
+ * @brief - creates a node to be bound with the given header and returns it,
+ * 	the header to be bound will be updated
+ *
+ * @param value - the value to store in the node
+ * @param header - the header to bind and update
+ *
+ * @return linked_list * - the created node
+ */
+static linked_list * create_node_and_update_header_append(
+	void * value,
+	header * header)
+{
+	linked_list * node = list_create_node(value, header);
+	if (node == NULL)
+		return NULL;
+
+	update_header_append(node);
+
+	return node;
+}
+
+
+/**
+ * @brief - creates a node to be bound with the given header and returns it,
+ * 	the header to be bound will be updated
+ *
+ * @param value - the value to store in the node
+ * @param header - the header to bind and update
+ *
+ * @return linked_list * - the created node
+ */
+static linked_list * create_node_and_update_header_prepend(
+	void * value,
+	header * header)
+{
+	linked_list * node = list_create_node(value, header);
+	if (node == NULL)
+		return NULL;
+
+	update_header_prepend(node);
+
+	return node;
+}
+
+
+/**
+ * @brief - checks if nodes have to be released one by one, nodes carved out
+ * 	of chunks go with them and arena nodes with their arena
+ *
+ * @param header - the header of the list to check
+ *
+ * @return int - 1 if each node has to be released, 0 otherwise
+ */
+static int has_to_release_nodes(header const * header)
+{
+	return header->has_loose_nodes && header->allocator.release != NULL;
+}
+
+
+/**
+ * @brief - deletes the current node and every previous ones,
+ * 	doesn't check for NULL argument
+ *
+ * @param header - the header of the list
+ * @param list - the list to delete, from the beginning to given node
+ */
+static void list_delete_backward(header * header, linked_list ** list)
+{
+	linked_list * previous;
+
+	while (* list != NULL)
+	{
+		previous = (* list)->previous;
+		list_release_node(header, * list);
+		* list = previous;
+	}
+}
+
+
+void list_delete_forward(header * header, linked_list ** list)
+{
+	linked_list * next;
+
+	while (* list != NULL)
+	{
+		next = (* list)->next;
+		list_release_node(header, * list);
+		* list = next;
+	}
+}
+
+
+void list_link_nodes(linked_list * before, linked_list * after)
+{
+	if (before != NULL)
+		STORE_LINK(before->next, after);
+	if (after != NULL)
+		STORE_LINK(after->previous, before);
+}
+
+
+/**
+ * @brief - checks if a list can take the nodes of another one along with its
+ * 	header, nodes then have to be released by the same allocator in both
+ * 	lists, pooled or not
+ *
+ * @param header - the header of the list taking the nodes
+ * @param other - the header of the list giving its nodes
+ *
+ * @return int - 1 if the nodes can be taken, 0 otherwise
+ */
+static int can_absorb(header const * header, struct list_header const * other)
+{
+	return header != other
+		&& header->allocator.allocate == other->allocator.allocate
+		&& header->allocator.release == other->allocator.release
+		&& header->allocator.context == other->allocator.context
+		&& ! list_is_shared(header)
+		&& ! list_is_shared(other);
+}
+
+
+/**
+ * @brief - checks if nodes can be moved between 2 lists one by one
+ *
+ * @param from - the header of the list giving the nodes
+ * @param to - the header of the list taking the nodes
+ *
+ * @return int - 1 if the nodes can be moved, 0 otherwise
+ */
+static int can_move_nodes(header const * from, header const * to)
+{
+	return (from == to) ? ! list_is_shared(from) : can_absorb(to, from);
+}
+
+
+/**
+ * @brief - prepares a list to give nodes to another one, allocating what it
+ * 	takes first so nothing changes if allocation fails
+ *
+ * @param header - the header of the list giving nodes
+ * @param other - the header of the list taking them
+ * @param binding - set to the header new nodes of the list will be bound to
+ * @param family - set to a new family if neither list has one, NULL otherwise
+ *
+ * @return int - 1 if the list is ready, 0 if allocation failed
+ */
+static int prepare_scatter(
+	header * header,
+	struct list_header * other,
+	struct list_header ** binding,
+	list_family ** family)
+{
+	* family = NULL;
+	* binding = list_create_blank_header(& header->allocator);
+	if (* binding == NULL)
+		return 0;
+
+	if (family_of(header) != NULL || family_of(other) != NULL)
+		return 1;
+
+	* family = create_family(& header->allocator);
+	if (* family != NULL)
+		return 1;
+
+	list_release(& header->allocator, * binding);
+	return 0;
+}
+
+
+/**
+ * @brief - releases what was prepared for a list to give nodes away
+ *
+ * @param binding - the prepared binding header
+ * @param family - the prepared family, NULL if none
+ */
+static void cancel_scatter(struct list_header * binding, list_family * family)
+{
+	list_release(& binding->allocator, family);
+	list_release(& binding->allocator, binding);
+}
+
+
+/**
+ * @brief - records that a list gave nodes to another one, once they are
+ * 	linked: nodes bound to it so far can't be trusted anymore, so new ones and
+ * 	the ends of the list get bound to a new header leading to it, and both
+ * 	lists join a same family which keeps the headers nodes are bound to
+ *
+ * @param header - the header of the list which gave nodes
+ * @param other - the header of the list which took them
+ * @param binding - the prepared binding header
+ * @param family - the prepared family, NULL if either list has one
+ */
+static void scatter(
+	header * header,
+	struct list_header * other,
+	struct list_header * binding,
+	list_family * family)
+{
+	if (family == NULL)
+		family = family_of(header);
+	if (family == NULL)
+		family = family_of(other);
+	join_family(family, header);
+	join_family(family, other);
+	keep_header(family, binding);
+
+	header->scattered_at = tick();
+	binding->forward = header;
+	binding->joined_at = tick();
+	header->binding = binding;
+
+	bind_end(header, header->first_node);
+	bind_end(header, header->last_node);
+}
+
+
+void list_forget_positions(header * header)
+{
+	if (header->milestones != NULL)
+		list_forget_milestones(header);
+	if (header->index != NULL)
+		list_forget_index(header);
+	if (header->keys != NULL)
+		list_forget_value_index(header);
+	if (header->snapshots != NULL)
+		list_forget_snapshots(header);
+}
+
+
+/**
+ * @brief - unlinks a run of removed nodes from the list and releases them,
+ * 	the size of the list isn't updated
+ *
+ * @param header - the header of the list
+ * @param before - the node before the run, NULL if the run starts the list
+ * @param first - the first node of the run
+ * @param after - the node after the run, NULL if the run ends the list
+ * @param destructor - called on the value of every removed node, if not NULL
+ * @param context - given to the destructor
+ */
+static void remove_run(
+	header * header,
+	linked_list * before,
+	linked_list * first,
+	linked_list * after,
+	void (* destructor)(void * value, void * context),
+	void * context)
+{
+	linked_list * next;
+
+	list_link_nodes(before, after);
+	if (before == NULL)
+		list_set_first_node(header, after);
+	if (after == NULL)
+		list_set_last_node(header, before);
+
+	for (; first != after; first = next)
+	{
+		next = first->next;
+		list_retire_node(header, first, destructor, context);
+	}
+}
+
+
+/**
+ * @brief - creates linked nodes storing the given values, within a single
+ * 	block of memory, carved out of a chunk if the list releases its nodes so
+ * 	removed ones can be reused until the list is deleted
+ *
+ * @param header - the header the nodes will belong to, not updated
+ * @param values - the values to store, in order
+ * @param count - how many values to store, not 0
+ * @param last - set to the last created node
+ *
+ * @return linked_list * - the first created node, NULL if allocation failed
+ */
+static linked_list * create_chain(
+	header * header,
+	void * const * values,
+	size_t count,
+	linked_list ** last)
+{
+	int is_chunk = is_pooled(header) || header->allocator.release != NULL;
+	linked_list * block;
+	size_t index;
+
+	if (count > (size_t) -1 / sizeof(linked_list))
+		return NULL;
+
+	if (is_chunk)
+		block = take_pooled_nodes(header, count);
+	else
+		block = list_allocate(& header->allocator, count * sizeof(linked_list));
+
+	if (block == NULL)
+		return NULL;
+
+	if (! is_chunk)
+		header->has_loose_nodes = 1;
+
+	for (index = 0; index < count; index++)
+	{
+		list_bind_node(& block[index], header, is_chunk);
+		block[index].value = values[index];
+		block[index].previous = (index > 0) ? & block[index - 1] : NULL;
+		block[index].next = (index + 1 < count) ? & block[index + 1] : NULL;
+	}
+
+	* last = & block[count - 1];
+	return block;
+}
+
+
+/**
+ * @brief - inserts nodes storing the given values between 2 adjacent nodes
+ * 	of a list, and updates the header once
+ *
+ * @param header - the header of the list to insert into
+ * @param before - the node to insert after, NULL to insert at the beginning
+ * @param after - the node to insert before, NULL to insert at the end
+ * @param values - the values to store, in order
+ * @param count - how many values to store, not 0
+ *
+ * @return int - 1 if the values were inserted, 0 if allocation failed
+ */
+static int insert_values(
+	header * header,
+	linked_list * before,
+	linked_list * after,
+	void * const * values,
+	size_t count)
+{
+	linked_list * last;
+	linked_list * first = create_chain(header, values, count, & last);
+	if (first == NULL)
+		return 0;
+
+	if (header->index != NULL)
+		list_index_chain(header, before, after, first, count);
+	if (header->keys != NULL)
+		list_index_chain_values(header, before, after, first, last);
+	if (header->snapshots != NULL)
+		list_snapshot_chain(header, before, after, first, last);
+
+	/* the chain is whole before its neighbours lead to it */
+	first->previous = before;
+	last->next = after;
+	list_link_nodes(before, first);
+	list_link_nodes(last, after);
+
+	if (before == NULL)
+		list_set_first_node(header, first);
+	if (after == NULL)
+		list_set_last_node(header, last);
+	set_size(header, header->size + count);
+
+	if (after == NULL)
+		list_record_chain_milestones(header, first, header->size - count);
+
+	return 1;
+}
+
+
+void list_reserve_nodes(header * header, size_t count)
+{
+	node_pool * pool;
+
+	if (list_is_shared(header)
+		|| ! (is_pooled(header) || header->allocator.release != NULL))
+		return;
+
+	pool = pool_of(header);
+	if (pool == NULL || pool->unused_count >= count
+		|| count > ((size_t) -1 - sizeof(node_chunk)) / sizeof(linked_list))
+		return;
+
+	recycle_unused_nodes(pool);
+	grow_pool(header, count);
+}
+
+
+linked_list * list_create(void)
+{
+	return NULL;
+}
+
+
+linked_list * list_create_with_allocator(list_allocator const * allocator)
+{
+	header * header;
+
+	if (allocator == NULL || allocator->allocate == NULL)
+		return NULL;
+
+	header = list_create_anchored_header(allocator);
+	if (header == NULL)
+		return NULL;
+
+	return & header->anchor;
+}
+
+
+linked_list * list_create_pooled(size_t nodes_per_chunk)
+{
+	header * header = create_pooled_header(nodes_per_chunk);
+	if (header == NULL)
+		return NULL;
+
+	return & header->anchor;
+}
+
+
+void list_delete(linked_list ** list)
+{
+	linked_list * node;
+	header * header;
+
+	if (list == NULL)
+		return;
+
+	if (* list == NULL)
+		return;
+
+	header = list_header_of(* list);
+
+	if (header->concurrent != NULL)
+		list_release_concurrent_nodes(header);
+
+	/* shared lists are handled through their anchor, even when not empty */
+	node = list_is_anchor(* list) ? header->first_node : * list;
+	if (node != NULL && has_to_release_nodes(header))
+	{
+		list_delete_backward(header, & node->previous);
+		list_delete_forward(header, & node->next);
+
+		list_release_node(header, node);
+	}
+
+	list_delete_header(& header);
+	* list = NULL;
+}
+
+
+size_t list_size(linked_list const * list)
+{
+	if (list == NULL)
+		return 0;
+
+	return list_size_of(list_header_of(list));
+}
+
+
+size_t list_size_forward(linked_list const * list)
+{
+	header * header;
+	size_t position;
+	size_t epoch;
+	size_t size = 1;
+	if (list == NULL || list_is_anchor(list))
+		return 0;
+
+	header = list_header_of(list);
+	if (list_has_fresh_index(header)
+		&& list_index_position(header, list, & position))
+		return header->size - position;
+
+	epoch = list_enter_epoch_of(header);
+	while ((list = LOAD_LINK(list->next)) != NULL)
+		size++;
+	list_leave_epoch_of(header, epoch);
+
+	return size;
+}
+
+
+size_t list_size_backward(linked_list const * list)
+{
+	header * header;
+	size_t position;
+	size_t epoch;
+	size_t size = 1;
+	if (list == NULL || list_is_anchor(list))
+		return 0;
+
+	header = list_header_of(list);
+	if (list_has_fresh_index(header)
+		&& list_index_position(header, list, & position))
+		return position + 1;
+
+	epoch = list_enter_epoch_of(header);
+	while ((list = LOAD_LINK(list->previous)) != NULL)
+		size++;
+	list_leave_epoch_of(header, epoch);
+
+	return size;
+}
+
+
+void list_append(linked_list ** list, void * value)
+{
+	linked_list * old_tail;
+	linked_list * new_tail;
+	header * header;
+
+	if (list == NULL)
+		return;
+
+	header = (* list == NULL)
+		? list_create_blank_header(& list_default_allocator)
+		: list_header_of(* list);
+	if (header == NULL)
+		return;
+
+	if (header->concurrent != NULL)
+	{
+		list_add_concurrently(header, value, 1);
+		return;
+	}
+
+	list_lock_for_writing(header);
+
+	old_tail = header->last_node;
+	new_tail = create_node_and_update_header_append(value, header);
+	if (new_tail == NULL)
+	{
+		if (* list == NULL)
+			list_delete_header(& header);
+		else
+			list_unlock(header);
+		return;
+	}
+
+	list_link_nodes(old_tail, new_tail);
+
+	if (old_tail == NULL && ! list_is_shared(header)) /* was empty */
+		* list = new_tail;
+
+	list_unlock(header);
+}
+
+
+void list_prepend(linked_list ** list, void * value)
+{
+	linked_list * old_head;
+	linked_list * new_head;
+	header * header;
+
+	if (list == NULL)
+		return;
+
+	header = (* list == NULL)
+		? list_create_blank_header(& list_default_allocator)
+		: list_header_of(* list);
+	if (header == NULL)
+		return;
+
+	if (header->concurrent != NULL)
+	{
+		list_add_concurrently(header, value, 0);
+		return;
+	}
+
+	list_lock_for_writing(header);
+
+	old_head = header->first_node;
+	new_head = create_node_and_update_header_prepend(value, header);
+	if (new_head == NULL)
+	{
+		if (* list == NULL)
+			list_delete_header(& header);
+		else
+			list_unlock(header);
+		return;
+	}
+
+	list_link_nodes(new_head, old_head);
+
+	if (old_head == NULL && ! list_is_shared(header)) /* was empty */
+		* list = new_head;
+
+	list_unlock(header);
+}
+
+
+void list_append_hook(linked_list ** list, list_hook * hook)
+{
+	linked_list * old_tail;
+	header * header;
+
+	if (list == NULL || hook == NULL)
+		return;
+
+	header = (* list == NULL)
+		? list_create_blank_header(& list_default_allocator)
+		: list_header_of(* list);
+	if (header == NULL)
+		return;
+
+	bind_hook(hook, header);
+
+	if (header->concurrent != NULL)
+	{
+		list_push_concurrently(header, hook, 1);
+		return;
+	}
+
+	list_lock_for_writing(header);
+
+	old_tail = header->last_node;
+	update_header_append(hook);
+	list_link_nodes(old_tail, hook);
+
+	if (old_tail == NULL && ! list_is_shared(header)) /* was empty */
+		* list = hook;
+
+	list_unlock(header);
+}
+
+
+void list_prepend_hook(linked_list ** list, list_hook * hook)
+{
+	linked_list * old_head;
+	header * header;
+
+	if (list == NULL || hook == NULL)
+		return;
+
+	header = (* list == NULL)
+		? list_create_blank_header(& list_default_allocator)
+		: list_header_of(* list);
+	if (header == NULL)
+		return;
+
+	bind_hook(hook, header);
+
+	if (header->concurrent != NULL)
+	{
+		list_push_concurrently(header, hook, 0);
+		return;
+	}
+
+	list_lock_for_writing(header);
+
+	old_head = header->first_node;
+	update_header_prepend(hook);
+	list_link_nodes(hook, old_head);
+
+	if (old_head == NULL && ! list_is_shared(header)) /* was empty */
+		* list = hook;
+
+	list_unlock(header);
+}
+
+
+void list_append_array(
+	linked_list ** list,
+	void * const * values,
+	size_t count)
+{
+	linked_list * old_tail;
+	header * header;
+
+	if (list == NULL || values == NULL || count == 0)
+		return;
+
+	header = (* list == NULL)
+		? list_create_blank_header(& list_default_allocator)
+		: list_header_of(* list);
+	if (header == NULL)
+		return;
+
+	if (header->concurrent != NULL)
+	{
+		for (; count > 0; count--, values++)
+			list_add_concurrently(header, * values, 1);
+		return;
+	}
+
+	list_lock_for_writing(header);
+
+	old_tail = header->last_node;
+	if (! insert_values(header, old_tail, NULL, values, count))
+	{
+		if (* list == NULL)
+			list_delete_header(& header);
+		else
+			list_unlock(header);
+		return;
+	}
+
+	if (old_tail == NULL && ! list_is_shared(header)) /* was empty */
+		* list = header->first_node;
+
+	list_unlock(header);
+}
+
+
+void list_prepend_array(
+	linked_list ** list,
+	void * const * values,
+	size_t count)
+{
+	linked_list * old_head;
+	header * header;
+
+	if (list == NULL || values == NULL || count == 0)
+		return;
+
+	header = (* list == NULL)
+		? list_create_blank_header(& list_default_allocator)
+		: list_header_of(* list);
+	if (header == NULL)
+		return;
+
+	if (header->concurrent != NULL)
+	{
+		while (count-- > 0)
+			list_add_concurrently(header, values[count], 0);
+		return;
+	}
+
+	list_lock_for_writing(header);
+
+	old_head = header->first_node;
+	if (! insert_values(header, NULL, old_head, values, count))
+	{
+		if (* list == NULL)
+			list_delete_header(& header);
+		else
+			list_unlock(header);
+		return;
+	}
+
+	if (old_head == NULL && ! list_is_shared(header)) /* was empty */
+		* list = header->first_node;
+
+	list_unlock(header);
+}
+
+
+linked_list * list_from_array(void * const * values, size_t count)
+{
+	linked_list * list = list_create();
+
+	list_append_array(& list, values, count);
+
+	return list;
+}
+
+
+/**
+ * @brief - copies the values of the list into an array, as many as its size
+ * 	when the copy started, writers of a synchronized list may go on meanwhile
+ *
+ * @param header - the header of the list, in an epoch if synchronized
+ * @param values - room for the values
+ * @param size - how many values to copy
+ *
+ * @return int - 1 if the values were copied, 0 if the list got shorter
+ */
+static int copy_values(header const * header, void ** values, size_t size)
+{
+	linked_list const * list = LOAD_LINK(header->first_node);
+	linked_list const * ahead = list;
+	size_t index;
+
+	for (index = 0;
+		index < LIST_COPY_PREFETCH_DISTANCE && ahead != NULL;
+		index++)
+		ahead = LOAD_LINK(ahead->next);
+
+	for (index = 0; index < size; index++, list = LOAD_LINK(list->next))
+	{
+		if (list == NULL)
+			return 0;
+
+		if (ahead != NULL)
+		{
+			ahead = LOAD_LINK(ahead->next);
+			PREFETCH(ahead);
+		}
+
+		values[index] = list->value;
+	}
+
+	return 1;
+}
+
+
+void ** list_to_array(linked_list const * list)
 {
+	header * header;
+	void ** values = NULL;
+	size_t epoch;
+	size_t size;
+
 	if (list == NULL)
 		return NULL;
 
-	return list->value;
+	header = list_header_of(list);
+	if (header->concurrent != NULL) /* behaves as an empty list */
+		return NULL;
+
+	epoch = list_enter_epoch_of(header);
+
+	/* a list shrinking meanwhile is copied again, with its new size */
+	do
+	{
+		free(values);
+		values = NULL;
+
+		size = list_size_of(header);
+		if (size > 0 && size <= (size_t) -1 / sizeof(* values))
+			values = malloc(size * sizeof(* values));
+	}
+	while (values != NULL && ! copy_values(header, values, size));
+
+	list_leave_epoch_of(header, epoch);
+
+	return values;
+}
+
+
+void list_insert_array_after(
+	linked_list * node,
+	void * const * values,
+	size_t count)
+{
+	header * header;
+
+	if (node == NULL || list_is_anchor(node) || values == NULL || count == 0)
+		return;
+
+	header = list_header_of(node);
+	list_lock_for_writing(header);
+	insert_values(header, node, node->next, values, count);
+	list_unlock(header);
+}
+
+
+void list_remove_node(linked_list ** list)
+{
+	linked_list * node_to_remove;
+	size_t const one = 1;
+	header * header;
+
+	if (list == NULL || * list == NULL)
+		return;
+
+	node_to_remove = * list;
+	header = list_header_of(* list);
+
+	if (list_is_anchor(node_to_remove))
+		return;
+
+	list_lock_for_writing(header);
+
+	if (! list_reserve_retired(header, & one))
+	{
+		list_unlock(header);
+		return;
+	}
+
+	list_link_nodes(node_to_remove->previous, node_to_remove->next);
+	update_header_removal(header, node_to_remove);
+
+	* list = node_to_remove->next;
+	list_retire_node(header, node_to_remove, NULL, NULL);
+
+	if (header->first_node != NULL || list_is_shared(header))
+		list_unlock(header);
+	else if (is_configured(header)) /* empty again, led to by its anchor */
+		* list = & header->anchor;
+	else /* orphan header */
+		list_delete_header(& header);
+}
+
+
+size_t list_remove_if(
+	linked_list ** list,
+	int (* predicate)(void const * value, void * context),
+	void * context,
+	void (* destructor)(void * value, void * context))
+{
+	linked_list * removed = NULL;
+	linked_list * kept = NULL;
+	linked_list * node;
+	header * header;
+	size_t count = 0;
+	int anchored;
+
+	if (list == NULL || * list == NULL || predicate == NULL)
+		return 0;
+
+	header = list_header_of(* list);
+	if (header->concurrent != NULL)
+		return 0;
+
+	anchored = list_is_anchor(* list); /* the handle may be removed */
+
+	list_lock_for_writing(header);
+
+	/* every node may be removed */
+	list_size_of(header);
+	if (! list_reserve_retired(header, & header->size))
+	{
+		list_unlock(header);
+		return 0;
+	}
+
+	/* removed runs are linked over once the next kept node is found */
+	for (node = header->first_node; node != NULL; node = node->next)
+	{
+		if (predicate(node->value, context))
+		{
+			if (removed == NULL)
+				removed = node;
+			count++;
+			continue;
+		}
+
+		if (removed != NULL)
+			remove_run(header, kept, removed, node, destructor, context);
+		removed = NULL;
+		kept = node;
+	}
+	if (removed != NULL)
+		remove_run(header, kept, removed, NULL, destructor, context);
+
+	if (count > 0)
+	{
+		set_size(header, header->size - count);
+		list_forget_positions(header);
+	}
+
+	if (! anchored)
+		* list = header->first_node;
+
+	if (count == 0 || header->first_node != NULL || list_is_shared(header))
+		list_unlock(header);
+	else if (is_configured(header)) /* empty again, led to by its anchor */
+		* list = & header->anchor;
+	else /* orphan header */
+	{
+		list_delete_header(& header);
+		* list = NULL;
+	}
+
+	return count;
+}
+
+
+int list_concat(linked_list ** list, linked_list ** other)
+{
+	struct list_header * absorbed;
+	list_family * family;
+	header * header;
+
+	if (list == NULL || other == NULL)
+		return 0;
+
+	if (* other == NULL)
+		return 1;
+
+	if (* list == NULL)
+	{
+		* list = * other;
+		* other = NULL;
+		return 1;
+	}
+
+	header = list_header_of(* list);
+	absorbed = list_header_of(* other);
+	if (! can_absorb(header, absorbed))
+		return 0;
+
+	/* nodes stay bound to the absorbed header, which leads to this one */
+	if (absorbed->first_node != NULL)
+	{
+		list_link_nodes(header->last_node, absorbed->first_node);
+		if (header->first_node == NULL)
+			list_set_first_node(header, absorbed->first_node);
+		list_set_last_node(header, absorbed->last_node);
+		header->size += absorbed->size;
+		header->stale_size = header->stale_size || absorbed->stale_size;
+		list_forget_positions(header);
+	}
+
+	/* nodes of other lists may be bound to the absorbed header, kept by the
+	 * list from now on, which takes its place in their family */
+	family = family_of(header);
+	if (family == NULL)
+		family = family_of(absorbed);
+	if (family != NULL)
+	{
+		join_family(family, header);
+		join_family(family, absorbed);
+		family->lists--;
+	}
+
+	/* pooled and plain nodes may mix, each one knows how to be released */
+	take_stores(header, absorbed);
+	if (absorbed->has_loose_nodes)
+		header->has_loose_nodes = 1;
+
+	/* the forwarding header keeps none of its state, its free nodes are left
+	 * to their chunks */
+	list_release(& absorbed->allocator, absorbed->pool);
+	absorbed->pool = NULL;
+	list_release_milestones(absorbed);
+	list_release_index(absorbed);
+	list_release_value_index(absorbed);
+	list_release_snapshots(absorbed);
+	absorbed->forward = header;
+	absorbed->joined_at = tick();
+	absorbed->next_absorbed = header->absorbed;
+	header->absorbed = absorbed;
+
+	if (list_is_anchor(* list) && header->first_node != NULL) /* was empty */
+		* list = header->first_node;
+	* other = NULL;
+
+	return 1;
+}
+
+
+int list_splice(linked_list ** first, linked_list * last, linked_list * after)
+{
+	struct list_header * binding = NULL;
+	list_family * family = NULL;
+	linked_list * left_behind;
+	header * destination;
+	linked_list * before;
+	linked_list * next;
+	header * source;
+	int is_scattered;
+
+	if (first == NULL || * first == NULL || last == NULL || after == NULL)
+		return 0;
+
+	source = list_header_of(* first);
+	destination = list_header_of(after);
+	if (list_is_anchor(* first) || ! can_move_nodes(source, destination))
+		return 0;
+
+	/* the range isn't walked, only its ends can be told from the target */
+	if (after == * first || after == last)
+		return 0;
+
+	/* a single node is bound at once, a longer range finds its list lazily */
+	is_scattered = source != destination && * first != last;
+	if (is_scattered && ! prepare_scatter(source, destination, & binding, & family))
+		return 0;
+
+	if (source != destination)
+	{
+		if (! share_stores(destination, source))
+		{
+			if (is_scattered)
+				cancel_scatter(binding, family);
+			return 0;
+		}
+		if (source->has_loose_nodes)
+			destination->has_loose_nodes = 1;
+		if (! is_scattered)
+			list_bind_node(last, destination, is_chunk_node(last));
+	}
+
+	/* detaches the range */
+	before = (* first)->previous;
+	left_behind = last->next;
+	list_link_nodes(before, left_behind);
+	if (before == NULL)
+		list_set_first_node(source, left_behind);
+	if (left_behind == NULL)
+		list_set_last_node(source, before);
+
+	/* inserts it, an anchor leads to the head */
+	before = list_is_anchor(after) ? NULL : after;
+	next = (before == NULL) ? destination->first_node : after->next;
+	(* first)->previous = before;
+	last->next = next;
+	list_link_nodes(before, * first);
+	list_link_nodes(last, next);
+	if (before == NULL)
+		list_set_first_node(destination, * first);
+	if (next == NULL)
+		list_set_last_node(destination, last);
+
+	if (is_scattered)
+	{
+		source->stale_size = 1;
+		destination->stale_size = 1;
+		scatter(source, destination, binding, family);
+	}
+	else if (source != destination)
+	{
+		set_size(source, source->size - 1);
+		set_size(destination, destination->size + 1);
+	}
+
+	list_forget_positions(source);
+	list_forget_positions(destination);
+
+	* first = left_behind;
+	if (source->first_node != NULL)
+		return 1;
+
+	if (is_configured(source)) /* empty again, led to by its anchor */
+		* first = & source->anchor;
+	else /* orphan header */
+		list_delete_header(& source);
+
+	return 1;
+}
+
+
+linked_list * list_split_at(linked_list * node)
+{
+	struct list_header * binding;
+	struct list_header * split;
+	list_family * family;
+	linked_list * before;
+	header * header;
+
+	if (node == NULL || list_is_anchor(node))
+		return NULL;
+
+	header = list_header_of(node);
+	if (! can_move_nodes(header, header))
+		return NULL;
+
+	before = node->previous;
+	if (before == NULL) /* already leads the whole list */
+		return node;
+
+	/* the new list is configured like the split one, its nodes may come
+	 * from the same stores */
+	split = is_configured(header)
+		? list_create_anchored_header(& header->allocator)
+		: list_create_blank_header(& header->allocator);
+	if (split == NULL)
+		return NULL;
+
+	if (! prepare_scatter(header, split, & binding, & family))
+	{
+		list_delete_header(& split);
+		return NULL;
+	}
+
+	if (! share_stores(split, header)
+		|| (is_pooled(header) && pool_of(split) == NULL))
+	{
+		cancel_scatter(binding, family);
+		list_delete_header(& split);
+		return NULL;
+	}
+	if (is_pooled(header))
+		split->pool->chunk_capacity = header->pool->chunk_capacity;
+	split->has_loose_nodes = header->has_loose_nodes;
+
+	/* the header stays with the front, only the ends of the back are bound
+	 * to the new list, other nodes find their list lazily */
+	list_set_first_node(split, node);
+	list_set_last_node(split, header->last_node);
+	list_link_nodes(before, NULL);
+	list_link_nodes(NULL, node);
+	list_set_last_node(header, before);
+
+	header->stale_size = 1;
+	split->stale_size = 1;
+	scatter(header, split, binding, family);
+	list_forget_positions(header);
+
+	return node;
 }
 
 
-void * list_reduce(
-	linked_list const * list,
-	void * accumulator,
-	void (* reducer)(void * accumulator, void const * node_content))
+linked_list * list_at(linked_list const * list, size_t position)
 {
-	while (list != NULL)
+	linked_list * node;
+	header * header;
+	size_t epoch;
+	size_t steps;
+	size_t size;
+
+	if (list == NULL)
+		return NULL;
+
+	header = list_header_of(list);
+	if (list_has_fresh_index(header))
 	{
-		reducer(accumulator, list->value);
-		list = list->next;
+		return (position < header->size)
+			? list_index_node_at(header, position)
+			: NULL;
 	}
 
-	return accumulator;
+	epoch = list_enter_epoch_of(header);
+	size = list_size_of(header);
+
+	/* walks from the closest end, which writers may move meanwhile */
+	if (position >= size)
+		node = NULL;
+	else if (position < size / 2)
+	{
+		node = LOAD_LINK(header->first_node);
+		for (steps = position; steps > 0 && node != NULL; steps--)
+			node = LOAD_LINK(node->next);
+	}
+	else
+	{
+		node = LOAD_LINK(header->last_node);
+		for (steps = size - 1 - position; steps > 0 && node != NULL; steps--)
+			node = LOAD_LINK(node->previous);
+	}
+
+	list_leave_epoch_of(header, epoch);
+
+	return node;
+}
+
+
+size_t list_index_of(linked_list const * node)
+{
+	header * header;
+	size_t position = 0;
+	size_t epoch;
+
+	if (node == NULL || list_is_anchor(node))
+		return (size_t) -1;
+
+	header = list_header_of(node);
+	if (list_has_fresh_index(header)
+		&& list_index_position(header, node, & position))
+		return position;
+
+	epoch = list_enter_epoch_of(header);
+	while ((node = LOAD_LINK(node->previous)) != NULL)
+		position++;
+	list_leave_epoch_of(header, epoch);
+
+	return position;
+}
+
+
+linked_list * list_next(linked_list const * list)
+{
+	if (list == NULL)
+		return NULL;
+
+	return LOAD_LINK(list->next);
+}
+
+
+linked_list * list_previous(linked_list const * list)
+{
+	if (list == NULL)
+		return NULL;
+
+	return LOAD_LINK(list->previous);
+}
+
+
+linked_list * list_head(linked_list const * list)
+{
+	linked_list * head;
+	header * header;
+
+	if (list == NULL)
+		return NULL;
+
+	header = list_header_of(list);
+	head = LOAD_LINK(header->first_node);
+
+	return head;
+}
+
+
+linked_list * list_tail(linked_list const * list)
+{
+	linked_list * tail;
+	header * header;
+
+	if (list == NULL)
+		return NULL;
+
+	header = list_header_of(list);
+	tail = LOAD_LINK(header->last_node);
+
+	return tail;
+}
+
+
+void * list_content(linked_list const * list)
+{
+	if (list == NULL)
+		return NULL;
+
+	return list->value;
 }
@@ -0,0 +1,575 @@
+
+#define _POSIX_C_SOURCE 200112L /* pthread_rwlock_t */
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "../include/List.h"
+#include "../include/ListNode.h"
+#include "ListPrivate.h"
+
+
+/**
+ * @brief - the chains producers of a concurrent list add nodes to, without
+ * 	locking, until the consumer drains them into a regular list
+ * 	Prepended nodes lead to the current stub through their next link, and
+ * 	appended ones follow it, so producers at both ends never touch the same
+ * 	link: a producer swaps the end atomically, then links its node
+ */
+typedef struct concurrent_chains
+{
+	/**
+	 * @brief - the most recently prepended node, the current stub if none
+	 */
+	linked_list * head;
+
+	/**
+	 * @brief - the most recently appended node, the current stub if none
+	 */
+	linked_list * tail;
+
+	/**
+	 * @brief - the nodes both chains meet at, never part of the list, a
+	 * 	drain switches to the other one so producers don't wait for it
+	 */
+	linked_list stubs[2];
+
+	/**
+	 * @brief - the index of the current stub
+	 */
+	int current_stub;
+} concurrent_chains;
+
+
+/**
+ * @brief - a node removed from a synchronized list, with the destructor its
+ * 	value waits for, since readers may still read it
+ */
+typedef struct retired_node
+{
+	/**
+	 * @brief - the removed node, unlinked but still leading to its neighbours
+	 */
+	linked_list * node;
+
+	/**
+	 * @brief - called on the value of the node once released, if not NULL
+	 */
+	void (* destructor)(void * value, void * context);
+
+	/**
+	 * @brief - given to the destructor
+	 */
+	void * context;
+} retired_node;
+
+
+/**
+ * @brief - nodes removed from a synchronized list during a same epoch, waiting
+ * 	to be released
+ */
+typedef struct retired_nodes
+{
+	/**
+	 * @brief - the removed nodes
+	 */
+	retired_node * nodes;
+
+	/**
+	 * @brief - how many nodes are retired
+	 */
+	size_t count;
+
+	/**
+	 * @brief - how many nodes can be retired before growing
+	 */
+	size_t capacity;
+} retired_nodes;
+
+
+/**
+ * @brief - epochs of a synchronized list, so readers walk it without locking
+ * 	Readers register in the epoch they enter, writers retire removed nodes
+ * 	in the current epoch and move to the next one once nobody is left in
+ * 	the previous one: nodes retired 2 epochs ago can't be reached anymore,
+ * 	since every reader who could have seen them is gone
+ * 	Epochs are told apart by their parity, 2 of them are alive at most
+ */
+typedef struct epoch_reclamation
+{
+	/**
+	 * @brief - the current epoch, only moved by writers
+	 */
+	size_t epoch;
+
+	/**
+	 * @brief - how many readers are in an even or odd epoch
+	 */
+	size_t readers[2];
+
+	/**
+	 * @brief - the nodes removed during an even or odd epoch
+	 */
+	retired_nodes retired[2];
+} epoch_reclamation;
+
+
+
+
+/**
+ * @brief - releases every retired node of an epoch, destroying their values
+ *
+ * @param header - the header of the list the nodes were removed from
+ * @param retired - the nodes to release
+ */
+static void release_retired(header * header, retired_nodes * retired)
+{
+	retired_node * entry;
+	size_t index;
+
+	for (index = 0; index < retired->count; index++)
+	{
+		entry = & retired->nodes[index];
+		if (entry->destructor != NULL)
+			entry->destructor(entry->node->value, entry->context);
+		list_release_node(header, entry->node);
+	}
+
+	retired->count = 0;
+}
+
+
+void list_lock_for_reading(header const * header)
+{
+	if (header->lock != NULL)
+		pthread_rwlock_rdlock(header->lock);
+}
+
+
+void list_lock_for_writing(header const * header)
+{
+	if (header->lock != NULL)
+		pthread_rwlock_wrlock(header->lock);
+}
+
+
+void list_unlock(header const * header)
+{
+	if (header->lock != NULL)
+		pthread_rwlock_unlock(header->lock);
+}
+
+
+size_t list_enter_epoch_of(header const * header)
+{
+	epoch_reclamation * reclamation = header->reclamation;
+	size_t * readers;
+	size_t epoch;
+
+	if (reclamation == NULL)
+		return 0;
+
+	for (;;)
+	{
+		epoch = __atomic_load_n(& reclamation->epoch, __ATOMIC_SEQ_CST);
+		readers = & reclamation->readers[epoch % 2];
+
+		__atomic_fetch_add(readers, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(& reclamation->epoch, __ATOMIC_SEQ_CST) == epoch)
+			return epoch;
+		__atomic_fetch_sub(readers, 1, __ATOMIC_SEQ_CST);
+	}
+}
+
+
+void list_leave_epoch_of(header const * header, size_t epoch)
+{
+	if (header->reclamation != NULL)
+	{
+		__atomic_fetch_sub(
+			& header->reclamation->readers[epoch % 2],
+			1,
+			__ATOMIC_SEQ_CST);
+	}
+}
+
+
+/**
+ * @brief - moves to the next epoch if no reader is left in the previous one,
+ * 	releasing the nodes retired then, called by writers only
+ *
+ * @param header - the header of the list, whose epochs are advanced
+ */
+static void advance_epoch(header * header)
+{
+	epoch_reclamation * reclamation = header->reclamation;
+	size_t next = reclamation->epoch + 1; /* shares its parity with previous */
+	size_t * readers = & reclamation->readers[next % 2];
+
+	if (__atomic_load_n(readers, __ATOMIC_SEQ_CST) > 0)
+		return;
+
+	release_retired(header, & reclamation->retired[next % 2]);
+	__atomic_store_n(& reclamation->epoch, next, __ATOMIC_SEQ_CST);
+}
+
+
+int list_reserve_retired(header * header, size_t const * count)
+{
+	epoch_reclamation * reclamation = header->reclamation;
+	retired_nodes * retired;
+	retired_node * nodes;
+	size_t capacity;
+	size_t parity;
+
+	if (reclamation == NULL)
+		return 1;
+
+	/* the first epoch may fill up while the second one grows */
+	do
+	{
+		for (parity = 0; parity < 2; parity++)
+		{
+			retired = & reclamation->retired[parity];
+			while (retired->capacity - retired->count < * count)
+			{
+				capacity = retired->capacity ? retired->capacity * 2 : 16;
+				if (capacity < retired->count + * count)
+					capacity = retired->count + * count;
+				if (capacity > (size_t) -1 / sizeof(* nodes))
+					return 0;
+
+				list_unlock(header);
+				nodes = list_allocate(
+					& header->allocator,
+					capacity * sizeof(* nodes));
+				list_lock_for_writing(header);
+				if (nodes == NULL)
+					return 0;
+
+				/* other writers may have grown or filled it meanwhile */
+				if (capacity <= retired->capacity
+					|| capacity < retired->count)
+				{
+					list_release(& header->allocator, nodes);
+					continue;
+				}
+
+				if (retired->count > 0)
+					memcpy(nodes, retired->nodes,
+						retired->count * sizeof(* nodes));
+				list_release(& header->allocator, retired->nodes);
+
+				retired->nodes = nodes;
+				retired->capacity = capacity;
+			}
+		}
+
+		retired = & reclamation->retired[0];
+	}
+	while (retired->capacity - retired->count < * count);
+
+	return 1;
+}
+
+
+void list_retire_node(
+	header * header,
+	linked_list * node,
+	void (* destructor)(void * value, void * context),
+	void * context)
+{
+	epoch_reclamation * reclamation = header->reclamation;
+	retired_nodes * retired;
+
+	if (reclamation == NULL)
+	{
+		if (destructor != NULL)
+			destructor(node->value, context);
+		list_release_node(header, node);
+		return;
+	}
+
+	retired = & reclamation->retired[reclamation->epoch % 2];
+	retired->nodes[retired->count].node = node;
+	retired->nodes[retired->count].destructor = destructor;
+	retired->nodes[retired->count].context = context;
+	retired->count++;
+	advance_epoch(header);
+}
+
+
+void list_push_concurrently(header * header, linked_list * node, int at_end)
+{
+	concurrent_chains * chains = header->concurrent;
+	linked_list * previous;
+
+	node->previous = NULL;
+	node->next = NULL;
+
+	/* counted before being published, so a drain never takes more nodes away
+	 * than were counted */
+	__atomic_fetch_add(& header->size, 1, __ATOMIC_RELAXED);
+
+	if (at_end)
+	{
+		previous = __atomic_exchange_n(& chains->tail, node, __ATOMIC_ACQ_REL);
+		__atomic_store_n(& previous->next, node, __ATOMIC_RELEASE);
+	}
+	else
+	{
+		previous = __atomic_exchange_n(& chains->head, node, __ATOMIC_ACQ_REL);
+		__atomic_store_n(& node->next, previous, __ATOMIC_RELEASE);
+	}
+}
+
+
+/**
+ * @brief - waits until the producer of the next node has linked it, which it
+ * 	does right after swapping the end of the chain
+ *
+ * @param node - the node whose next one is being linked
+ *
+ * @return linked_list * - the next node
+ */
+static linked_list * wait_next_link(linked_list * node)
+{
+	linked_list * next;
+
+	while ((next = __atomic_load_n(& node->next, __ATOMIC_ACQUIRE)) == NULL)
+		sched_yield();
+
+	return next;
+}
+
+
+/**
+ * @brief - moves a node of a drained chain to the end of a regular list
+ *
+ * @param list_header - the header of the regular list, updated
+ * @param node - the node to move, its next link is left as is
+ */
+static void adopt_node(header * list_header, linked_list * node)
+{
+	list_bind_node(node, list_header, 0);
+	if (! list_is_hook(node))
+		list_header->has_loose_nodes = 1;
+	node->previous = list_header->last_node;
+
+	if (list_header->last_node != NULL)
+		list_header->last_node->next = node;
+	else
+		list_set_first_node(list_header, node);
+
+	list_set_last_node(list_header, node);
+	list_header->size++;
+}
+
+
+/**
+ * @brief - detaches every node added to a concurrent list so far, switching
+ * 	producers to the other stub, must only be called by a single consumer
+ *
+ * @param header - the header of the concurrent list
+ * @param drained - the blank header the detached nodes are moved to
+ */
+static void drain_chains(header * header, struct list_header * drained)
+{
+	concurrent_chains * chains = header->concurrent;
+	linked_list * old_stub = & chains->stubs[chains->current_stub];
+	linked_list * head;
+	linked_list * tail;
+	linked_list * node;
+	linked_list * next;
+
+	chains->current_stub = ! chains->current_stub;
+	head = __atomic_exchange_n(
+		& chains->head,
+		& chains->stubs[chains->current_stub],
+		__ATOMIC_ACQ_REL);
+	tail = __atomic_exchange_n(
+		& chains->tail,
+		& chains->stubs[chains->current_stub],
+		__ATOMIC_ACQ_REL);
+
+	for (node = head; node != old_stub; node = next)
+	{
+		next = wait_next_link(node);
+		adopt_node(drained, node);
+	}
+
+	for (node = old_stub; node != tail; )
+	{
+		node = wait_next_link(node);
+		adopt_node(drained, node);
+	}
+
+	if (drained->last_node != NULL)
+		drained->last_node->next = NULL;
+	old_stub->next = NULL;
+
+	__atomic_fetch_sub(& header->size, drained->size, __ATOMIC_RELAXED);
+}
+
+
+void list_release_concurrent_nodes(header * header)
+{
+	struct list_header drained;
+
+	memset(& drained, 0, sizeof(drained));
+	drained.allocator = header->allocator;
+
+	drain_chains(header, & drained);
+	list_delete_forward(& drained, & drained.first_node);
+}
+
+
+void list_add_concurrently(header * header, void * value, int at_end)
+{
+	linked_list * node = list_create_node(value, header);
+
+	if (node != NULL)
+		list_push_concurrently(header, node, at_end);
+}
+
+
+void list_release_concurrency(header * header)
+{
+	epoch_reclamation * reclamation = header->reclamation;
+
+	if (reclamation != NULL)
+	{
+		release_retired(header, & reclamation->retired[0]);
+		release_retired(header, & reclamation->retired[1]);
+		list_release(& header->allocator, reclamation->retired[0].nodes);
+		list_release(& header->allocator, reclamation->retired[1].nodes);
+		list_release(& header->allocator, reclamation);
+		header->reclamation = NULL;
+	}
+
+	list_release(& header->allocator, header->concurrent);
+	header->concurrent = NULL;
+
+	if (header->lock != NULL)
+	{
+		pthread_rwlock_destroy(header->lock);
+		list_release(& header->allocator, header->lock);
+		header->lock = NULL;
+	}
+}
+
+
+
+
+linked_list * list_create_concurrent(void)
+{
+	concurrent_chains * chains;
+	header * header = list_create_anchored_header(& list_default_allocator);
+	if (header == NULL)
+		return NULL;
+
+	chains = list_allocate(& header->allocator, sizeof(* chains));
+	if (chains == NULL)
+	{
+		list_delete_header(& header);
+		return NULL;
+	}
+
+	memset(chains, 0, sizeof(* chains));
+	chains->head = & chains->stubs[0];
+	chains->tail = & chains->stubs[0];
+	header->concurrent = chains;
+	header->has_loose_nodes = 1; /* set before producers allocate nodes */
+
+	return & header->anchor;
+}
+
+
+linked_list * list_create_synchronized(void)
+{
+	epoch_reclamation * reclamation;
+	pthread_rwlock_t * lock;
+	header * header = list_create_anchored_header(& list_default_allocator);
+	if (header == NULL)
+		return NULL;
+
+	reclamation = list_allocate(& header->allocator, sizeof(* reclamation));
+	if (reclamation == NULL)
+	{
+		list_delete_header(& header);
+		return NULL;
+	}
+
+	memset(reclamation, 0, sizeof(* reclamation));
+	header->reclamation = reclamation;
+
+	lock = list_allocate(& header->allocator, sizeof(* lock));
+	if (lock == NULL || pthread_rwlock_init(lock, NULL) != 0)
+	{
+		list_release(& header->allocator, lock);
+		list_delete_header(& header);
+		return NULL;
+	}
+
+	header->lock = lock;
+
+	return & header->anchor;
+}
+
+
+linked_list * list_drain(linked_list * list)
+{
+	header * drained;
+	header * header;
+
+	if (list == NULL)
+		return NULL;
+
+	header = list_header_of(list);
+	if (header->concurrent == NULL)
+		return NULL;
+
+	drained = list_create_blank_header(& header->allocator);
+	if (drained == NULL)
+		return NULL;
+
+	drain_chains(header, drained);
+	if (drained->size == 0)
+	{
+		list_delete_header(& drained);
+		return NULL;
+	}
+
+	return drained->first_node;
+}
+
+
+void list_lock_reading(linked_list const * list)
+{
+	if (list != NULL)
+		list_lock_for_reading(list_header_of(list));
+}
+
+
+void list_unlock_reading(linked_list const * list)
+{
+	if (list != NULL)
+		list_unlock(list_header_of(list));
+}
+
+
+size_t list_enter_epoch(linked_list const * list)
+{
+	if (list == NULL)
+		return 0;
+
+	return list_enter_epoch_of(list_header_of(list));
+}
+
+
+void list_leave_epoch(linked_list const * list, size_t epoch)
+{
+	if (list != NULL)
+		list_leave_epoch_of(list_header_of(list), epoch);
+}
@@ -0,0 +1,480 @@
+
+#include "../include/ListKernels.h"
+
+
+/**
+ * @brief - SIMD kernels are built for x86-64 only, AVX2 ones are compiled
+ * 	for their own target and picked at runtime, SSE2 is always there
+ */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define LIST_X86_64_KERNELS
+#include <immintrin.h>
+#define AVX2 __attribute__((target("avx2")))
+#endif
+
+
+
+
+/**
+ * @brief - dereferences a value of the batch as an int
+ */
+#define INT_AT(values, index) (* (int const *) (values)[index])
+
+
+/**
+ * @brief - dereferences a value of the batch as a double
+ */
+#define DOUBLE_AT(values, index) (* (double const *) (values)[index])
+
+
+
+
+#ifdef LIST_X86_64_KERNELS
+
+
+/**
+ * @brief - checks if the CPU can run the AVX2 kernels
+ *
+ * @return int - 1 if AVX2 is supported, 0 otherwise
+ */
+static int has_avx2(void)
+{
+	return __builtin_cpu_supports("avx2");
+}
+
+
+/**
+ * @brief - loads 4 ints, the addresses are used as gather indexes from 0
+ *
+ * @param values - the 4 values to load, int const *
+ *
+ * @return __m128i - the 4 ints
+ */
+AVX2 static __m128i gather_ints(void const * const * values)
+{
+	__m256i addresses = _mm256_loadu_si256((__m256i const *) values);
+
+	return _mm256_i64gather_epi32((int const *) 0, addresses, 1);
+}
+
+
+/**
+ * @brief - loads 4 doubles, the addresses are used as gather indexes from 0
+ *
+ * @param values - the 4 values to load, double const *
+ *
+ * @return __m256d - the 4 doubles
+ */
+AVX2 static __m256d gather_doubles(void const * const * values)
+{
+	__m256i addresses = _mm256_loadu_si256((__m256i const *) values);
+
+	return _mm256_i64gather_pd((double const *) 0, addresses, 1);
+}
+
+
+/**
+ * @brief - loads 2 doubles, one by one since SSE2 can't gather
+ *
+ * @param values - the 2 values to load, double const *
+ *
+ * @return __m128d - the 2 doubles
+ */
+static __m128d load_doubles(void const * const * values)
+{
+	return _mm_set_pd(DOUBLE_AT(values, 1), DOUBLE_AT(values, 0));
+}
+
+
+/**
+ * @brief - adds the ints of the batch 4 at a time
+ *
+ * @param sum - the sum to add to
+ * @param values - the values of the batch, int const *
+ * @param count - how many values are in the batch
+ *
+ * @return size_t - how many values were added, the remaining ones are less
+ * 	than 4
+ */
+AVX2 static size_t sum_ints_avx2(
+	int64_t * sum,
+	void const * const * values,
+	size_t count)
+{
+	__m256i sums = _mm256_setzero_si256();
+	int64_t lanes[4];
+	size_t index;
+
+	for (index = 0; index + 4 <= count; index += 4)
+	{
+		sums = _mm256_add_epi64(
+			sums,
+			_mm256_cvtepi32_epi64(gather_ints(values + index)));
+	}
+
+	_mm256_storeu_si256((__m256i *) lanes, sums);
+	* sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+	return index;
+}
+
+
+/**
+ * @brief - adds the doubles of the batch 4 at a time
+ *
+ * @param sum - the sum to add to
+ * @param values - the values of the batch, double const *
+ * @param count - how many values are in the batch
+ *
+ * @return size_t - how many values were added, the remaining ones are less
+ * 	than 4
+ */
+AVX2 static size_t sum_doubles_avx2(
+	double * sum,
+	void const * const * values,
+	size_t count)
+{
+	__m256d sums = _mm256_setzero_pd();
+	double lanes[4];
+	size_t index;
+
+	for (index = 0; index + 4 <= count; index += 4)
+		sums = _mm256_add_pd(sums, gather_doubles(values + index));
+
+	_mm256_storeu_pd(lanes, sums);
+	* sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+
+	return index;
+}
+
+
+/**
+ * @brief - adds the doubles of the batch 2 at a time
+ *
+ * @param sum - the sum to add to
+ * @param values - the values of the batch, double const *
+ * @param count - how many values are in the batch
+ *
+ * @return size_t - how many values were added, the remaining one is alone
+ */
+static size_t sum_doubles_sse2(
+	double * sum,
+	void const * const * values,
+	size_t count)
+{
+	__m128d sums = _mm_setzero_pd();
+	double lanes[2];
+	size_t index;
+
+	for (index = 0; index + 2 <= count; index += 2)
+		sums = _mm_add_pd(sums, load_doubles(values + index));
+
+	_mm_storeu_pd(lanes, sums);
+	* sum += lanes[0] + lanes[1];
+
+	return index;
+}
+
+
+/**
+ * @brief - keeps the lowest or greatest int of the batch, 4 at a time
+ *
+ * @param extremum - the minimum or maximum to update
+ * @param values - the values of the batch, int const *
+ * @param count - how many values are in the batch
+ * @param lowest - 1 to keep the minimum, 0 to keep the maximum
+ *
+ * @return size_t - how many values were compared, the remaining ones are
+ * 	less than 4
+ */
+AVX2 static size_t extremum_ints_avx2(
+	int * extremum,
+	void const * const * values,
+	size_t count,
+	int lowest)
+{
+	__m128i extrema = _mm_set1_epi32(* extremum);
+	int lanes[4];
+	size_t index;
+	size_t lane;
+
+	for (index = 0; index + 4 <= count; index += 4)
+	{
+		extrema = lowest
+			? _mm_min_epi32(extrema, gather_ints(values + index))
+			: _mm_max_epi32(extrema, gather_ints(values + index));
+	}
+
+	_mm_storeu_si128((__m128i *) lanes, extrema);
+	for (lane = 0; lane < 4; lane++)
+	{
+		if (lowest ? lanes[lane] < * extremum : lanes[lane] > * extremum)
+			* extremum = lanes[lane];
+	}
+
+	return index;
+}
+
+
+/**
+ * @brief - keeps the lowest or greatest double of the batch, 4 at a time
+ *
+ * @param extremum - the minimum or maximum to update
+ * @param values - the values of the batch, double const *
+ * @param count - how many values are in the batch
+ * @param lowest - 1 to keep the minimum, 0 to keep the maximum
+ *
+ * @return size_t - how many values were compared, the remaining ones are
+ * 	less than 4
+ */
+AVX2 static size_t extremum_doubles_avx2(
+	double * extremum,
+	void const * const * values,
+	size_t count,
+	int lowest)
+{
+	__m256d extrema = _mm256_set1_pd(* extremum);
+	double lanes[4];
+	size_t index;
+	size_t lane;
+
+	for (index = 0; index + 4 <= count; index += 4)
+	{
+		extrema = lowest
+			? _mm256_min_pd(extrema, gather_doubles(values + index))
+			: _mm256_max_pd(extrema, gather_doubles(values + index));
+	}
+
+	_mm256_storeu_pd(lanes, extrema);
+	for (lane = 0; lane < 4; lane++)
+	{
+		if (lowest ? lanes[lane] < * extremum : lanes[lane] > * extremum)
+			* extremum = lanes[lane];
+	}
+
+	return index;
+}
+
+
+/**
+ * @brief - keeps the lowest or greatest double of the batch, 2 at a time
+ *
+ * @param extremum - the minimum or maximum to update
+ * @param values - the values of the batch, double const *
+ * @param count - how many values are in the batch
+ * @param lowest - 1 to keep the minimum, 0 to keep the maximum
+ *
+ * @return size_t - how many values were compared, the remaining one is alone
+ */
+static size_t extremum_doubles_sse2(
+	double * extremum,
+	void const * const * values,
+	size_t count,
+	int lowest)
+{
+	__m128d extrema = _mm_set1_pd(* extremum);
+	double lanes[2];
+	size_t index;
+
+	for (index = 0; index + 2 <= count; index += 2)
+	{
+		extrema = lowest
+			? _mm_min_pd(extrema, load_doubles(values + index))
+			: _mm_max_pd(extrema, load_doubles(values + index));
+	}
+
+	_mm_storeu_pd(lanes, extrema);
+	if (lowest ? lanes[0] < * extremum : lanes[0] > * extremum)
+		* extremum = lanes[0];
+	if (lowest ? lanes[1] < * extremum : lanes[1] > * extremum)
+		* extremum = lanes[1];
+
+	return index;
+}
+
+
+#endif /* LIST_X86_64_KERNELS */
+
+
+
+
+/**
+ * @brief - keeps the lowest or greatest int of the batch, one by one
+ *
+ * @param extremum - the minimum or maximum to update
+ * @param values - the values of the batch, int const *
+ * @param count - how many values are in the batch
+ * @param lowest - 1 to keep the minimum, 0 to keep the maximum
+ */
+static void extremum_ints(
+	int * extremum,
+	void const * const * values,
+	size_t count,
+	int lowest)
+{
+	size_t index;
+
+	for (index = 0; index < count; index++)
+	{
+		if (lowest
+			? INT_AT(values, index) < * extremum
+			: INT_AT(values, index) > * extremum)
+			* extremum = INT_AT(values, index);
+	}
+}
+
+
+/**
+ * @brief - keeps the lowest or greatest double of the batch, one by one
+ *
+ * @param extremum - the minimum or maximum to update
+ * @param values - the values of the batch, double const *
+ * @param count - how many values are in the batch
+ * @param lowest - 1 to keep the minimum, 0 to keep the maximum
+ */
+static void extremum_doubles(
+	double * extremum,
+	void const * const * values,
+	size_t count,
+	int lowest)
+{
+	size_t index;
+
+	for (index = 0; index < count; index++)
+	{
+		if (lowest
+			? DOUBLE_AT(values, index) < * extremum
+			: DOUBLE_AT(values, index) > * extremum)
+			* extremum = DOUBLE_AT(values, index);
+	}
+}
+
+
+/**
+ * @brief - keeps the lowest or greatest int of the batch, with the fastest
+ * 	kernel available
+ *
+ * @param extremum - the minimum or maximum to update
+ * @param values - the values of the batch, int const *
+ * @param count - how many values are in the batch
+ * @param lowest - 1 to keep the minimum, 0 to keep the maximum
+ */
+static void reduce_extremum_ints(
+	int * extremum,
+	void const * const * values,
+	size_t count,
+	int lowest)
+{
+	size_t done = 0;
+
+#ifdef LIST_X86_64_KERNELS
+	if (has_avx2())
+		done = extremum_ints_avx2(extremum, values, count, lowest);
+#endif
+
+	extremum_ints(extremum, values + done, count - done, lowest);
+}
+
+
+/**
+ * @brief - keeps the lowest or greatest double of the batch, with the fastest
+ * 	kernel available
+ *
+ * @param extremum - the minimum or maximum to update
+ * @param values - the values of the batch, double const *
+ * @param count - how many values are in the batch
+ * @param lowest - 1 to keep the minimum, 0 to keep the maximum
+ */
+static void reduce_extremum_doubles(
+	double * extremum,
+	void const * const * values,
+	size_t count,
+	int lowest)
+{
+	size_t done = 0;
+
+#ifdef LIST_X86_64_KERNELS
+	if (has_avx2())
+		done = extremum_doubles_avx2(extremum, values, count, lowest);
+	else
+		done = extremum_doubles_sse2(extremum, values, count, lowest);
+#endif
+
+	extremum_doubles(extremum, values + done, count - done, lowest);
+}
+
+
+
+
+void list_sum_ints(
+	void * accumulator,
+	void const * const * values,
+	size_t count)
+{
+	int64_t * sum = accumulator;
+	size_t index = 0;
+
+#ifdef LIST_X86_64_KERNELS
+	if (has_avx2())
+		index = sum_ints_avx2(sum, values, count);
+#endif
+
+	for (; index < count; index++)
+		* sum += INT_AT(values, index);
+}
+
+
+void list_sum_doubles(
+	void * accumulator,
+	void const * const * values,
+	size_t count)
+{
+	double * sum = accumulator;
+	size_t index = 0;
+
+#ifdef LIST_X86_64_KERNELS
+	if (has_avx2())
+		index = sum_doubles_avx2(sum, values, count);
+	else
+		index = sum_doubles_sse2(sum, values, count);
+#endif
+
+	for (; index < count; index++)
+		* sum += DOUBLE_AT(values, index);
+}
+
+
+void list_min_ints(
+	void * accumulator,
+	void const * const * values,
+	size_t count)
+{
+	reduce_extremum_ints(accumulator, values, count, 1);
+}
+
+
+void list_max_ints(
+	void * accumulator,
+	void const * const * values,
+	size_t count)
+{
+	reduce_extremum_ints(accumulator, values, count, 0);
+}
+
+
+void list_min_doubles(
+	void * accumulator,
+	void const * const * values,
+	size_t count)
+{
+	reduce_extremum_doubles(accumulator, values, count, 1);
+}
+
+
+void list_max_doubles(
+	void * accumulator,
+	void const * const * values,
+	size_t count)
+{
+	reduce_extremum_doubles(accumulator, values, count, 0);
+}
@@ -0,0 +1,447 @@
+
+#define _POSIX_C_SOURCE 200112L /* pthread_rwlock_t */
+
+#include <string.h>
+
+#include "../include/List.h"
+#include "../include/ListNode.h"
+#include "ListPrivate.h"
+
+
+/**
+ * @brief - marks the empty entries of the slots table of a position index
+ */
+#define LIST_NO_SLOT ((size_t) -1)
+
+
+/**
+ * @brief - an order-statistics index giving the position of a node and the
+ * 	node at a position in O(log n): every node owns a slot, slots follow the
+ * 	list order and a Fenwick tree counts the occupied ones
+ * 	Appends and prepends take the slot next to the tail or head one, removals
+ * 	leave a hole, the slots are renumbered when they run out
+ * 	The slot of a node is found through an open addressing table, keyed by
+ * 	the address of the node, so nodes don't have to store it
+ */
+typedef struct position_index
+{
+	/**
+	 * @brief - the node owning each slot, NULL for holes
+	 */
+	linked_list ** nodes;
+
+	/**
+	 * @brief - the slot of each indexed node, found by linear probing from
+	 * 	the hash of its address, LIST_NO_SLOT for empty entries
+	 */
+	size_t * slots;
+
+	/**
+	 * @brief - how many entries the slots table has, a power of 2 greater
+	 * 	than 1.5 times the number of slots
+	 */
+	size_t slots_capacity;
+
+	/**
+	 * @brief - the Fenwick tree of occupied slots, 1-based, capacity + 1 items
+	 */
+	size_t * counts;
+
+	/**
+	 * @brief - how many slots there are
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief - 1 if the slots no longer follow the list, they are renumbered
+	 * 	by the next query
+	 */
+	int stale;
+} position_index;
+
+
+
+
+/**
+ * @brief - isolates the lowest set bit, to move through a Fenwick tree
+ *
+ * @param number - the number to isolate the lowest set bit of
+ *
+ * @return size_t - the lowest set bit of the number, 0 if none
+ */
+static size_t lowest_bit(size_t number)
+{
+	return number & (~number + 1);
+}
+
+
+/**
+ * @brief - finds the entry of the slots table holding the slot of the node
+ *
+ * @param index - the index to search
+ * @param node - the node to find
+ *
+ * @return size_t - the entry holding the slot of the node, LIST_NO_SLOT if the
+ * 	node isn't indexed
+ */
+static size_t find_slot_entry(
+	position_index const * index,
+	linked_list const * node)
+{
+	size_t mask = index->slots_capacity - 1;
+	size_t entry = list_spread_hash((size_t) node) & mask;
+
+	/* the table is never full, so an empty entry ends every probe */
+	for (; index->slots[entry] != LIST_NO_SLOT; entry = (entry + 1) & mask)
+	{
+		if (index->nodes[index->slots[entry]] == node)
+			return entry;
+	}
+
+	return LIST_NO_SLOT;
+}
+
+
+/**
+ * @brief - empties an entry of the slots table, shifting back the entries
+ * 	probed past it so no probe sequence is cut
+ *
+ * @param index - the index to update
+ * @param entry - the entry to empty
+ */
+static void remove_slot_entry(position_index * index, size_t entry)
+{
+	size_t mask = index->slots_capacity - 1;
+	size_t next;
+	size_t home;
+
+	for (next = (entry + 1) & mask;
+		index->slots[next] != LIST_NO_SLOT;
+		next = (next + 1) & mask)
+	{
+		home = list_spread_hash((size_t) index->nodes[index->slots[next]]) & mask;
+
+		/* the next entry can't move before its home */
+		if (((next - home) & mask) >= ((next - entry) & mask))
+		{
+			index->slots[entry] = index->slots[next];
+			entry = next;
+		}
+	}
+
+	index->slots[entry] = LIST_NO_SLOT;
+}
+
+
+/**
+ * @brief - binds the node and its slot, without counting the slot as taken
+ *
+ * @param index - the index to update
+ * @param node - the node taking the slot, not indexed yet
+ * @param slot - the slot to take, must be free
+ */
+static void record_slot(position_index * index, linked_list * node, size_t slot)
+{
+	size_t mask = index->slots_capacity - 1;
+	size_t entry = list_spread_hash((size_t) node) & mask;
+
+	while (index->slots[entry] != LIST_NO_SLOT)
+		entry = (entry + 1) & mask;
+
+	index->slots[entry] = slot;
+	index->nodes[slot] = node;
+}
+
+
+/**
+ * @brief - gives a slot of the position index to the node
+ *
+ * @param index - the index to update
+ * @param node - the node taking the slot
+ * @param slot - the slot to take, must be free
+ */
+static void index_node(position_index * index, linked_list * node, size_t slot)
+{
+	record_slot(index, node, slot);
+
+	for (slot++; slot <= index->capacity; slot += lowest_bit(slot))
+		index->counts[slot]++;
+}
+
+
+/**
+ * @brief - frees the slot of the node in the position index
+ *
+ * @param index - the index to update
+ * @param node - the node leaving its slot
+ *
+ * @return int - 1 if the node left its slot, 0 if it wasn't indexed
+ */
+static int unindex_node(position_index * index, linked_list const * node)
+{
+	size_t entry = find_slot_entry(index, node);
+	size_t slot;
+
+	if (entry == LIST_NO_SLOT)
+		return 0;
+
+	slot = index->slots[entry];
+	remove_slot_entry(index, entry);
+	index->nodes[slot] = NULL;
+
+	for (slot++; slot <= index->capacity; slot += lowest_bit(slot))
+		index->counts[slot]--;
+
+	return 1;
+}
+
+
+int list_index_position(
+	header const * header,
+	linked_list const * node,
+	size_t * position)
+{
+	position_index const * index = header->index;
+	size_t count = 0;
+	size_t entry;
+	size_t slot;
+
+	if (index->stale)
+		return 0;
+
+	entry = find_slot_entry(index, node);
+	if (entry == LIST_NO_SLOT)
+		return 0;
+
+	for (slot = index->slots[entry] + 1; slot > 0; slot -= lowest_bit(slot))
+		count += index->counts[slot];
+
+	* position = count - 1;
+	return 1;
+}
+
+
+linked_list * list_index_node_at(header const * header, size_t position)
+{
+	position_index const * index = header->index;
+	size_t remaining = position + 1;
+	size_t slot = 0;
+	size_t step = 1;
+
+	while (step <= index->capacity / 2)
+		step *= 2;
+
+	for (; step > 0; step /= 2)
+	{
+		if (slot + step <= index->capacity
+			&& index->counts[slot + step] < remaining)
+		{
+			slot += step;
+			remaining -= index->counts[slot];
+		}
+	}
+
+	return index->nodes[slot];
+}
+
+
+void list_unindex_node(header * header, linked_list const * node)
+{
+	if (! header->index->stale && ! unindex_node(header->index, node))
+		header->index->stale = 1;
+}
+
+
+void list_forget_index(header * header)
+{
+	header->index->stale = 1;
+}
+
+
+/**
+ * @brief - releases the slots of the position index, before they are
+ * 	renumbered or the index is released
+ *
+ * @param header - the header of the list, whose index is enabled
+ */
+static void release_slots(header * header)
+{
+	list_release(& header->allocator, header->index->nodes);
+	list_release(& header->allocator, header->index->counts);
+	list_release(& header->allocator, header->index->slots);
+}
+
+
+void list_release_index(header * header)
+{
+	if (header->index == NULL)
+		return;
+
+	release_slots(header);
+	list_release(& header->allocator, header->index);
+	header->index = NULL;
+}
+
+
+/**
+ * @brief - renumbers every node of the list in the middle of new slots, so
+ * 	as many nodes can be appended and prepended before running out of them
+ *
+ * @param header - the header of the list to index, whose index is enabled
+ *
+ * @return int - 1 if the index is up to date, 0 if allocation failed
+ */
+static int rebuild_index(header * header)
+{
+	position_index * index = header->index;
+	linked_list * node;
+	linked_list ** nodes;
+	size_t * counts;
+	size_t * slots;
+	size_t capacity;
+	size_t slots_capacity = 1;
+	size_t size = list_size_of(header);
+	size_t parent;
+	size_t slot;
+
+	if (size > (size_t) -1 / (16 * sizeof(* counts)))
+		return 0;
+
+	capacity = size * 2 + 16;
+	while (slots_capacity < capacity + capacity / 2)
+		slots_capacity *= 2;
+
+	nodes = list_allocate(& header->allocator, capacity * sizeof(* nodes));
+	counts = list_allocate(& header->allocator, (capacity + 1) * sizeof(* counts));
+	slots = list_allocate(& header->allocator, slots_capacity * sizeof(* slots));
+	if (nodes == NULL || counts == NULL || slots == NULL)
+	{
+		list_release(& header->allocator, nodes);
+		list_release(& header->allocator, counts);
+		list_release(& header->allocator, slots);
+		return 0;
+	}
+
+	memset(nodes, 0, capacity * sizeof(* nodes));
+	memset(counts, 0, (capacity + 1) * sizeof(* counts));
+	memset(slots, 0xFF, slots_capacity * sizeof(* slots));
+
+	release_slots(header);
+	index->nodes = nodes;
+	index->counts = counts;
+	index->slots = slots;
+	index->capacity = capacity;
+	index->slots_capacity = slots_capacity;
+	index->stale = 0;
+
+	slot = (capacity - size) / 2;
+	for (node = header->first_node; node != NULL; node = node->next, slot++)
+	{
+		record_slot(index, node, slot);
+		counts[slot + 1] = 1;
+	}
+
+	/* builds the Fenwick tree in place, in linear time */
+	for (slot = 1; slot <= capacity; slot++)
+	{
+		parent = slot + lowest_bit(slot);
+		if (parent <= capacity)
+			counts[parent] += counts[slot];
+	}
+
+	return 1;
+}
+
+
+int list_has_fresh_index(header * header)
+{
+	if (header->index == NULL)
+		return 0;
+
+	return ! header->index->stale || rebuild_index(header);
+}
+
+
+void list_index_chain(
+	header * header,
+	linked_list const * before,
+	linked_list const * after,
+	linked_list * first,
+	size_t count)
+{
+	position_index * index = header->index;
+	size_t around = 0;
+	size_t entry;
+	size_t slot;
+
+	if (index->stale)
+		return;
+
+	if ((before == NULL) != (after == NULL))
+	{
+		entry = find_slot_entry(index, (before != NULL) ? before : after);
+		if (entry == LIST_NO_SLOT)
+		{
+			index->stale = 1;
+			return;
+		}
+		around = index->slots[entry];
+	}
+
+	if (before == NULL && after == NULL && count <= index->capacity)
+		slot = (index->capacity - count) / 2;
+	else if (after == NULL && before != NULL
+		&& index->capacity - around > count)
+		slot = around + 1;
+	else if (before == NULL && after != NULL && around >= count)
+		slot = around - count;
+	else
+	{
+		index->stale = 1;
+		return;
+	}
+
+	for (; count > 0; count--, first = first->next)
+		index_node(index, first, slot++);
+}
+
+
+
+
+int list_enable_position_index(linked_list * list)
+{
+	header * header;
+
+	if (list == NULL)
+		return 0;
+
+	header = list_header_of(list);
+	if (header->index != NULL)
+		return 1;
+
+	if (list_is_shared(header))
+		return 0;
+
+	header->index = list_allocate(& header->allocator, sizeof(position_index));
+	if (header->index == NULL)
+		return 0;
+
+	memset(header->index, 0, sizeof(position_index));
+	if (! rebuild_index(header))
+	{
+		list_release(& header->allocator, header->index);
+		header->index = NULL;
+		return 0;
+	}
+
+	return 1;
+}
+
+
+void list_disable_position_index(linked_list * list)
+{
+	if (list == NULL)
+		return;
+
+	list_release_index(list_header_of(list));
+}
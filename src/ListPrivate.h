@@ -0,0 +1,791 @@
+
+#ifndef LIST_PRIVATE_HEADER
+#define LIST_PRIVATE_HEADER
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "../include/List.h"
+#include "../include/ListNode.h"
+
+
+
+
+/**
+ * @brief - hints the CPU to load the memory at the given address into the
+ * 	cache, does nothing on compilers without the builtin
+ */
+#ifdef __GNUC__
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void) (address))
+#endif
+
+
+/**
+ * @brief - reads and writes links that readers walking a synchronized list
+ * 	without locking may follow, a node is fully set up before being linked
+ */
+#define LOAD_LINK(link) __atomic_load_n(& (link), __ATOMIC_ACQUIRE)
+#define STORE_LINK(link, node) \
+	__atomic_store_n(& (link), node, __ATOMIC_RELEASE)
+
+
+
+
+typedef struct list_header header;
+
+
+/**
+ * @brief - data shared by every node of a same list, the state of optional
+ * 	features is defined along their functions, and only allocated once they
+ * 	are used
+ */
+struct list_header
+{
+	/**
+	 * @brief - the first node of the list
+	 */
+	linked_list * first_node;
+
+	/**
+	 * @brief - the last node of the list
+	 */
+	linked_list * last_node;
+
+	/**
+	 * @brief - the whole size of the list, from first to last node, unless
+	 * 	it is stale
+	 */
+	size_t size;
+
+	/**
+	 * @brief - 1 if nodes moved to or from another list without being
+	 * 	counted, the size is then counted again when next asked for
+	 */
+	int stale_size;
+
+	/**
+	 * @brief - the header of the list this one was concatenated to, or binds
+	 * 	new nodes for, NULL if none: nodes still bound to this header belong
+	 * 	to that list, unless it gave nodes away since
+	 */
+	header * forward;
+
+	/**
+	 * @brief - when the header started leading to its forward one, on the
+	 * 	clock of moves between lists
+	 */
+	size_t joined_at;
+
+	/**
+	 * @brief - the headers concatenated to this one, chained by their next
+	 * 	absorbed header, kept until this one is deleted, or its family, since
+	 * 	nodes may still be bound to them
+	 */
+	header * absorbed;
+
+	/**
+	 * @brief - the next header concatenated to the same one
+	 */
+	header * next_absorbed;
+
+	/**
+	 * @brief - the header nodes of the list are bound to, NULL for this one,
+	 * 	replaced each time the list gives nodes to another one
+	 */
+	header * binding;
+
+	/**
+	 * @brief - when the list last gave nodes to another one, 0 if never:
+	 * 	nodes bound to it, or to headers leading to it since earlier, may have
+	 * 	left it
+	 */
+	size_t scattered_at;
+
+	/**
+	 * @brief - the lists this one exchanged nodes with, NULL if none
+	 */
+	struct list_family * family;
+
+	/**
+	 * @brief - the memory functions the header and the nodes come from
+	 */
+	list_allocator allocator;
+
+	/**
+	 * @brief - the storage nodes are taken from, NULL until the list is
+	 * 	pooled or creates nodes in batches
+	 */
+	struct node_pool * pool;
+
+	/**
+	 * @brief - every store nodes of the list may come from, its own one and
+	 * 	the ones of lists it took nodes from, each of them referenced once
+	 */
+	struct store_reference * stores;
+
+	/**
+	 * @brief - 1 if nodes were allocated one by one, outside of chunks, so
+	 * 	deleting the list has to walk them, 0 otherwise
+	 */
+	int has_loose_nodes;
+
+	/**
+	 * @brief - nodes to split the list at for parallel operations, NULL
+	 * 	until the first one is recorded
+	 */
+	struct node_milestones * milestones;
+
+	/**
+	 * @brief - the positions of the nodes, NULL unless enabled
+	 */
+	struct position_index * index;
+
+	/**
+	 * @brief - the nodes holding each key, NULL unless enabled
+	 */
+	struct value_index * keys;
+
+	/**
+	 * @brief - the values snapshots are taken from, NULL unless enabled
+	 */
+	struct snapshot_tree * snapshots;
+
+	/**
+	 * @brief - the chains nodes are added to, NULL if the list isn't
+	 * 	concurrent
+	 */
+	struct concurrent_chains * concurrent;
+
+	/**
+	 * @brief - the lock readers share and writers take alone, NULL if the
+	 * 	list isn't synchronized
+	 */
+	pthread_rwlock_t * lock;
+
+	/**
+	 * @brief - the epochs deferring the release of removed nodes, NULL if
+	 * 	the list isn't synchronized
+	 */
+	struct epoch_reclamation * reclamation;
+
+	/**
+	 * @brief - the node handed out by creation functions of configured
+	 * 	lists, so the configuration survives until the first node is added,
+	 * 	it never holds a value and isn't part of the list, but its next link
+	 * 	leads to the first node
+	 */
+	linked_list anchor;
+};
+
+
+
+
+/* functions shared by the translation units of lists, kept out of the API */
+#ifdef __GNUC__
+#pragma GCC visibility push(hidden)
+#endif
+
+
+/**
+ * @brief - the allocator of lists which didn't specify one, backed by malloc
+ */
+extern list_allocator const list_default_allocator;
+
+
+/**
+ * @brief - allocates memory for the list
+ *
+ * @param allocator - the allocator of the list
+ * @param size - the size of the memory to allocate
+ *
+ * @return void * - the allocated memory, NULL if allocation failed
+ */
+void * list_allocate(list_allocator const * allocator, size_t size);
+
+
+/**
+ * @brief - releases memory of the list, does nothing if the allocator drops
+ * 	its memory at once
+ *
+ * @param allocator - the allocator the memory comes from
+ * @param memory - the memory to release, nothing happens if NULL
+ */
+void list_release(list_allocator const * allocator, void * memory);
+
+
+/**
+ * @brief - creates a blank header
+ *
+ * @param allocator - the allocator of the list, copied into the header
+ *
+ * @return header * - the created header, NULL if allocation failed
+ */
+header * list_create_blank_header(list_allocator const * allocator);
+
+
+/**
+ * @brief - creates a blank header whose anchor is ready to be handed out
+ *
+ * @param allocator - the allocator of the list, copied into the header
+ *
+ * @return header * - the created header, NULL if allocation failed
+ */
+header * list_create_anchored_header(list_allocator const * allocator);
+
+
+/**
+ * @brief - deletes the header and sets it to NULL, nodes taken from its pool
+ * 	are released along, the header itself is kept with its family if the
+ * 	list exchanged nodes with others, until they are all deleted
+ *
+ * @param header - the header to delete
+ */
+void list_delete_header(header ** header);
+
+
+/**
+ * @brief - binds the node to the list of a header, recording where it was
+ * 	allocated
+ *
+ * @param node - the node to bind
+ * @param header - the header of the list to bind the node to
+ * @param is_chunk - 1 if the node lives in a chunk, 0 otherwise
+ */
+void list_bind_node(linked_list * node, header * header, int is_chunk);
+
+
+/**
+ * @brief - finds the header of the list the node belongs to, following the
+ * 	headers concatenated to others, which then lead straight to the last one
+ * 	as well as the node, so later lookups are immediate
+ * 	Nodes bound to a list which gave nodes away since can't tell if they
+ * 	left it, they walk to the closest node that can, the ends of a list
+ * 	always being bound to it, and the walked nodes are bound again
+ *
+ * @param node - the node to find the header of, in a list
+ *
+ * @return header * - the header of the list
+ */
+header * list_header_of(linked_list const * node);
+
+
+/**
+ * @brief - checks if the node is the anchor of an empty configured list
+ *
+ * @param list - the node to check
+ *
+ * @return int - 1 if the node is an anchor, 0 otherwise
+ */
+int list_is_anchor(linked_list const * list);
+
+
+/**
+ * @brief - checks if the list is shared between threads, its handle then
+ * 	stays the anchor and its header lives until the list is deleted
+ *
+ * @param header - the header of the list to check
+ *
+ * @return int - 1 if the list is synchronized or concurrent, 0 otherwise
+ */
+int list_is_shared(header const * header);
+
+
+/**
+ * @brief - creates a node bound to the given header, without updating it
+ *
+ * @param value - the value to store in the node
+ * @param header - the header the node will belong to
+ *
+ * @return linked_list * - the created node, NULL if allocation failed
+ */
+linked_list * list_create_node(void * value, header * header);
+
+
+/**
+ * @brief - checks if the node is a hook, embedded in a user structure
+ *
+ * @param node - the node to check
+ *
+ * @return int - 1 if the node is a hook, 0 otherwise
+ */
+int list_is_hook(linked_list const * node);
+
+
+/**
+ * @brief - gives the node back to the storage it was taken from, hooks are
+ * 	left untouched since they belong to the user
+ *
+ * @param header - the header of the list the node was removed from
+ * @param node - the node to release, must be unlinked
+ */
+void list_release_node(header * header, linked_list * node);
+
+
+/**
+ * @brief - deletes the current node and every next ones,
+ * 	doesn't check for NULL argument
+ *
+ * @param header - the header of the list
+ * @param list - the list to delete, from given node to the end
+ */
+void list_delete_forward(header * header, linked_list ** list);
+
+
+/**
+ * @brief - gives the size of the list, counting its nodes again if some of
+ * 	them moved to or from another list since it was last known
+ *
+ * @param header - the header of the list
+ *
+ * @return size_t - how many nodes the list holds
+ */
+size_t list_size_of(header * header);
+
+
+/**
+ * @brief - takes room in the pool for the given number of nodes at once, so
+ * 	they are taken from a single chunk, does nothing for shared lists and
+ * 	lists whose batches aren't carved out of chunks, nor if allocation fails
+ *
+ * @param header - the header of the list
+ * @param count - how many nodes are about to be inserted
+ */
+void list_reserve_nodes(header * header, size_t count);
+
+
+/**
+ * @brief - sets the first node of the list, the anchor leads to it so the
+ * 	list can be walked from the anchor, and the node is bound to the list
+ *
+ * @param header - the header of the list
+ * @param node - the first node, NULL if the list is empty
+ */
+void list_set_first_node(header * header, linked_list * node);
+
+
+/**
+ * @brief - sets the last node of the list, loaded by readers of synchronized
+ * 	lists without locking, and binds the node to the list
+ *
+ * @param header - the header of the list
+ * @param node - the last node, NULL if the list is empty
+ */
+void list_set_last_node(header * header, linked_list * node);
+
+
+/**
+ * @brief - link 2 nodes
+ *
+ * @param before - the previous node
+ * @param after - the next node
+ */
+void list_link_nodes(linked_list * before, linked_list * after);
+
+
+/**
+ * @brief - forgets where nodes stand in the list, after they were moved
+ * 	around: milestones get broken, the position index gets renumbered, the
+ * 	value index rebuilt when next queried and the snapshot tree by the next
+ * 	snapshot
+ *
+ * @param header - the header of the list
+ */
+void list_forget_positions(header * header);
+
+
+/**
+ * @brief - mixes the bits of a hash, so buckets picked from its lowest bits
+ * 	depend on all of them, aligned addresses included
+ *
+ * @param hash - the hash to mix
+ *
+ * @return size_t - the mixed hash
+ */
+size_t list_spread_hash(size_t hash);
+
+
+
+
+/**
+ * @brief - takes the lock of a synchronized list along with other readers,
+ * 	does nothing for other lists
+ *
+ * @param header - the header of the list to read
+ */
+void list_lock_for_reading(header const * header);
+
+
+/**
+ * @brief - takes the lock of a synchronized list alone, does nothing for
+ * 	other lists
+ *
+ * @param header - the header of the list to write
+ */
+void list_lock_for_writing(header const * header);
+
+
+/**
+ * @brief - releases the lock of a synchronized list, does nothing for other
+ * 	lists
+ *
+ * @param header - the header of the list read or written
+ */
+void list_unlock(header const * header);
+
+
+/**
+ * @brief - registers a reader in the current epoch of a synchronized list,
+ * 	does nothing for other lists
+ * 	A reader who saw an epoch about to end steps back and tries again, so
+ * 	writers never release nodes it could reach
+ *
+ * @param header - the header of the list to read
+ *
+ * @return size_t - the epoch the reader entered, to leave it afterwards
+ */
+size_t list_enter_epoch_of(header const * header);
+
+
+/**
+ * @brief - unregisters a reader from the epoch it entered, does nothing for
+ * 	lists which aren't synchronized
+ *
+ * @param header - the header of the list read
+ * @param epoch - the epoch the reader entered
+ */
+void list_leave_epoch_of(header const * header, size_t epoch);
+
+
+/**
+ * @brief - makes room to retire nodes of a synchronized list in both epochs,
+ * 	growing the retired nodes with the lock released, so a writer never
+ * 	waits on readers, who may be waiting on it, does nothing for other lists
+ * 	The list may change while the lock is released
+ *
+ * @param header - the header of the list, locked for writing
+ * @param count - how many nodes may be retired, read again each time the lock
+ * 	is taken back
+ *
+ * @return int - 1 if the nodes can be retired, 0 if allocation failed, the
+ * 	lock is held either way
+ */
+int list_reserve_retired(header * header, size_t const * count);
+
+
+/**
+ * @brief - retires a removed node of a synchronized list in the current
+ * 	epoch, so it's released and its value destroyed once no reader can
+ * 	reach it anymore, other lists release it right away
+ * 	Room for it must have been made with list_reserve_retired
+ *
+ * @param header - the header of the list the node was removed from
+ * @param node - the removed node, its links are left as is
+ * @param destructor - called on the value of the node, if not NULL
+ * @param context - given to the destructor
+ */
+void list_retire_node(
+	header * header,
+	linked_list * node,
+	void (* destructor)(void * value, void * context),
+	void * context);
+
+
+/**
+ * @brief - adds a node at one end of a concurrent list, without locking,
+ * 	safe to call from any number of threads
+ *
+ * @param header - the header of the concurrent list
+ * @param node - the node to add, bound to the header
+ * @param at_end - 1 to append the node, 0 to prepend it
+ */
+void list_push_concurrently(header * header, linked_list * node, int at_end);
+
+
+/**
+ * @brief - creates a node and adds it at one end of a concurrent list
+ *
+ * @param header - the header of the concurrent list
+ * @param value - the value to store in the node
+ * @param at_end - 1 to append the node, 0 to prepend it
+ */
+void list_add_concurrently(header * header, void * value, int at_end);
+
+
+/**
+ * @brief - releases every node added to a concurrent list so far
+ *
+ * @param header - the header of the concurrent list
+ */
+void list_release_concurrent_nodes(header * header);
+
+
+/**
+ * @brief - releases the nodes retired by a synchronized list, then its lock
+ * 	and epochs, or the chains of a concurrent list, does nothing for other
+ * 	lists
+ *
+ * @param header - the header of the list being deleted
+ */
+void list_release_concurrency(header * header);
+
+
+
+
+/**
+ * @brief - checks if the position index can answer queries, renumbering the
+ * 	nodes first if the slots no longer follow the list
+ *
+ * @param header - the header of the list to check
+ *
+ * @return int - 1 if the index is enabled and up to date, 0 otherwise
+ */
+int list_has_fresh_index(header * header);
+
+
+/**
+ * @brief - counts the nodes before the given one thanks to the position index
+ *
+ * @param header - the header of the list, whose index is enabled
+ * @param node - the node to get the position of
+ * @param position - set to the position of the node, 0 for the head
+ *
+ * @return int - 1 if the position was found, 0 if the index is stale or the
+ * 	node isn't indexed
+ */
+int list_index_position(
+	header const * header,
+	linked_list const * node,
+	size_t * position);
+
+
+/**
+ * @brief - finds the node at the given position thanks to the position index
+ *
+ * @param header - the header of the list, whose index is up to date
+ * @param position - the position of the node, lower than the size of the list
+ *
+ * @return linked_list * - the node at this position
+ */
+linked_list * list_index_node_at(header const * header, size_t position);
+
+
+/**
+ * @brief - gives slots to a chain of nodes inserted between 2 adjacent nodes,
+ * 	the index gets stale if the slots around are taken or if the chain is
+ * 	inserted in the middle of the list
+ *
+ * @param header - the header of the list, before it's updated, whose index is
+ * 	enabled
+ * @param before - the node the chain is inserted after, NULL if none
+ * @param after - the node the chain is inserted before, NULL if none
+ * @param first - the first node of the chain
+ * @param count - how many nodes are in the chain
+ */
+void list_index_chain(
+	header * header,
+	linked_list const * before,
+	linked_list const * after,
+	linked_list * first,
+	size_t count);
+
+
+/**
+ * @brief - frees the slot of a removed node, the index gets stale if the
+ * 	node wasn't indexed
+ *
+ * @param header - the header of the list, whose index is enabled
+ * @param node - the node leaving its slot
+ */
+void list_unindex_node(header * header, linked_list const * node);
+
+
+/**
+ * @brief - makes the position index stale, the nodes are renumbered by the
+ * 	next query
+ *
+ * @param header - the header of the list, whose index is enabled
+ */
+void list_forget_index(header * header);
+
+
+/**
+ * @brief - releases the position index of the list, which no longer
+ * 	maintains it, does nothing if it isn't enabled
+ *
+ * @param header - the header of the list
+ */
+void list_release_index(header * header);
+
+
+
+
+/**
+ * @brief - adds a node inserted at one end of the list to the value index,
+ * 	the index gets stale if entries run out
+ *
+ * @param header - the header of the list, whose value index is enabled
+ * @param node - the inserted node
+ * @param at_end - 1 if the node was appended, 0 if it was prepended
+ */
+void list_index_value(header * header, linked_list * node, int at_end);
+
+
+/**
+ * @brief - adds a chain of nodes inserted between 2 adjacent nodes to the
+ * 	value index, the index gets stale if the chain is inserted in the middle
+ * 	of the list, since buckets have to follow the list order
+ *
+ * @param header - the header of the list, whose value index is enabled
+ * @param before - the node the chain is inserted after, NULL if none
+ * @param after - the node the chain is inserted before, NULL if none
+ * @param first - the first node of the chain
+ * @param last - the last node of the chain
+ */
+void list_index_chain_values(
+	header * header,
+	linked_list const * before,
+	linked_list const * after,
+	linked_list * first,
+	linked_list * last);
+
+
+/**
+ * @brief - unchains the entry of a removed node from the value index
+ *
+ * @param header - the header of the list, whose value index is enabled
+ * @param node - the node leaving the index, still holding its value
+ */
+void list_unindex_value(header * header, linked_list const * node);
+
+
+/**
+ * @brief - makes the value index stale, it's rebuilt by the next lookup
+ *
+ * @param header - the header of the list, whose value index is enabled
+ */
+void list_forget_value_index(header * header);
+
+
+/**
+ * @brief - releases the value index of the list, which no longer maintains
+ * 	it, does nothing if it isn't enabled
+ *
+ * @param header - the header of the list
+ */
+void list_release_value_index(header * header);
+
+
+
+
+/**
+ * @brief - adds the value of a node inserted at one end of the list to the
+ * 	snapshot tree, the tree gets stale if allocation fails
+ *
+ * @param header - the header of the list, whose snapshots are enabled
+ * @param node - the inserted node
+ * @param at_end - 1 if the node was appended, 0 if it was prepended
+ */
+void list_snapshot_value(header * header, linked_list * node, int at_end);
+
+
+/**
+ * @brief - adds the values of a chain of nodes inserted between 2 adjacent
+ * 	nodes to the snapshot tree, the tree gets stale if the chain is inserted
+ * 	in the middle of the list, since its position isn't known
+ *
+ * @param header - the header of the list, whose snapshots are enabled
+ * @param before - the node the chain is inserted after, NULL if none
+ * @param after - the node the chain is inserted before, NULL if none
+ * @param first - the first node of the chain
+ * @param last - the last node of the chain
+ */
+void list_snapshot_chain(
+	header * header,
+	linked_list const * before,
+	linked_list const * after,
+	linked_list * first,
+	linked_list const * last);
+
+
+/**
+ * @brief - removes the value of a node from the snapshot tree, finding its
+ * 	position with the position index, the tree gets stale if the list has no
+ * 	up to date position index
+ *
+ * @param header - the header of the list, whose snapshots are enabled
+ * @param node - the removed node, still in the position index
+ */
+void list_unsnapshot_value(header * header, linked_list const * node);
+
+
+/**
+ * @brief - makes the snapshot tree stale, it's rebuilt by the next snapshot
+ *
+ * @param header - the header of the list, whose snapshots are enabled
+ */
+void list_forget_snapshots(header * header);
+
+
+/**
+ * @brief - releases the snapshot tree of the list, which no longer maintains
+ * 	it, views keep the nodes they lead to, does nothing if it isn't enabled
+ *
+ * @param header - the header of the list
+ */
+void list_release_snapshots(header * header);
+
+
+
+
+/**
+ * @brief - records the node as milestone if the list reached a multiple of
+ * 	LIST_MILESTONES_STRIDE with it, once appended, unless the size of the
+ * 	list is stale
+ *
+ * @param header - the header of the list, already updated
+ * @param node - the node appended last
+ */
+void list_record_milestone_if_due(header * header, linked_list * node);
+
+
+/**
+ * @brief - records the milestones of a chain of nodes appended at once
+ *
+ * @param header - the header of the list, already updated
+ * @param first - the first appended node
+ * @param previous_size - the size of the list before the chain was appended
+ */
+void list_record_chain_milestones(
+	header * header,
+	linked_list * first,
+	size_t previous_size);
+
+
+/**
+ * @brief - breaks the milestones of the list, recorded nodes may be gone
+ * 	until they are rebuilt
+ *
+ * @param header - the header of the list, which recorded milestones
+ */
+void list_forget_milestones(header * header);
+
+
+/**
+ * @brief - releases the milestones of the list, does nothing if none was
+ * 	recorded
+ *
+ * @param header - the header of the list
+ */
+void list_release_milestones(header * header);
+
+
+#ifdef __GNUC__
+#pragma GCC visibility pop
+#endif
+
+
+
+
+#endif /* LIST_PRIVATE_HEADER */
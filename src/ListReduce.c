@@ -0,0 +1,513 @@
+
+#define _POSIX_C_SOURCE 200112L /* pthread_rwlock_t */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/List.h"
+#include "../include/ListNode.h"
+#include "ListPrivate.h"
+
+
+/**
+ * @brief - how many appended nodes separate 2 milestones
+ */
+#define LIST_MILESTONES_STRIDE 1024
+
+
+/**
+ * @brief - nodes recorded every LIST_MILESTONES_STRIDE appends, in list order,
+ * 	so the list can be split in balanced ranges without walking it
+ */
+typedef struct node_milestones
+{
+	/**
+	 * @brief - the recorded nodes, from the head to the tail
+	 */
+	linked_list ** nodes;
+
+	/**
+	 * @brief - how many nodes are recorded
+	 */
+	size_t count;
+
+	/**
+	 * @brief - how many nodes can be recorded before growing
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief - 1 if a node was removed since recording, recorded nodes may be
+	 * 	gone until the milestones are rebuilt
+	 */
+	int broken;
+} node_milestones;
+
+
+/**
+ * @brief - a range of nodes reduced by a single thread
+ */
+typedef struct reduction_range
+{
+	/**
+	 * @brief - the first node of the range
+	 */
+	linked_list const * first;
+
+	/**
+	 * @brief - the node right after the range, NULL if the range ends the list
+	 */
+	linked_list const * end;
+
+	/**
+	 * @brief - the accumulator of the range
+	 */
+	void * accumulator;
+
+	/**
+	 * @brief - the callback to apply on every node of the range
+	 */
+	void (* reducer)(void * accumulator, void const * node_content);
+
+	/**
+	 * @brief - the thread reducing the range
+	 */
+	pthread_t thread;
+
+	/**
+	 * @brief - 1 if the range is reduced by its own thread, 0 otherwise
+	 */
+	int threaded;
+} reduction_range;
+
+
+
+
+/**
+ * @brief - gives the milestones of the list, created along the first one
+ *
+ * @param header - the header of the list
+ *
+ * @return node_milestones * - the milestones, NULL if allocation failed
+ */
+static node_milestones * milestones_of(header * header)
+{
+	if (header->milestones == NULL)
+	{
+		header->milestones = list_allocate(
+			& header->allocator,
+			sizeof(node_milestones));
+		if (header->milestones != NULL)
+			memset(header->milestones, 0, sizeof(node_milestones));
+	}
+
+	return header->milestones;
+}
+
+
+/**
+ * @brief - records the node as the last milestone of its list, milestones
+ * 	get broken if they can't grow, nothing is recorded if they can't be
+ * 	created
+ *
+ * @param header - the header of the list
+ * @param node - the node to record, after every recorded one in the list
+ */
+static void record_milestone(header * header, linked_list * node)
+{
+	node_milestones * milestones = milestones_of(header);
+	linked_list ** nodes;
+	size_t capacity;
+
+	if (milestones == NULL)
+		return;
+
+	if (milestones->count == milestones->capacity)
+	{
+		capacity = milestones->capacity ? milestones->capacity * 2 : 16;
+		nodes = list_allocate(& header->allocator, capacity * sizeof(* nodes));
+		if (nodes == NULL)
+		{
+			milestones->broken = 1;
+			return;
+		}
+
+		if (milestones->count > 0)
+			memcpy(nodes, milestones->nodes, milestones->count * sizeof(* nodes));
+		list_release(& header->allocator, milestones->nodes);
+
+		milestones->nodes = nodes;
+		milestones->capacity = capacity;
+	}
+
+	milestones->nodes[milestones->count++] = node;
+}
+
+
+void list_record_milestone_if_due(header * header, linked_list * node)
+{
+	if (! header->stale_size
+		&& header->size % LIST_MILESTONES_STRIDE == 0
+		&& (header->milestones == NULL || ! header->milestones->broken))
+		record_milestone(header, node);
+}
+
+
+void list_record_chain_milestones(
+	header * header,
+	linked_list * first,
+	size_t previous_size)
+{
+	size_t size = previous_size + 1;
+
+	if (header->stale_size)
+		return;
+
+	for (; first != NULL; first = first->next)
+	{
+		if (header->milestones != NULL && header->milestones->broken)
+			return;
+
+		if (size++ % LIST_MILESTONES_STRIDE == 0)
+			record_milestone(header, first);
+	}
+}
+
+
+void list_forget_milestones(header * header)
+{
+	header->milestones->broken = 1;
+}
+
+
+void list_release_milestones(header * header)
+{
+	if (header->milestones == NULL)
+		return;
+
+	list_release(& header->allocator, header->milestones->nodes);
+	list_release(& header->allocator, header->milestones);
+	header->milestones = NULL;
+}
+
+
+/**
+ * @brief - reduces every node of the range into its accumulator
+ *
+ * @param range - the range to reduce, a reduction_range *
+ *
+ * @return void * - NULL
+ */
+static void * reduce_range(void * range)
+{
+	reduction_range * reduction = range;
+	linked_list const * node;
+
+	for (node = reduction->first; node != reduction->end; node = node->next)
+		reduction->reducer(reduction->accumulator, node->value);
+
+	return NULL;
+}
+
+
+/**
+ * @brief - picks the first node of every range among milestones, so each
+ * 	range gets as many milestones
+ *
+ * @param header - the header of the list to split, with valid milestones
+ * @param ranges - the ranges to set the first node of
+ * @param ranges_count - how many ranges to split the list into
+ *
+ * @return size_t - how many ranges could be set, less than asked if there
+ * 	aren't enough milestones
+ */
+static size_t split_at_milestones(
+	header const * header,
+	reduction_range * ranges,
+	size_t ranges_count)
+{
+	node_milestones const * milestones = header->milestones;
+	size_t index;
+
+	if (ranges_count > milestones->count + 1)
+		ranges_count = milestones->count + 1;
+
+	ranges[0].first = header->first_node;
+	for (index = 1; index < ranges_count; index++)
+	{
+		ranges[index].first = milestones->nodes[
+			index * milestones->count / ranges_count];
+	}
+
+	return ranges_count;
+}
+
+
+/**
+ * @brief - picks the first node of every range thanks to the position index,
+ * 	so each range gets as many nodes
+ *
+ * @param header - the header of the list to split, with an up to date index
+ * @param ranges - the ranges to set the first node of
+ * @param ranges_count - how many ranges to split the list into, not greater
+ * 	than the size of the list
+ */
+static void split_at_positions(
+	header const * header,
+	reduction_range * ranges,
+	size_t ranges_count)
+{
+	size_t index;
+
+	for (index = 0; index < ranges_count; index++)
+	{
+		ranges[index].first = list_index_node_at(
+			header,
+			index * header->size / ranges_count);
+	}
+}
+
+
+/**
+ * @brief - walks the whole list to pick the first node of every range, and
+ * 	rebuilds the milestones on the way unless the list is synchronized
+ *
+ * @param list_header - the header of the list to split
+ * @param ranges - the ranges to set the first node of
+ * @param ranges_count - how many ranges to split the list into, not greater
+ * 	than the size of the list
+ */
+static void split_by_walking(
+	header * header,
+	reduction_range * ranges,
+	size_t ranges_count)
+{
+	linked_list * node = header->first_node;
+	int rebuilding = header->lock == NULL; /* readers don't write */
+	size_t range_index = 0;
+	size_t position;
+
+	if (rebuilding && milestones_of(header) == NULL)
+		rebuilding = 0;
+
+	if (rebuilding)
+	{
+		header->milestones->count = 0;
+		header->milestones->broken = 0;
+	}
+
+	for (position = 0; node != NULL; position++, node = node->next)
+	{
+		if (range_index < ranges_count
+			&& position == range_index * header->size / ranges_count)
+			ranges[range_index++].first = node;
+
+		if (rebuilding
+			&& (position + 1) % LIST_MILESTONES_STRIDE == 0
+			&& ! header->milestones->broken)
+			record_milestone(header, node);
+	}
+}
+
+
+
+
+void * list_reduce(
+	linked_list const * list,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * node_content))
+{
+	header const * header;
+	size_t epoch;
+
+	if (list == NULL)
+		return accumulator;
+
+	header = list_header_of(list);
+	epoch = list_enter_epoch_of(header);
+
+	if (list_is_anchor(list)) /* leads to the first node */
+		list = LOAD_LINK(list->next);
+
+	while (list != NULL)
+	{
+		reducer(accumulator, list->value);
+		list = LOAD_LINK(list->next);
+	}
+
+	list_leave_epoch_of(header, epoch);
+
+	return accumulator;
+}
+
+
+void * list_reduce_prefetch(
+	linked_list const * list,
+	size_t distance,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * node_content))
+{
+	linked_list const * ahead;
+	header const * header;
+	size_t epoch;
+	size_t lead;
+
+	if (list == NULL)
+		return accumulator;
+
+	header = list_header_of(list);
+	epoch = list_enter_epoch_of(header);
+
+	if (list_is_anchor(list)) /* leads to the first node */
+		list = LOAD_LINK(list->next);
+
+	/* the node ahead runs the pointer chase while earlier values are reduced */
+	ahead = list;
+	for (lead = 0; lead < distance && ahead != NULL; lead++)
+	{
+		PREFETCH(ahead->value);
+		ahead = LOAD_LINK(ahead->next);
+	}
+
+	while (list != NULL)
+	{
+		if (ahead != NULL)
+		{
+			PREFETCH(ahead->value);
+			PREFETCH(ahead->next);
+			ahead = LOAD_LINK(ahead->next);
+		}
+
+		reducer(accumulator, list->value);
+		list = LOAD_LINK(list->next);
+	}
+
+	list_leave_epoch_of(header, epoch);
+
+	return accumulator;
+}
+
+
+void * list_reduce_batch(
+	linked_list const * list,
+	void * accumulator,
+	void (* batch_reducer)(
+		void * accumulator,
+		void const * const * values,
+		size_t count))
+{
+	void const * values[LIST_BATCH_SIZE];
+	header const * header;
+	size_t epoch;
+	size_t count = 0;
+
+	if (list == NULL)
+		return accumulator;
+
+	header = list_header_of(list);
+	epoch = list_enter_epoch_of(header);
+
+	if (list_is_anchor(list)) /* leads to the first node */
+		list = LOAD_LINK(list->next);
+
+	for (; list != NULL; list = LOAD_LINK(list->next))
+	{
+		values[count++] = list->value;
+		if (count == LIST_BATCH_SIZE)
+		{
+			batch_reducer(accumulator, values, count);
+			count = 0;
+		}
+	}
+
+	if (count > 0)
+		batch_reducer(accumulator, values, count);
+
+	list_leave_epoch_of(header, epoch);
+
+	return accumulator;
+}
+
+
+void * list_reduce_parallel(
+	linked_list const * list,
+	size_t threads_count,
+	void * accumulator,
+	void * (* init)(void),
+	void (* reducer)(void * accumulator, void const * node_content),
+	void (* combiner)(void * accumulator, void * partial_accumulator))
+{
+	reduction_range * ranges;
+	reduction_range whole_list;
+	header * header;
+	size_t index;
+
+	if (list == NULL)
+		return accumulator;
+
+	header = list_header_of(list);
+	list_lock_for_reading(header);
+	if (header->first_node == NULL)
+	{
+		list_unlock(header);
+		return accumulator;
+	}
+
+	if (threads_count == 0)
+		threads_count = 1;
+	if (threads_count > list_size_of(header))
+		threads_count = header->size;
+
+	ranges = malloc(threads_count * sizeof(reduction_range));
+	if (ranges == NULL)
+		threads_count = 0;
+	else if (list_has_fresh_index(header))
+		split_at_positions(header, ranges, threads_count);
+	else if (header->milestones == NULL || header->milestones->broken)
+		split_by_walking(header, ranges, threads_count);
+	else
+		threads_count = split_at_milestones(header, ranges, threads_count);
+
+	if (threads_count == 0) /* couldn't split, reduce in a single range */
+	{
+		whole_list.first = header->first_node;
+		whole_list.end = NULL;
+		whole_list.accumulator = init();
+		whole_list.reducer = reducer;
+		reduce_range(& whole_list);
+		list_unlock(header);
+
+		combiner(accumulator, whole_list.accumulator);
+		return accumulator;
+	}
+
+	for (index = 0; index < threads_count; index++)
+	{
+		ranges[index].end = (index + 1 < threads_count)
+			? ranges[index + 1].first
+			: NULL;
+		ranges[index].accumulator = init();
+		ranges[index].reducer = reducer;
+		ranges[index].threaded = index > 0 && pthread_create(
+			& ranges[index].thread,
+			NULL,
+			reduce_range,
+			& ranges[index]) == 0;
+	}
+
+	for (index = 0; index < threads_count; index++)
+	{
+		if (ranges[index].threaded)
+			pthread_join(ranges[index].thread, NULL);
+		else
+			reduce_range(& ranges[index]);
+
+		combiner(accumulator, ranges[index].accumulator);
+	}
+
+	list_unlock(header);
+
+	free(ranges);
+	return accumulator;
+}
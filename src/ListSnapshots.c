@@ -0,0 +1,794 @@
+
+#define _POSIX_C_SOURCE 200112L /* pthread_rwlock_t */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/List.h"
+#include "../include/ListNode.h"
+#include "ListPrivate.h"
+
+
+/**
+ * @brief - a node of the tree holding the values of a list in order, the
+ * 	tree is shared between the list and its snapshots: nodes only the list
+ * 	leads to are changed in place, the others are copied first, so the
+ * 	snapshots never see a change
+ * 	Nodes are allocated with malloc, since snapshots may outlive their list
+ * 	and be released by any thread
+ */
+typedef struct snapshot_node
+{
+	/**
+	 * @brief - the value of the list node
+	 */
+	void * value;
+
+	/**
+	 * @brief - the values before this one in the subtree, NULL if none
+	 */
+	struct snapshot_node * left;
+
+	/**
+	 * @brief - the values after this one in the subtree, NULL if none
+	 */
+	struct snapshot_node * right;
+
+	/**
+	 * @brief - how many values the subtree holds
+	 */
+	size_t count;
+
+	/**
+	 * @brief - a random priority, higher than the ones of the children, so
+	 * 	the tree stays balanced as a treap
+	 */
+	size_t priority;
+
+	/**
+	 * @brief - how many trees, views and nodes lead to this one, changed
+	 * 	atomically since views are released by any thread
+	 */
+	size_t references;
+} snapshot_node;
+
+
+/**
+ * @brief - a persistent tree of the values of a list, a snapshot takes its
+ * 	root: appends, prepends and removals copy the O(log n) nodes they change
+ * 	if a snapshot leads to them, the tree is rebuilt from the list by the
+ * 	next snapshot when nodes are moved around
+ */
+typedef struct snapshot_tree
+{
+	/**
+	 * @brief - the root of the tree, NULL if the list is empty
+	 */
+	snapshot_node * root;
+
+	/**
+	 * @brief - nodes allocated ahead of a change, so it can't fail half
+	 * 	way, chained by their left child
+	 */
+	snapshot_node * spares;
+
+	/**
+	 * @brief - how many times the tree was changed, given to snapshots
+	 */
+	size_t version;
+
+	/**
+	 * @brief - the last seed a priority was spread from
+	 */
+	size_t seed;
+
+	/**
+	 * @brief - 1 if the tree no longer follows the list, it is rebuilt by
+	 * 	the next snapshot
+	 */
+	int stale;
+} snapshot_tree;
+
+
+/**
+ * @brief - an immutable view of a list, as it was when the snapshot was taken
+ */
+struct list_view
+{
+	/**
+	 * @brief - the root of the tree of the values, NULL if the list was empty
+	 */
+	snapshot_node * root;
+
+	/**
+	 * @brief - the version of the tree the view was taken from
+	 */
+	size_t version;
+};
+
+
+
+
+/**
+ * @brief - adds a reference to a snapshot node
+ *
+ * @param node - the node to reference, NULL if none
+ */
+static void retain_snapshot_node(snapshot_node * node)
+{
+	if (node != NULL)
+		__atomic_add_fetch(& node->references, 1, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * @brief - drops a reference to a snapshot node, releasing it along with the
+ * 	subtrees nothing else leads to once it isn't referenced anymore
+ *
+ * @param node - the node to drop, NULL if none
+ */
+static void release_snapshot_node(snapshot_node * node)
+{
+	snapshot_node * right;
+
+	/* loops on right children, only left ones take stack */
+	while (node != NULL
+		&& __atomic_sub_fetch(& node->references, 1, __ATOMIC_ACQ_REL) == 0)
+	{
+		release_snapshot_node(node->left);
+		right = node->right;
+		free(node);
+		node = right;
+	}
+}
+
+
+/**
+ * @brief - releases the tree of the list, views keep the nodes they lead to,
+ * 	without disabling it
+ *
+ * @param tree - the tree to release
+ */
+static void release_snapshot_tree(snapshot_tree * tree)
+{
+	snapshot_node * spare;
+
+	release_snapshot_node(tree->root);
+	tree->root = NULL;
+
+	while ((spare = tree->spares) != NULL)
+	{
+		tree->spares = spare->left;
+		free(spare);
+	}
+}
+
+
+/**
+ * @brief - counts the values of a subtree
+ *
+ * @param node - the root of the subtree, NULL if empty
+ *
+ * @return size_t - how many values the subtree holds
+ */
+static size_t count_of(snapshot_node const * node)
+{
+	return (node != NULL) ? node->count : 0;
+}
+
+
+/**
+ * @brief - makes sure the tree has enough spare nodes for a change
+ *
+ * @param tree - the tree about to change
+ * @param count - how many nodes the change may need
+ *
+ * @return int - 1 if there are enough spare nodes, 0 if allocation failed
+ */
+static int reserve_spares(snapshot_tree * tree, size_t count)
+{
+	snapshot_node * spare;
+	size_t available = 0;
+
+	for (spare = tree->spares; spare != NULL && available < count;
+		spare = spare->left)
+		available++;
+
+	for (; available < count; available++)
+	{
+		spare = malloc(sizeof(* spare));
+		if (spare == NULL)
+			return 0;
+
+		spare->left = tree->spares;
+		tree->spares = spare;
+	}
+
+	return 1;
+}
+
+
+/**
+ * @brief - takes a spare node, reserved beforehand
+ *
+ * @param tree - the tree to take the node from
+ *
+ * @return snapshot_node * - the spare node, referenced once
+ */
+static snapshot_node * take_spare(snapshot_tree * tree)
+{
+	snapshot_node * node = tree->spares;
+
+	tree->spares = node->left;
+	node->references = 1;
+
+	return node;
+}
+
+
+/**
+ * @brief - gives a node the tree can change in place: the node itself if
+ * 	only the tree leads to it, a copy taking over the reference otherwise
+ *
+ * @param tree - the tree the node belongs to
+ * @param node - the node to change, the reference given is taken over
+ *
+ * @return snapshot_node * - the node to change
+ */
+static snapshot_node * own_snapshot_node(
+	snapshot_tree * tree,
+	snapshot_node * node)
+{
+	snapshot_node * copy;
+
+	if (__atomic_load_n(& node->references, __ATOMIC_ACQUIRE) == 1)
+		return node;
+
+	copy = take_spare(tree);
+	copy->value = node->value;
+	copy->left = node->left;
+	copy->right = node->right;
+	copy->count = node->count;
+	copy->priority = node->priority;
+	retain_snapshot_node(copy->left);
+	retain_snapshot_node(copy->right);
+	release_snapshot_node(node);
+
+	return copy;
+}
+
+
+/**
+ * @brief - splits a subtree after the given count of values
+ *
+ * @param tree - the tree the subtree belongs to
+ * @param node - the root of the subtree, the reference given is taken over
+ * @param count - how many values go to the left part
+ * @param left - set to the left part
+ * @param right - set to the right part
+ */
+static void split_snapshot_node(
+	snapshot_tree * tree,
+	snapshot_node * node,
+	size_t count,
+	snapshot_node ** left,
+	snapshot_node ** right)
+{
+	if (node == NULL)
+	{
+		* left = NULL;
+		* right = NULL;
+		return;
+	}
+
+	node = own_snapshot_node(tree, node);
+	if (count_of(node->left) >= count)
+	{
+		split_snapshot_node(tree, node->left, count, left, & node->left);
+		* right = node;
+	}
+	else
+	{
+		count -= count_of(node->left) + 1;
+		split_snapshot_node(tree, node->right, count, & node->right, right);
+		* left = node;
+	}
+
+	node->count = count_of(node->left) + count_of(node->right) + 1;
+}
+
+
+/**
+ * @brief - merges 2 subtrees, every value of the left one going first
+ *
+ * @param tree - the tree the subtrees belong to
+ * @param left - the left subtree, the reference given is taken over
+ * @param right - the right subtree, the reference given is taken over
+ *
+ * @return snapshot_node * - the root of the merged subtree
+ */
+static snapshot_node * merge_snapshot_nodes(
+	snapshot_tree * tree,
+	snapshot_node * left,
+	snapshot_node * right)
+{
+	if (left == NULL)
+		return right;
+	if (right == NULL)
+		return left;
+
+	if (left->priority > right->priority)
+	{
+		left = own_snapshot_node(tree, left);
+		left->right = merge_snapshot_nodes(tree, left->right, right);
+		left->count = count_of(left->left) + count_of(left->right) + 1;
+		return left;
+	}
+
+	right = own_snapshot_node(tree, right);
+	right->left = merge_snapshot_nodes(tree, left, right->left);
+	right->count = count_of(right->left) + count_of(right->right) + 1;
+	return right;
+}
+
+
+/**
+ * @brief - measures the path splitting the tree at a position, down to the
+ * 	bottom of the tree: merging the parts back only walks along it
+ *
+ * @param node - the root of the tree
+ * @param position - the position to split at
+ *
+ * @return size_t - how many nodes the path goes through
+ */
+static size_t split_depth(snapshot_node const * node, size_t position)
+{
+	size_t depth = 0;
+
+	for (; node != NULL; depth++)
+	{
+		if (count_of(node->left) >= position)
+			node = node->left;
+		else
+		{
+			position -= count_of(node->left) + 1;
+			node = node->right;
+		}
+	}
+
+	return depth;
+}
+
+
+/**
+ * @brief - inserts a value in the tree at the given position
+ * 	Complexity: O(log n) expected
+ *
+ * @param tree - the tree to insert into
+ * @param position - the position of the value
+ * @param value - the value to insert
+ *
+ * @return int - 1 if the value was inserted, 0 if allocation failed, the tree
+ * 	is then left untouched
+ */
+static int insert_snapshot_value(
+	snapshot_tree * tree,
+	size_t position,
+	void * value)
+{
+	snapshot_node * inserted;
+	snapshot_node * left;
+	snapshot_node * right;
+
+	if (! reserve_spares(tree, split_depth(tree->root, position) + 1))
+		return 0;
+
+	inserted = take_spare(tree);
+	inserted->value = value;
+	inserted->left = NULL;
+	inserted->right = NULL;
+	inserted->count = 1;
+	inserted->priority = list_spread_hash(++tree->seed);
+
+	split_snapshot_node(tree, tree->root, position, & left, & right);
+	left = merge_snapshot_nodes(tree, left, inserted);
+	tree->root = merge_snapshot_nodes(tree, left, right);
+	tree->version++;
+
+	return 1;
+}
+
+
+/**
+ * @brief - removes the value at the given position from the tree
+ * 	Complexity: O(log n) expected
+ *
+ * @param tree - the tree to remove from
+ * @param position - the position of the value, in the tree
+ *
+ * @return int - 1 if the value was removed, 0 if allocation failed, the tree
+ * 	is then left untouched
+ */
+static int remove_snapshot_value(snapshot_tree * tree, size_t position)
+{
+	snapshot_node * removed;
+	snapshot_node * left;
+	snapshot_node * right;
+
+	/* the second split goes on along the path splitting after the value */
+	if (! reserve_spares(tree, split_depth(tree->root, position)
+		+ split_depth(tree->root, position + 1)))
+		return 0;
+
+	split_snapshot_node(tree, tree->root, position, & left, & right);
+	split_snapshot_node(tree, right, 1, & removed, & right);
+	tree->root = merge_snapshot_nodes(tree, left, right);
+	release_snapshot_node(removed);
+	tree->version++;
+
+	return 1;
+}
+
+
+/**
+ * @brief - counts the values of every subtree of a built tree
+ *
+ * @param node - the root of the subtree, NULL if empty
+ */
+static void count_snapshot_nodes(snapshot_node * node)
+{
+	if (node == NULL)
+		return;
+
+	count_snapshot_nodes(node->left);
+	count_snapshot_nodes(node->right);
+	node->count = count_of(node->left) + count_of(node->right) + 1;
+}
+
+
+/**
+ * @brief - builds a tree of the values of a chain, in order, keeping the
+ * 	right edge of the tree on a stack so every node is pushed and popped once
+ * 	Complexity: O(n)
+ *
+ * @param node - the first node of the chain, NULL if empty
+ * @param seed - the seed priorities are spread from, updated
+ * @param root - set to the root of the tree
+ *
+ * @return int - 1 if the tree was built, 0 if allocation failed
+ */
+static int build_snapshot_tree(
+	linked_list const * node,
+	size_t * seed,
+	snapshot_node ** root)
+{
+	snapshot_node ** edge = NULL;
+	snapshot_node ** grown;
+	snapshot_node * created;
+	size_t capacity = 0;
+	size_t depth = 0;
+
+	for (; node != NULL; node = node->next)
+	{
+		if (depth == capacity)
+		{
+			capacity = (capacity > 0) ? capacity * 2 : 64;
+			grown = realloc(edge, capacity * sizeof(* edge));
+			if (grown == NULL)
+				break;
+			edge = grown;
+		}
+
+		created = malloc(sizeof(* created));
+		if (created == NULL)
+			break;
+
+		created->value = node->value;
+		created->left = NULL;
+		created->right = NULL;
+		created->priority = list_spread_hash(++(* seed));
+		created->references = 1;
+
+		/* lower priorities of the edge go below the created node */
+		while (depth > 0 && edge[depth - 1]->priority < created->priority)
+			created->left = edge[--depth];
+		if (depth > 0)
+			edge[depth - 1]->right = created;
+		edge[depth++] = created;
+	}
+
+	* root = (depth > 0) ? edge[0] : NULL;
+	free(edge);
+
+	if (node != NULL)
+	{
+		release_snapshot_node(* root);
+		* root = NULL;
+		return 0;
+	}
+
+	count_snapshot_nodes(* root);
+	return 1;
+}
+
+
+/**
+ * @brief - builds the tree of the list again, views keep the old one
+ *
+ * @param header - the header of the list
+ *
+ * @return int - 1 if the tree is up to date, 0 if allocation failed
+ */
+static int rebuild_snapshot_tree(header * header)
+{
+	snapshot_tree * tree = header->snapshots;
+	snapshot_node * root;
+
+	if (! build_snapshot_tree(header->first_node, & tree->seed, & root))
+		return 0;
+
+	release_snapshot_node(tree->root);
+	tree->root = root;
+	tree->stale = 0;
+	tree->version++;
+
+	return 1;
+}
+
+
+void list_snapshot_value(header * header, linked_list * node, int at_end)
+{
+	snapshot_tree * tree = header->snapshots;
+	size_t position = at_end ? count_of(tree->root) : 0;
+
+	if (! tree->stale
+		&& ! insert_snapshot_value(tree, position, node->value))
+		tree->stale = 1;
+}
+
+
+void list_snapshot_chain(
+	header * header,
+	linked_list const * before,
+	linked_list const * after,
+	linked_list * first,
+	linked_list const * last)
+{
+	snapshot_tree * tree = header->snapshots;
+	size_t position;
+
+	if (tree->stale)
+		return;
+
+	if (after != NULL && before != NULL)
+	{
+		tree->stale = 1;
+		return;
+	}
+
+	position = (after == NULL) ? count_of(tree->root) : 0;
+	for (;; first = first->next)
+	{
+		if (! insert_snapshot_value(tree, position++, first->value))
+		{
+			tree->stale = 1;
+			return;
+		}
+
+		if (first == last)
+			return;
+	}
+}
+
+
+void list_unsnapshot_value(header * header, linked_list const * node)
+{
+	snapshot_tree * tree = header->snapshots;
+	size_t position;
+
+	if (tree->stale)
+		return;
+
+	if (header->index == NULL
+		|| ! list_index_position(header, node, & position)
+		|| ! remove_snapshot_value(tree, position))
+		tree->stale = 1;
+}
+
+
+void list_forget_snapshots(header * header)
+{
+	header->snapshots->stale = 1;
+}
+
+
+void list_release_snapshots(header * header)
+{
+	if (header->snapshots == NULL)
+		return;
+
+	release_snapshot_tree(header->snapshots);
+	list_release(& header->allocator, header->snapshots);
+	header->snapshots = NULL;
+}
+
+
+/**
+ * @brief - collects the values of a subtree, in order
+ *
+ * @param node - the root of the subtree, NULL if empty
+ * @param accumulator - the accumulator
+ * @param reducer - the callback to apply on every value
+ */
+static void reduce_snapshot_node(
+	snapshot_node const * node,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * node_content))
+{
+	/* loops on right children, only left ones take stack */
+	for (; node != NULL; node = node->right)
+	{
+		reduce_snapshot_node(node->left, accumulator, reducer);
+		reducer(accumulator, node->value);
+	}
+}
+
+
+
+
+int list_enable_snapshots(linked_list * list)
+{
+	header * header;
+	int enabled;
+
+	if (list == NULL)
+		return 0;
+
+	header = list_header_of(list);
+	if (header->concurrent != NULL)
+		return 0;
+
+	list_lock_for_writing(header);
+	if (header->snapshots == NULL)
+	{
+		header->snapshots = list_allocate(
+			& header->allocator,
+			sizeof(snapshot_tree));
+		if (header->snapshots != NULL)
+		{
+			memset(header->snapshots, 0, sizeof(snapshot_tree));
+			if (! rebuild_snapshot_tree(header))
+				list_release_snapshots(header);
+		}
+
+		/* removals find the position of their value with it */
+		if (header->snapshots != NULL)
+			list_enable_position_index(list);
+	}
+	enabled = header->snapshots != NULL;
+	list_unlock(header);
+
+	return enabled;
+}
+
+
+void list_disable_snapshots(linked_list * list)
+{
+	header * header;
+
+	if (list == NULL)
+		return;
+
+	header = list_header_of(list);
+	list_lock_for_writing(header);
+	list_release_snapshots(header);
+	list_unlock(header);
+}
+
+
+list_view * list_snapshot(linked_list const * list)
+{
+	list_view * view = malloc(sizeof(* view));
+	header * header;
+	size_t seed = 0;
+	int is_taken;
+
+	if (view == NULL)
+		return NULL;
+
+	view->root = NULL;
+	view->version = 0;
+	if (list == NULL)
+		return view;
+
+	header = list_header_of(list);
+	if (header->concurrent != NULL)
+		is_taken = 0;
+	else if (header->snapshots == NULL)
+	{
+		list_lock_for_reading(header);
+		is_taken = build_snapshot_tree(
+			header->first_node,
+			& seed,
+			& view->root);
+		list_unlock(header);
+	}
+	else
+	{
+		list_lock_for_writing(header);
+		/* the tree may have been released since it was checked */
+		is_taken = header->snapshots != NULL
+			&& (! header->snapshots->stale || rebuild_snapshot_tree(header));
+		if (is_taken)
+		{
+			view->root = header->snapshots->root;
+			view->version = header->snapshots->version;
+			retain_snapshot_node(view->root);
+		}
+		list_unlock(header);
+	}
+
+	if (! is_taken)
+	{
+		free(view);
+		return NULL;
+	}
+
+	return view;
+}
+
+
+void list_view_release(list_view ** view)
+{
+	if (view == NULL || * view == NULL)
+		return;
+
+	release_snapshot_node((* view)->root);
+	free(* view);
+	* view = NULL;
+}
+
+
+size_t list_view_size(list_view const * view)
+{
+	return (view != NULL) ? count_of(view->root) : 0;
+}
+
+
+size_t list_view_version(list_view const * view)
+{
+	return (view != NULL) ? view->version : 0;
+}
+
+
+void * list_view_at(list_view const * view, size_t position)
+{
+	snapshot_node const * node = (view != NULL) ? view->root : NULL;
+
+	while (node != NULL)
+	{
+		if (position < count_of(node->left))
+			node = node->left;
+		else if (position == count_of(node->left))
+			return node->value;
+		else
+		{
+			position -= count_of(node->left) + 1;
+			node = node->right;
+		}
+	}
+
+	return NULL;
+}
+
+
+void * list_view_reduce(
+	list_view const * view,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * node_content))
+{
+	if (view != NULL)
+		reduce_snapshot_node(view->root, accumulator, reducer);
+
+	return accumulator;
+}
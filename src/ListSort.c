@@ -0,0 +1,751 @@
+
+#define _POSIX_C_SOURCE 200112L /* pthread_rwlock_t */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "../include/List.h"
+#include "../include/ListNode.h"
+#include "ListPrivate.h"
+
+
+/**
+ * @brief - how many nodes of a run sorted by its own thread separate 2 samples,
+ * 	also the least nodes a run holds
+ */
+#define LIST_SORT_SAMPLES_STRIDE 64
+
+
+/**
+ * @brief - a part of the list sorted by its own thread, before being merged
+ */
+typedef struct sorting_run
+{
+	/**
+	 * @brief - the first node of the run, which ends with a NULL link
+	 */
+	linked_list * first;
+
+	/**
+	 * @brief - how many nodes the run holds
+	 */
+	size_t size;
+
+	/**
+	 * @brief - the nodes at every LIST_SORT_SAMPLES_STRIDE rank of the sorted
+	 * 	run, from the first one, so it can be searched by value
+	 */
+	linked_list ** samples;
+
+	/**
+	 * @brief - how many nodes are sampled
+	 */
+	size_t samples_count;
+} sorting_run;
+
+
+/**
+ * @brief - the state shared by the threads of a parallel sort: the list is
+ * 	cut in runs sorted on their own, then values splitting them evenly are
+ * 	sampled, so each thread merges the values between 2 of them from every
+ * 	run into a segment, and segments are joined in order
+ */
+typedef struct parallel_sort
+{
+	/**
+	 * @brief - the runs, in list order
+	 */
+	sorting_run * runs;
+
+	/**
+	 * @brief - how many runs, and merged segments, there are
+	 */
+	size_t runs_count;
+
+	/**
+	 * @brief - the values ending every segment but the last one, sorted
+	 */
+	void const ** splitters;
+
+	/**
+	 * @brief - for each run, the first node of each segment in it, then
+	 * 	NULL, runs_count + 1 nodes per run
+	 */
+	linked_list ** cuts;
+
+	/**
+	 * @brief - the next node of each run to merge, runs_count per segment
+	 */
+	linked_list ** heads;
+
+	/**
+	 * @brief - the runs ordered by their next node, runs_count per segment
+	 */
+	size_t * heaps;
+
+	/**
+	 * @brief - the first and last node of each merged segment
+	 */
+	linked_list ** merged;
+
+	/**
+	 * @brief - compares 2 values, negative if the first one goes first
+	 */
+	int (* comparator)(void const * first, void const * second);
+} parallel_sort;
+
+
+/**
+ * @brief - one of the threads of a parallel sort
+ */
+typedef struct sort_worker
+{
+	/**
+	 * @brief - the sort the worker takes part in
+	 */
+	parallel_sort * sort;
+
+	/**
+	 * @brief - the run sorted, then the segment merged by the worker
+	 */
+	size_t index;
+
+	/**
+	 * @brief - the thread of the worker
+	 */
+	pthread_t thread;
+
+	/**
+	 * @brief - 1 if the worker runs on its own thread, 0 otherwise
+	 */
+	int threaded;
+} sort_worker;
+
+
+
+
+/**
+ * @brief - merges every pair of adjacent sorted runs of the chain, following
+ * 	next links only, equal values keep their order
+ *
+ * @param first - the first node of the chain, set to the first merged one
+ * @param width - how many nodes each run holds, the last one may hold less
+ * @param comparator - compares 2 values, negative if the first goes first
+ *
+ * @return size_t - how many merges were done, 1 once the chain is sorted
+ */
+static size_t merge_runs(
+	linked_list ** first,
+	size_t width,
+	int (* comparator)(void const * first, void const * second))
+{
+	linked_list merged;
+	linked_list * tail = & merged;
+	linked_list * left = * first;
+	linked_list * right;
+	linked_list * taken;
+	size_t left_size;
+	size_t right_size;
+	size_t merges = 0;
+
+	while (left != NULL)
+	{
+		merges++;
+
+		right = left;
+		for (left_size = 0; left_size < width && right != NULL; left_size++)
+			right = right->next;
+		right_size = width;
+
+		while (left_size > 0 || (right_size > 0 && right != NULL))
+		{
+			if (left_size > 0 && (right_size == 0 || right == NULL
+				|| comparator(left->value, right->value) <= 0))
+			{
+				taken = left;
+				left = left->next;
+				left_size--;
+			}
+			else
+			{
+				taken = right;
+				right = right->next;
+				right_size--;
+			}
+
+			tail->next = taken;
+			tail = taken;
+		}
+
+		left = right;
+	}
+
+	tail->next = NULL;
+	* first = merged.next;
+
+	return merges;
+}
+
+
+/**
+ * @brief - sorts a chain of nodes following next links only, runs double in
+ * 	width until a single one is left
+ *
+ * @param first - the first node of the chain, which ends with a NULL link
+ * @param comparator - compares 2 values, negative if the first goes first
+ *
+ * @return linked_list * - the first sorted node
+ */
+static linked_list * sort_chain(
+	linked_list * first,
+	int (* comparator)(void const * first, void const * second))
+{
+	size_t width;
+
+	for (width = 1; merge_runs(& first, width, comparator) > 1; width *= 2)
+		continue;
+
+	return first;
+}
+
+
+/**
+ * @brief - allocates everything a parallel sort needs
+ *
+ * @param sort - the sort to prepare
+ * @param size - how many nodes the list holds
+ * @param runs_count - how many runs to cut the list in
+ * @param comparator - compares 2 values, negative if the first goes first
+ *
+ * @return int - 1 if the sort is ready, 0 if allocation failed
+ */
+static int prepare_parallel_sort(
+	parallel_sort * sort,
+	size_t size,
+	size_t runs_count,
+	int (* comparator)(void const * first, void const * second))
+{
+	linked_list ** samples;
+	size_t index;
+
+	sort->runs_count = runs_count;
+	sort->comparator = comparator;
+	sort->runs = malloc(runs_count * sizeof(* sort->runs));
+	sort->splitters = malloc(runs_count * runs_count * sizeof(void const *));
+	sort->cuts = malloc(runs_count * (runs_count + 1) * sizeof(linked_list *));
+	sort->heads = malloc(runs_count * runs_count * sizeof(linked_list *));
+	sort->heaps = malloc(runs_count * runs_count * sizeof(size_t));
+	sort->merged = malloc(2 * runs_count * sizeof(linked_list *));
+	samples = malloc(
+		(size / LIST_SORT_SAMPLES_STRIDE + runs_count) * sizeof(linked_list *));
+
+	if (sort->runs == NULL || sort->splitters == NULL || sort->cuts == NULL
+		|| sort->heads == NULL || sort->heaps == NULL || sort->merged == NULL
+		|| samples == NULL)
+	{
+		free(sort->runs);
+		free(sort->splitters);
+		free(sort->cuts);
+		free(sort->heads);
+		free(sort->heaps);
+		free(sort->merged);
+		free(samples);
+		return 0;
+	}
+
+	for (index = 0; index < runs_count; index++)
+	{
+		sort->runs[index].size = (index + 1) * size / runs_count
+			- index * size / runs_count;
+		sort->runs[index].samples = samples;
+		sort->runs[index].samples_count = (sort->runs[index].size
+			+ LIST_SORT_SAMPLES_STRIDE - 1) / LIST_SORT_SAMPLES_STRIDE;
+		samples += sort->runs[index].samples_count;
+	}
+
+	return 1;
+}
+
+
+/**
+ * @brief - releases everything a parallel sort allocated
+ *
+ * @param sort - the sort to release
+ */
+static void release_parallel_sort(parallel_sort * sort)
+{
+	free(sort->runs[0].samples);
+	free(sort->runs);
+	free(sort->splitters);
+	free(sort->cuts);
+	free(sort->heads);
+	free(sort->heaps);
+	free(sort->merged);
+}
+
+
+/**
+ * @brief - cuts the chain in runs of the sizes set by the sort, in one pass
+ *
+ * @param sort - the sort whose runs are cut
+ * @param node - the first node of the chain
+ */
+static void cut_runs(parallel_sort * sort, linked_list * node)
+{
+	linked_list * last = NULL;
+	size_t index;
+	size_t rank;
+
+	for (index = 0; index < sort->runs_count; index++)
+	{
+		if (last != NULL)
+			last->next = NULL;
+
+		sort->runs[index].first = node;
+		for (rank = 0; rank < sort->runs[index].size; rank++)
+		{
+			last = node;
+			node = node->next;
+		}
+	}
+}
+
+
+/**
+ * @brief - calls the task for every worker, on their own threads except for
+ * 	the first one, which runs on the calling thread along with workers
+ * 	whose thread couldn't be created, and waits for all of them
+ *
+ * @param workers - the workers, with their sort and index set
+ * @param count - how many workers there are
+ * @param task - the task to run, given a sort_worker *
+ */
+static void run_workers(
+	sort_worker * workers,
+	size_t count,
+	void * (* task)(void * worker))
+{
+	size_t index;
+
+	for (index = 0; index < count; index++)
+	{
+		workers[index].threaded = index > 0 && pthread_create(
+			& workers[index].thread,
+			NULL,
+			task,
+			& workers[index]) == 0;
+	}
+
+	for (index = 0; index < count; index++)
+	{
+		if (workers[index].threaded)
+			pthread_join(workers[index].thread, NULL);
+		else
+			task(& workers[index]);
+	}
+}
+
+
+/**
+ * @brief - sorts the run of the worker, then samples it
+ *
+ * @param worker - the worker, a sort_worker *
+ *
+ * @return void * - NULL
+ */
+static void * sort_run(void * worker)
+{
+	parallel_sort * sort = ((sort_worker *) worker)->sort;
+	sorting_run * run = & sort->runs[((sort_worker *) worker)->index];
+	linked_list * node;
+	size_t rank = 0;
+
+	run->first = sort_chain(run->first, sort->comparator);
+
+	for (node = run->first; node != NULL; node = node->next, rank++)
+	{
+		if (rank % LIST_SORT_SAMPLES_STRIDE == 0)
+			run->samples[rank / LIST_SORT_SAMPLES_STRIDE] = node;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief - sorts values in place, with a shell sort, for the few samples
+ * 	splitting a parallel sort
+ *
+ * @param values - the values to sort
+ * @param count - how many values there are
+ * @param comparator - compares 2 values, negative if the first goes first
+ */
+static void sort_values(
+	void const ** values,
+	size_t count,
+	int (* comparator)(void const * first, void const * second))
+{
+	void const * value;
+	size_t position;
+	size_t index;
+	size_t gap;
+
+	for (gap = count / 2; gap > 0; gap /= 2)
+	{
+		for (index = gap; index < count; index++)
+		{
+			value = values[index];
+			for (position = index;
+				position >= gap
+					&& comparator(values[position - gap], value) > 0;
+				position -= gap)
+				values[position] = values[position - gap];
+			values[position] = value;
+		}
+	}
+}
+
+
+/**
+ * @brief - picks the values ending each segment, from values evenly spaced
+ * 	in every sorted run, so no segment gets much more than its share
+ *
+ * @param sort - the sort whose runs are sorted and sampled
+ */
+static void choose_splitters(parallel_sort * sort)
+{
+	size_t count = sort->runs_count;
+	sorting_run const * run;
+	size_t picked = 0;
+	size_t index;
+	size_t rank;
+
+	for (index = 0; index < count; index++)
+	{
+		run = & sort->runs[index];
+		for (rank = 0; rank < count; rank++)
+		{
+			sort->splitters[picked++] =
+				run->samples[rank * run->samples_count / count]->value;
+		}
+	}
+
+	sort_values(sort->splitters, picked, sort->comparator);
+
+	/* the splitters are kept at the start of the candidates */
+	for (index = 1; index < count; index++)
+		sort->splitters[index - 1] = sort->splitters[index * count + count / 2];
+}
+
+
+/**
+ * @brief - finds the first node of a sorted run whose value goes after the
+ * 	splitter, searching the samples then walking from the closest one
+ *
+ * @param run - the sorted and sampled run
+ * @param splitter - the value to compare nodes to
+ * @param comparator - compares 2 values, negative if the first goes first
+ *
+ * @return linked_list * - the first node after the splitter, NULL if none
+ */
+static linked_list * find_cut(
+	sorting_run const * run,
+	void const * splitter,
+	int (* comparator)(void const * first, void const * second))
+{
+	size_t low = 0;
+	size_t high = run->samples_count;
+	size_t middle;
+	linked_list * node;
+
+	/* the first sample after the splitter is between low and high */
+	while (low < high)
+	{
+		middle = low + (high - low) / 2;
+		if (comparator(run->samples[middle]->value, splitter) > 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+
+	if (low == 0)
+		return run->first;
+
+	node = run->samples[low - 1];
+	while (node != NULL && comparator(node->value, splitter) <= 0)
+		node = node->next;
+
+	return node;
+}
+
+
+/**
+ * @brief - finds where every segment starts in every run
+ *
+ * @param sort - the sort whose runs are sorted and splitters chosen
+ */
+static void cut_segments(parallel_sort * sort)
+{
+	size_t count = sort->runs_count;
+	linked_list ** cuts;
+	size_t index;
+	size_t segment;
+
+	for (index = 0; index < count; index++)
+	{
+		cuts = & sort->cuts[index * (count + 1)];
+		cuts[0] = sort->runs[index].first;
+		for (segment = 1; segment < count; segment++)
+		{
+			cuts[segment] = find_cut(
+				& sort->runs[index],
+				sort->splitters[segment - 1],
+				sort->comparator);
+		}
+		cuts[count] = NULL;
+	}
+}
+
+
+/**
+ * @brief - checks if the next node of a run goes before the one of another,
+ * 	runs earlier in the list go first among equal values
+ *
+ * @param sort - the sort being merged
+ * @param heads - the next node of each run
+ * @param run - the run to check
+ * @param other - the run to compare to
+ *
+ * @return int - 1 if the run goes first, 0 otherwise
+ */
+static int goes_first(
+	parallel_sort const * sort,
+	linked_list * const * heads,
+	size_t run,
+	size_t other)
+{
+	int comparison = sort->comparator(heads[run]->value, heads[other]->value);
+
+	return comparison < 0 || (comparison == 0 && run < other);
+}
+
+
+/**
+ * @brief - restores the order of the heap of runs from its given entry down
+ *
+ * @param sort - the sort being merged
+ * @param heads - the next node of each run
+ * @param heap - the runs, ordered by their next node
+ * @param count - how many runs are in the heap
+ * @param entry - the entry which may go after its children
+ */
+static void sift_down(
+	parallel_sort const * sort,
+	linked_list * const * heads,
+	size_t * heap,
+	size_t count,
+	size_t entry)
+{
+	size_t child;
+	size_t run;
+
+	while ((child = 2 * entry + 1) < count)
+	{
+		if (child + 1 < count
+			&& goes_first(sort, heads, heap[child + 1], heap[child]))
+			child++;
+		if (! goes_first(sort, heads, heap[child], heap[entry]))
+			return;
+
+		run = heap[entry];
+		heap[entry] = heap[child];
+		heap[child] = run;
+		entry = child;
+	}
+}
+
+
+/**
+ * @brief - merges the segment of the worker from every run, linking its nodes
+ * 	both ways
+ *
+ * @param worker - the worker, a sort_worker *
+ *
+ * @return void * - NULL
+ */
+static void * merge_segment(void * worker)
+{
+	parallel_sort * sort = ((sort_worker *) worker)->sort;
+	size_t segment = ((sort_worker *) worker)->index;
+	size_t count = sort->runs_count;
+	linked_list ** heads = & sort->heads[segment * count];
+	size_t * heap = & sort->heaps[segment * count];
+	linked_list * previous = NULL;
+	linked_list * first = NULL;
+	linked_list * node;
+	size_t heap_size = 0;
+	size_t run;
+
+	for (run = 0; run < count; run++)
+	{
+		heads[run] = sort->cuts[run * (count + 1) + segment];
+		if (heads[run] != sort->cuts[run * (count + 1) + segment + 1])
+			heap[heap_size++] = run;
+	}
+	for (run = heap_size / 2; run-- > 0;)
+		sift_down(sort, heads, heap, heap_size, run);
+
+	while (heap_size > 0)
+	{
+		run = heap[0];
+		node = heads[run];
+		heads[run] = node->next;
+
+		node->previous = previous;
+		if (previous != NULL)
+			previous->next = node;
+		else
+			first = node;
+		previous = node;
+
+		if (heads[run] == sort->cuts[run * (count + 1) + segment + 1])
+			heap[0] = heap[--heap_size];
+		sift_down(sort, heads, heap, heap_size, 0);
+	}
+
+	if (previous != NULL)
+		previous->next = NULL;
+
+	sort->merged[2 * segment] = first;
+	sort->merged[2 * segment + 1] = previous;
+
+	return NULL;
+}
+
+
+/**
+ * @brief - joins the merged segments in order
+ *
+ * @param sort - the merged sort
+ * @param last - set to the last node of the list
+ *
+ * @return linked_list * - the first node of the list
+ */
+static linked_list * join_segments(
+	parallel_sort const * sort,
+	linked_list ** last)
+{
+	linked_list * first = NULL;
+	size_t segment;
+
+	* last = NULL;
+	for (segment = 0; segment < sort->runs_count; segment++)
+	{
+		if (sort->merged[2 * segment] == NULL)
+			continue;
+
+		if (* last == NULL)
+			first = sort->merged[2 * segment];
+		else
+			list_link_nodes(* last, sort->merged[2 * segment]);
+		* last = sort->merged[2 * segment + 1];
+	}
+
+	return first;
+}
+
+
+
+
+void list_sort(
+	linked_list ** list,
+	int (* comparator)(void const * first, void const * second))
+{
+	linked_list * previous = NULL;
+	linked_list * first;
+	linked_list * node;
+	header * header;
+
+	if (list == NULL || * list == NULL || comparator == NULL)
+		return;
+
+	header = list_header_of(* list);
+	if (list_is_shared(header) || list_size_of(header) < 2)
+		return;
+
+	first = sort_chain(header->first_node, comparator);
+	for (node = first; node != NULL; node = node->next)
+	{
+		node->previous = previous;
+		previous = node;
+	}
+
+	list_set_first_node(header, first);
+	list_set_last_node(header, previous);
+	list_forget_positions(header);
+
+	if (! list_is_anchor(* list))
+		* list = first;
+}
+
+
+void list_sort_parallel(
+	linked_list ** list,
+	size_t threads_count,
+	int (* comparator)(void const * first, void const * second))
+{
+	sort_worker * workers;
+	parallel_sort sort;
+	linked_list * first;
+	linked_list * last;
+	header * header;
+	size_t index;
+
+	if (list == NULL || * list == NULL || comparator == NULL)
+		return;
+
+	header = list_header_of(* list);
+	if (list_is_shared(header))
+		return;
+
+	/* runs too short to be sampled aren't worth a thread */
+	if (threads_count > list_size_of(header) / LIST_SORT_SAMPLES_STRIDE)
+		threads_count = header->size / LIST_SORT_SAMPLES_STRIDE;
+
+	workers = (threads_count > 1)
+		? malloc(threads_count * sizeof(sort_worker))
+		: NULL;
+	if (workers == NULL || ! prepare_parallel_sort(
+		& sort,
+		header->size,
+		threads_count,
+		comparator))
+	{
+		free(workers);
+		list_sort(list, comparator);
+		return;
+	}
+
+	for (index = 0; index < threads_count; index++)
+	{
+		workers[index].sort = & sort;
+		workers[index].index = index;
+	}
+
+	cut_runs(& sort, header->first_node);
+	run_workers(workers, threads_count, sort_run);
+	choose_splitters(& sort);
+	cut_segments(& sort);
+	run_workers(workers, threads_count, merge_segment);
+	first = join_segments(& sort, & last);
+
+	release_parallel_sort(& sort);
+	free(workers);
+
+	list_set_first_node(header, first);
+	list_set_last_node(header, last);
+	list_forget_positions(header);
+
+	if (! list_is_anchor(* list))
+		* list = first;
+}
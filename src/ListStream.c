@@ -0,0 +1,557 @@
+
+#define _POSIX_C_SOURCE 200112L /* pthread_rwlock_t */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../include/List.h"
+#include "../include/ListNode.h"
+#include "ListPrivate.h"
+
+
+/**
+ * @brief - the layout of written lists: a stream header made of the magic
+ * 	bytes and the count of values on 8 bytes, then chunks made of the count
+ * 	of their values and the size of their payload on 4 bytes each, then the
+ * 	payload, every value prefixed by its size
+ * 	Integers are stored in little endian order, sizes 7 bits per byte
+ */
+#define LIST_STREAM_MAGIC "LST1"
+#define LIST_STREAM_HEADER_SIZE 12
+#define LIST_STREAM_CHUNK_HEADER_SIZE 8
+
+
+/**
+ * @brief - how many bytes the largest size prefix of a value takes
+ */
+#define LIST_STREAM_MAX_PREFIX ((sizeof(size_t) * 8 + 6) / 7)
+
+
+/**
+ * @brief - how many bytes a chunk takes at most, unless a single value is
+ * 	bigger
+ */
+#define LIST_STREAM_BUFFER_SIZE 65536
+
+
+/**
+ * @brief - the buffer a list is written through, holding a chunk: its header
+ * 	first, then every value encoded so far, each one prefixed by its size
+ */
+typedef struct stream_buffer
+{
+	/**
+	 * @brief - the chunk being filled
+	 */
+	unsigned char * bytes;
+
+	/**
+	 * @brief - how many bytes the chunk takes so far, its header included
+	 */
+	size_t size;
+
+	/**
+	 * @brief - how many bytes the buffer can hold
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief - how many values the chunk holds
+	 */
+	size_t count;
+
+	/**
+	 * @brief - the file descriptor chunks are written to
+	 */
+	int fd;
+} stream_buffer;
+
+
+
+
+/**
+ * @brief - writes the whole memory to the file descriptor, going on after
+ * 	partial writes and interruptions
+ *
+ * @param fd - the file descriptor to write to
+ * @param bytes - the memory to write
+ * @param size - how many bytes to write
+ *
+ * @return int - 1 if everything was written, 0 otherwise
+ */
+static int write_fully(int fd, unsigned char const * bytes, size_t size)
+{
+	ssize_t written;
+
+	while (size > 0)
+	{
+		written = write(fd, bytes, size);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0)
+			return 0;
+
+		bytes += written;
+		size -= (size_t) written;
+	}
+
+	return 1;
+}
+
+
+/**
+ * @brief - reads exactly the given number of bytes from the file descriptor,
+ * 	going on after partial reads and interruptions
+ *
+ * @param fd - the file descriptor to read from
+ * @param bytes - the memory to read into
+ * @param size - how many bytes to read
+ *
+ * @return int - 1 if everything was read, 0 on error or early end of file
+ */
+static int read_fully(int fd, unsigned char * bytes, size_t size)
+{
+	ssize_t got;
+
+	while (size > 0)
+	{
+		got = read(fd, bytes, size);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got <= 0)
+			return 0;
+
+		bytes += got;
+		size -= (size_t) got;
+	}
+
+	return 1;
+}
+
+
+/**
+ * @brief - stores an integer in little endian order, whatever the host one
+ *
+ * @param bytes - where to store the integer
+ * @param number - the integer to store
+ * @param width - how many bytes the integer takes
+ */
+static void put_integer(unsigned char * bytes, size_t number, size_t width)
+{
+	for (; width > 0; width--, number >>= 8)
+		* bytes++ = (unsigned char) (number & 0xFF);
+}
+
+
+/**
+ * @brief - loads an integer stored in little endian order
+ *
+ * @param bytes - where the integer is stored
+ * @param width - how many bytes the integer takes
+ *
+ * @return size_t - the integer
+ */
+static size_t get_integer(unsigned char const * bytes, size_t width)
+{
+	size_t number = 0;
+
+	for (; width > 0; width--)
+		number = (number << 8) | bytes[width - 1];
+
+	return number;
+}
+
+
+/**
+ * @brief - stores a size with 7 bits per byte, the highest bit telling if
+ * 	more bytes follow, so small sizes take a single byte
+ *
+ * @param bytes - where to store the size, LIST_STREAM_MAX_PREFIX bytes at most
+ * @param size - the size to store
+ *
+ * @return size_t - how many bytes the size takes
+ */
+static size_t put_prefix(unsigned char * bytes, size_t size)
+{
+	size_t width = 1;
+
+	for (; size >= 0x80; size >>= 7, width++)
+		* bytes++ = (unsigned char) ((size & 0x7F) | 0x80);
+	* bytes = (unsigned char) size;
+
+	return width;
+}
+
+
+/**
+ * @brief - loads a size stored by put_prefix
+ *
+ * @param bytes - where the size is stored
+ * @param end - the end of the readable memory
+ * @param size - set to the size
+ *
+ * @return unsigned char const * - the byte after the size, NULL if the size
+ * 	is truncated or too big
+ */
+static unsigned char const * get_prefix(
+	unsigned char const * bytes,
+	unsigned char const * end,
+	size_t * size)
+{
+	size_t shift;
+
+	* size = 0;
+	for (shift = 0; bytes < end && shift < sizeof(size_t) * 8; shift += 7)
+	{
+		* size |= (size_t) (* bytes & 0x7F) << shift;
+		if ((* bytes++ & 0x80) == 0)
+			return bytes;
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief - writes the chunk filled so far, if it holds any value, and starts
+ * 	a new one
+ *
+ * @param buffer - the buffer holding the chunk
+ *
+ * @return int - 1 if the chunk was written, 0 otherwise
+ */
+static int flush_chunk(stream_buffer * buffer)
+{
+	if (buffer->count == 0)
+		return 1;
+
+	put_integer(buffer->bytes, buffer->count, 4);
+	put_integer(
+		buffer->bytes + 4,
+		buffer->size - LIST_STREAM_CHUNK_HEADER_SIZE,
+		4);
+	if (! write_fully(buffer->fd, buffer->bytes, buffer->size))
+		return 0;
+
+	buffer->size = LIST_STREAM_CHUNK_HEADER_SIZE;
+	buffer->count = 0;
+
+	return 1;
+}
+
+
+/**
+ * @brief - grows the buffer so a chunk holding a single encoded value fits,
+ * 	must be called on an empty chunk
+ *
+ * @param buffer - the buffer to grow
+ * @param size - the size of the encoded value
+ *
+ * @return int - 1 if the buffer has grown, 0 if allocation failed or if the
+ * 	value is too big for a chunk
+ */
+static int grow_buffer(stream_buffer * buffer, size_t size)
+{
+	unsigned char * bytes;
+
+	if (size > 0xFFFFFFFFUL - LIST_STREAM_MAX_PREFIX)
+		return 0;
+
+	bytes = realloc(
+		buffer->bytes,
+		LIST_STREAM_CHUNK_HEADER_SIZE + LIST_STREAM_MAX_PREFIX + size);
+	if (bytes == NULL)
+		return 0;
+
+	buffer->bytes = bytes;
+	buffer->capacity = LIST_STREAM_CHUNK_HEADER_SIZE
+		+ LIST_STREAM_MAX_PREFIX
+		+ size;
+
+	return 1;
+}
+
+
+/**
+ * @brief - encodes a value at the end of the chunk, once its size prefix is
+ * 	known, the chunk is written first if the value doesn't fit anymore
+ *
+ * @param buffer - the buffer holding the chunk
+ * @param value - the value to encode
+ * @param encode - writes the value if it fits, returns its size either way
+ *
+ * @return int - 1 if the value was encoded, 0 otherwise
+ */
+static int buffer_value(
+	stream_buffer * buffer,
+	void const * value,
+	size_t (* encode)(void const * value, void * bytes, size_t capacity))
+{
+	unsigned char * encoded = NULL;
+	size_t needed = 0;
+	size_t room;
+	size_t width;
+
+	for (;;)
+	{
+		/* the value goes after the largest prefix, moved back once known */
+		if (buffer->capacity - buffer->size >= LIST_STREAM_MAX_PREFIX)
+		{
+			encoded = buffer->bytes + buffer->size + LIST_STREAM_MAX_PREFIX;
+			room = buffer->capacity - buffer->size - LIST_STREAM_MAX_PREFIX;
+			needed = encode(value, encoded, room);
+			if (needed <= room)
+				break;
+		}
+
+		if (buffer->count > 0 ? ! flush_chunk(buffer)
+			: ! grow_buffer(buffer, needed))
+			return 0;
+	}
+
+	width = put_prefix(buffer->bytes + buffer->size, needed);
+	memmove(buffer->bytes + buffer->size + width, encoded, needed);
+	buffer->size += width + needed;
+	buffer->count++;
+
+	return 1;
+}
+
+
+/**
+ * @brief - writes every value of the list, chunk by chunk, after the stream
+ * 	header giving their count
+ *
+ * @param buffer - the empty buffer to write through
+ * @param header - the header of the list, NULL if the list is empty
+ * @param encode - writes a value if it fits, returns its size either way
+ *
+ * @return int - 1 if the list was written, 0 otherwise
+ */
+static int write_values(
+	stream_buffer * buffer,
+	header * header,
+	size_t (* encode)(void const * value, void * bytes, size_t capacity))
+{
+	unsigned char stream_header[LIST_STREAM_HEADER_SIZE];
+	linked_list const * node;
+
+	memcpy(stream_header, LIST_STREAM_MAGIC, 4);
+	put_integer(stream_header + 4, (header != NULL) ? list_size_of(header) : 0, 8);
+	if (! write_fully(buffer->fd, stream_header, sizeof(stream_header)))
+		return 0;
+
+	node = (header != NULL) ? header->first_node : NULL;
+	for (; node != NULL; node = node->next)
+	{
+		if (! buffer_value(buffer, node->value, encode))
+			return 0;
+	}
+
+	return flush_chunk(buffer);
+}
+
+
+/**
+ * @brief - decodes the values of a chunk and appends them to the list, values
+ * 	decoded before a failure are appended as well
+ *
+ * @param list - the list to append the values to
+ * @param bytes - the payload of the chunk
+ * @param size - how many bytes the payload takes
+ * @param values - room for every value of the chunk
+ * @param count - how many values the chunk holds
+ * @param decode - creates a value from its bytes, NULL if they are invalid
+ *
+ * @return int - 1 if the whole chunk was appended, 0 otherwise
+ */
+static int read_chunk(
+	linked_list ** list,
+	unsigned char const * bytes,
+	size_t size,
+	void ** values,
+	size_t count,
+	void * (* decode)(void const * bytes, size_t size))
+{
+	unsigned char const * end = bytes + size;
+	size_t previous_size = list_size(* list);
+	size_t decoded;
+	size_t width;
+
+	for (decoded = 0; decoded < count; decoded++)
+	{
+		bytes = get_prefix(bytes, end, & width);
+		if (bytes == NULL || width > (size_t) (end - bytes))
+			break;
+
+		values[decoded] = decode(bytes, width);
+		if (values[decoded] == NULL)
+			break;
+		bytes += width;
+	}
+
+	if (decoded > 0)
+		list_append_array(list, values, decoded);
+
+	return decoded == count
+		&& bytes == end
+		&& list_size(* list) == previous_size + decoded;
+}
+
+
+/**
+ * @brief - reads every chunk of a list, up to the count announced by the
+ * 	stream header
+ *
+ * @param fd - the file descriptor to read from, after the stream header
+ * @param list - the list to append the values to
+ * @param count - how many values the stream holds
+ * @param decode - creates a value from its bytes, NULL if they are invalid
+ *
+ * @return int - 1 if every value was read, 0 otherwise
+ */
+static int read_values(
+	int fd,
+	linked_list ** list,
+	size_t count,
+	void * (* decode)(void const * bytes, size_t size))
+{
+	unsigned char chunk_header[LIST_STREAM_CHUNK_HEADER_SIZE];
+	header * header = list_header_of(* list);
+	unsigned char * bytes = NULL;
+	void ** values = NULL;
+	size_t values_capacity = 0;
+	size_t capacity = 0;
+	size_t read = 0;
+	size_t reserved;
+	size_t chunk_count;
+	size_t size;
+	void * grown;
+
+	while (count > 0 && read_fully(fd, chunk_header, sizeof(chunk_header)))
+	{
+		chunk_count = get_integer(chunk_header, 4);
+		size = get_integer(chunk_header + 4, 4);
+
+		/* every value takes a byte at least, for its size */
+		if (chunk_count == 0 || chunk_count > count || chunk_count > size
+			|| chunk_count > (size_t) -1 / sizeof(* values))
+			break;
+
+		if (size > capacity)
+		{
+			if ((grown = realloc(bytes, size)) == NULL)
+				break;
+			bytes = grown;
+			capacity = size;
+		}
+
+		if (chunk_count > values_capacity)
+		{
+			grown = realloc(values, chunk_count * sizeof(* values));
+			if (grown == NULL)
+				break;
+			values = grown;
+			values_capacity = chunk_count;
+		}
+
+		if (! read_fully(fd, bytes, size))
+			break;
+
+		/* nodes carved out of chunks are reserved as chunks come, doubling
+		 * what was read, so a forged count can't reserve more than that */
+		reserved = read > chunk_count ? read : chunk_count;
+		list_reserve_nodes(header, reserved < count ? reserved : count);
+
+		if (! read_chunk(list, bytes, size, values, chunk_count, decode))
+			break;
+
+		read += chunk_count;
+		count -= chunk_count;
+	}
+
+	free(bytes);
+	free(values);
+
+	return count == 0;
+}
+
+
+
+
+int list_write(
+	int fd,
+	linked_list const * list,
+	size_t (* encode)(void const * value, void * bytes, size_t capacity))
+{
+	header * header = (list != NULL) ? list_header_of(list) : NULL;
+	stream_buffer buffer;
+	int is_written;
+
+	if (encode == NULL || (header != NULL && header->concurrent != NULL))
+		return 0;
+
+	buffer.bytes = malloc(LIST_STREAM_BUFFER_SIZE);
+	if (buffer.bytes == NULL)
+		return 0;
+
+	buffer.size = LIST_STREAM_CHUNK_HEADER_SIZE;
+	buffer.capacity = LIST_STREAM_BUFFER_SIZE;
+	buffer.count = 0;
+	buffer.fd = fd;
+
+	if (header != NULL)
+		list_lock_for_reading(header);
+	is_written = write_values(& buffer, header, encode);
+	if (header != NULL)
+		list_unlock(header);
+
+	free(buffer.bytes);
+
+	return is_written;
+}
+
+
+int list_read(
+	int fd,
+	linked_list ** list,
+	void * (* decode)(void const * bytes, size_t size))
+{
+	unsigned char stream_header[LIST_STREAM_HEADER_SIZE];
+	header * header;
+	int created = 0;
+	size_t count;
+	int is_read;
+
+	if (list == NULL || decode == NULL
+		|| ! read_fully(fd, stream_header, sizeof(stream_header))
+		|| memcmp(stream_header, LIST_STREAM_MAGIC, 4) != 0)
+		return 0;
+
+	count = get_integer(stream_header + 4, 8);
+	if (count == 0)
+		return 1;
+
+	if (* list == NULL)
+	{
+		header = list_create_anchored_header(& list_default_allocator);
+		if (header == NULL)
+			return 0;
+
+		* list = & header->anchor;
+		created = 1;
+	}
+
+	header = list_header_of(* list);
+	is_read = read_values(fd, list, count, decode);
+
+	if (created && header->first_node == NULL)
+	{
+		list_delete_header(& header);
+		* list = NULL;
+	}
+
+	return is_read;
+}
@@ -0,0 +1,494 @@
+
+#define _POSIX_C_SOURCE 200112L /* pthread_rwlock_t */
+
+#include <string.h>
+
+#include "../include/List.h"
+#include "../include/ListNode.h"
+#include "ListPrivate.h"
+
+
+/**
+ * @brief - ends the buckets and the unused entries of a value index
+ */
+#define LIST_NO_ENTRY ((size_t) -1)
+
+
+/**
+ * @brief - the entry of a node in the value index
+ */
+typedef struct value_entry
+{
+	/**
+	 * @brief - the indexed node, NULL if the entry is unused
+	 */
+	linked_list * node;
+
+	/**
+	 * @brief - the hash of the key of the node value
+	 */
+	size_t hash;
+
+	/**
+	 * @brief - the next entry of the bucket, or the next unused entry,
+	 * 	LIST_NO_ENTRY if none
+	 */
+	size_t next;
+} value_entry;
+
+
+/**
+ * @brief - a hash index from the keys of the values to the nodes holding them,
+ * 	each bucket chains its entries in list order, so lookups give the first
+ * 	matching node
+ * 	Appends and prepends add their entry at the end or the start of its
+ * 	bucket, removals unchain it, the entries are rebuilt from the list when
+ * 	they run out
+ */
+typedef struct value_index
+{
+	/**
+	 * @brief - hashes a key, NULL to hash its address
+	 */
+	size_t (* hash)(void const * key);
+
+	/**
+	 * @brief - gives the key of a value, NULL if values are their own keys
+	 */
+	void const * (* key_of)(void const * value);
+
+	/**
+	 * @brief - every entry, used or not
+	 */
+	value_entry * entries;
+
+	/**
+	 * @brief - the first entry of each bucket, LIST_NO_ENTRY if empty
+	 */
+	size_t * firsts;
+
+	/**
+	 * @brief - the last entry of each bucket, meaningless if empty
+	 */
+	size_t * lasts;
+
+	/**
+	 * @brief - how many entries and buckets there are, a power of 2
+	 */
+	size_t capacity;
+
+	/**
+	 * @brief - how many entries were handed out at least once, from the start
+	 */
+	size_t used;
+
+	/**
+	 * @brief - the first unchained entry, LIST_NO_ENTRY if none
+	 */
+	size_t free_entries;
+
+	/**
+	 * @brief - 1 if the entries no longer follow the list, they are rebuilt
+	 * 	by the next lookup
+	 */
+	int stale;
+} value_index;
+
+
+
+
+/**
+ * @brief - hashes a key with the function of the value index
+ *
+ * @param index - the index to hash the key for
+ * @param key - the key to hash
+ *
+ * @return size_t - the hash of the key
+ */
+static size_t hash_key(value_index const * index, void const * key)
+{
+	return list_spread_hash(
+		(index->hash != NULL) ? index->hash(key) : (size_t) key);
+}
+
+
+/**
+ * @brief - hashes the key of a value with the functions of the value index
+ *
+ * @param index - the index to hash the value for
+ * @param value - the value to hash the key of
+ *
+ * @return size_t - the hash of the key of the value
+ */
+static size_t hash_value(value_index const * index, void const * value)
+{
+	return hash_key(
+		index,
+		(index->key_of != NULL) ? index->key_of(value) : value);
+}
+
+
+/**
+ * @brief - checks if a value matches the key looked up
+ *
+ * @param value - the value to check
+ * @param key - the key looked up
+ * @param eq - compares a value and a key, NULL to compare their addresses
+ *
+ * @return int - 1 if the value matches, 0 otherwise
+ */
+static int matches(
+	void const * value,
+	void const * key,
+	int (* eq)(void const * value, void const * key))
+{
+	return (eq != NULL) ? eq(value, key) != 0 : value == key;
+}
+
+
+/**
+ * @brief - takes an unused entry of the value index, reusing an unchained one
+ * 	if any
+ *
+ * @param index - the index to take the entry from
+ *
+ * @return size_t - the entry, LIST_NO_ENTRY if they are all used
+ */
+static size_t take_entry(value_index * index)
+{
+	size_t entry = index->free_entries;
+
+	if (entry != LIST_NO_ENTRY)
+	{
+		index->free_entries = index->entries[entry].next;
+		return entry;
+	}
+
+	if (index->used == index->capacity)
+		return LIST_NO_ENTRY;
+
+	return index->used++;
+}
+
+
+/**
+ * @brief - chains an entry for the node in the bucket of its key
+ *
+ * @param index - the index to update
+ * @param node - the node to index
+ * @param at_end - 1 to chain the entry last, 0 to chain it first
+ *
+ * @return int - 1 if the node was indexed, 0 if entries ran out
+ */
+static int add_entry(value_index * index, linked_list * node, int at_end)
+{
+	size_t entry = take_entry(index);
+	size_t bucket;
+
+	if (entry == LIST_NO_ENTRY)
+		return 0;
+
+	index->entries[entry].node = node;
+	index->entries[entry].hash = hash_value(index, node->value);
+	bucket = index->entries[entry].hash & (index->capacity - 1);
+
+	if (index->firsts[bucket] == LIST_NO_ENTRY)
+	{
+		index->entries[entry].next = LIST_NO_ENTRY;
+		index->firsts[bucket] = entry;
+		index->lasts[bucket] = entry;
+	}
+	else if (at_end)
+	{
+		index->entries[entry].next = LIST_NO_ENTRY;
+		index->entries[index->lasts[bucket]].next = entry;
+		index->lasts[bucket] = entry;
+	}
+	else
+	{
+		index->entries[entry].next = index->firsts[bucket];
+		index->firsts[bucket] = entry;
+	}
+
+	return 1;
+}
+
+
+/**
+ * @brief - unchains the entry of the node from its bucket
+ *
+ * @param index - the index to update
+ * @param node - the node leaving the index, still holding its value
+ */
+static void remove_entry(value_index * index, linked_list const * node)
+{
+	size_t bucket = hash_value(index, node->value) & (index->capacity - 1);
+	size_t previous = LIST_NO_ENTRY;
+	size_t entry;
+
+	for (entry = index->firsts[bucket];
+		entry != LIST_NO_ENTRY && index->entries[entry].node != node;
+		entry = index->entries[entry].next)
+		previous = entry;
+
+	if (entry == LIST_NO_ENTRY)
+		return;
+
+	if (previous == LIST_NO_ENTRY)
+		index->firsts[bucket] = index->entries[entry].next;
+	else
+		index->entries[previous].next = index->entries[entry].next;
+	if (index->lasts[bucket] == entry)
+		index->lasts[bucket] = previous;
+
+	index->entries[entry].node = NULL;
+	index->entries[entry].next = index->free_entries;
+	index->free_entries = entry;
+}
+
+
+/**
+ * @brief - releases the entries of the value index, before it's rebuilt or
+ * 	released
+ *
+ * @param header - the header of the list, whose value index is enabled
+ */
+static void release_entries(header * header)
+{
+	list_release(& header->allocator, header->keys->entries);
+	list_release(& header->allocator, header->keys->firsts);
+	list_release(& header->allocator, header->keys->lasts);
+
+	header->keys->entries = NULL;
+	header->keys->firsts = NULL;
+	header->keys->lasts = NULL;
+	header->keys->capacity = 0;
+	header->keys->used = 0;
+	header->keys->free_entries = LIST_NO_ENTRY;
+}
+
+
+void list_unindex_value(header * header, linked_list const * node)
+{
+	if (! header->keys->stale)
+		remove_entry(header->keys, node);
+}
+
+
+void list_forget_value_index(header * header)
+{
+	header->keys->stale = 1;
+}
+
+
+void list_release_value_index(header * header)
+{
+	if (header->keys == NULL)
+		return;
+
+	release_entries(header);
+	list_release(& header->allocator, header->keys);
+	header->keys = NULL;
+}
+
+
+/**
+ * @brief - indexes every node of the list again, with twice as many entries
+ * 	as nodes so as many can be added before running out of them
+ *
+ * @param header - the header of the list to index, whose value index is
+ * 	enabled
+ *
+ * @return int - 1 if the index is up to date, 0 if allocation failed
+ */
+static int rebuild_value_index(header * header)
+{
+	value_index * index = header->keys;
+	value_entry * entries;
+	linked_list * node;
+	size_t size = list_size_of(header);
+	size_t capacity = 16;
+	size_t * firsts;
+	size_t * lasts;
+
+	if (size > (size_t) -1 / (4 * sizeof(* entries)))
+		return 0;
+
+	while (capacity < size * 2)
+		capacity *= 2;
+
+	entries = list_allocate(& header->allocator, capacity * sizeof(* entries));
+	firsts = list_allocate(& header->allocator, capacity * sizeof(* firsts));
+	lasts = list_allocate(& header->allocator, capacity * sizeof(* lasts));
+	if (entries == NULL || firsts == NULL || lasts == NULL)
+	{
+		list_release(& header->allocator, entries);
+		list_release(& header->allocator, firsts);
+		list_release(& header->allocator, lasts);
+		return 0;
+	}
+
+	memset(firsts, 0xFF, capacity * sizeof(* firsts)); /* LIST_NO_ENTRY */
+
+	release_entries(header);
+	index->entries = entries;
+	index->firsts = firsts;
+	index->lasts = lasts;
+	index->capacity = capacity;
+	index->stale = 0;
+
+	for (node = header->first_node; node != NULL; node = node->next)
+		add_entry(index, node, 1);
+
+	return 1;
+}
+
+
+/**
+ * @brief - checks if the value index can answer lookups, rebuilding it first
+ * 	if the entries no longer follow the list
+ *
+ * @param header - the header of the list to check
+ *
+ * @return int - 1 if the index is enabled and up to date, 0 otherwise
+ */
+static int has_fresh_value_index(header * header)
+{
+	if (header->keys == NULL)
+		return 0;
+
+	return ! header->keys->stale || rebuild_value_index(header);
+}
+
+
+void list_index_value(header * header, linked_list * node, int at_end)
+{
+	value_index * index = header->keys;
+
+	if (! index->stale && ! add_entry(index, node, at_end))
+		index->stale = 1;
+}
+
+
+void list_index_chain_values(
+	header * header,
+	linked_list const * before,
+	linked_list const * after,
+	linked_list * first,
+	linked_list * last)
+{
+	if (header->keys->stale)
+		return;
+
+	if (after != NULL && before != NULL)
+	{
+		header->keys->stale = 1;
+		return;
+	}
+
+	/* prepended chains are indexed backward, each entry going first */
+	for (;;)
+	{
+		list_index_value(header, (after == NULL) ? first : last, after == NULL);
+		if (first == last)
+			return;
+
+		if (after == NULL)
+			first = first->next;
+		else
+			last = last->previous;
+	}
+}
+
+
+
+
+int list_enable_value_index(
+	linked_list * list,
+	size_t (* hash)(void const * key),
+	void const * (* key_of)(void const * value))
+{
+	header * header;
+
+	if (list == NULL)
+		return 0;
+
+	header = list_header_of(list);
+	if (list_is_shared(header))
+		return 0;
+
+	if (header->keys == NULL)
+	{
+		header->keys = list_allocate(& header->allocator, sizeof(value_index));
+		if (header->keys == NULL)
+			return 0;
+
+		memset(header->keys, 0, sizeof(value_index));
+		header->keys->free_entries = LIST_NO_ENTRY;
+	}
+
+	header->keys->hash = hash;
+	header->keys->key_of = key_of;
+	if (! rebuild_value_index(header))
+	{
+		list_release_value_index(header);
+		return 0;
+	}
+
+	return 1;
+}
+
+
+void list_disable_value_index(linked_list * list)
+{
+	if (list == NULL)
+		return;
+
+	list_release_value_index(list_header_of(list));
+}
+
+
+linked_list * list_find(
+	linked_list const * list,
+	void const * key,
+	int (* eq)(void const * value, void const * key))
+{
+	value_index const * index;
+	linked_list * node;
+	header * header;
+	size_t entry;
+	size_t hash;
+
+	if (list == NULL)
+		return NULL;
+
+	header = list_header_of(list);
+	if (has_fresh_value_index(header))
+	{
+		/* without comparison function, the key is a value itself */
+		index = header->keys;
+		hash = (eq != NULL) ? hash_key(index, key) : hash_value(index, key);
+
+		for (entry = index->firsts[hash & (index->capacity - 1)];
+			entry != LIST_NO_ENTRY;
+			entry = index->entries[entry].next)
+		{
+			node = index->entries[entry].node;
+			if (index->entries[entry].hash == hash
+				&& matches(node->value, key, eq))
+				return node;
+		}
+
+		return NULL;
+	}
+
+	list_lock_for_reading(header);
+	for (node = header->first_node; node != NULL; node = node->next)
+	{
+		if (matches(node->value, key, eq))
+			break;
+	}
+	list_unlock(header);
+
+	return node;
+}
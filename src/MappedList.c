@@ -0,0 +1,588 @@
+
+#define _POSIX_C_SOURCE 200112L /* ftruncate */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/MappedList.h"
+
+
+/**
+ * @brief - the bytes files holding a list start with
+ */
+#define MAPPED_LIST_MAGIC "LISTMAP1"
+
+
+/**
+ * @brief - stored in the header, reads back differently on hosts of another
+ * 	byte order
+ */
+#define BYTE_ORDER_MARK (((uint64_t) 0x01020304 << 32) | 0x05060708)
+
+
+/**
+ * @brief - marks unused nodes, stored as previous offset
+ */
+#define FREE_NODE ((uint64_t) -1)
+
+
+/**
+ * @brief - how many nodes a new file has room for
+ */
+#define INITIAL_CAPACITY 64
+
+
+
+
+/**
+ * @brief - the header of the list, at the start of the file
+ */
+typedef struct mapped_header
+{
+	/**
+	 * @brief - MAPPED_LIST_MAGIC, without its terminating null byte
+	 */
+	char magic[8];
+
+	/**
+	 * @brief - BYTE_ORDER_MARK, as written by the host creating the file
+	 */
+	uint64_t byte_order;
+
+	/**
+	 * @brief - how many bytes each value takes
+	 */
+	uint64_t value_size;
+
+	/**
+	 * @brief - how many bytes each node takes, its value included
+	 */
+	uint64_t node_size;
+
+	/**
+	 * @brief - the offset after the last node handed out at least once
+	 */
+	uint64_t used;
+
+	/**
+	 * @brief - how many nodes are in the list
+	 */
+	uint64_t size;
+
+	/**
+	 * @brief - the offset of the first node, MAPPED_LIST_NOWHERE if none
+	 */
+	uint64_t first;
+
+	/**
+	 * @brief - the offset of the last node, MAPPED_LIST_NOWHERE if none
+	 */
+	uint64_t last;
+
+	/**
+	 * @brief - the offset of the first removed node, MAPPED_LIST_NOWHERE if
+	 * 	none
+	 */
+	uint64_t free_nodes;
+} mapped_header;
+
+
+/**
+ * @brief - the links of a node, followed by its value in the file
+ */
+typedef struct mapped_node
+{
+	/**
+	 * @brief - the offset of the previous node, MAPPED_LIST_NOWHERE if none,
+	 * 	FREE_NODE if the node is unused
+	 */
+	uint64_t previous;
+
+	/**
+	 * @brief - the offset of the next node, MAPPED_LIST_NOWHERE if none, the
+	 * 	next unused node if the node is unused
+	 */
+	uint64_t next;
+} mapped_node;
+
+
+struct mapped_list
+{
+	/**
+	 * @brief - the start of the mapped file
+	 */
+	unsigned char * base;
+
+	/**
+	 * @brief - how many bytes are mapped, the size of the file
+	 */
+	size_t mapped_size;
+
+	/**
+	 * @brief - the file descriptor of the file
+	 */
+	int fd;
+};
+
+
+
+
+/**
+ * @brief - gives the header of the list, at the start of the mapping
+ *
+ * @param list - the list to get the header of
+ *
+ * @return mapped_header * - the header, moved along when the file grows
+ */
+static mapped_header * header_of(mapped_list const * list)
+{
+	return (mapped_header *) list->base;
+}
+
+
+/**
+ * @brief - gives the node at the given offset
+ *
+ * @param list - the list the node belongs to
+ * @param offset - the offset of the node, checked beforehand
+ *
+ * @return mapped_node * - the node, moved along when the file grows
+ */
+static mapped_node * node_at(mapped_list const * list, uint64_t offset)
+{
+	return (mapped_node *) (list->base + offset);
+}
+
+
+/**
+ * @brief - checks if the offset points to a node of the list
+ *
+ * @param list - the list to check the offset in
+ * @param offset - the offset to check
+ *
+ * @return int - 1 if a node lives at this offset, 0 otherwise
+ */
+static int is_valid_offset(mapped_list const * list, uint64_t offset)
+{
+	mapped_header const * header = header_of(list);
+
+	return offset >= sizeof(mapped_header)
+		&& offset < header->used
+		&& (offset - sizeof(mapped_header)) % header->node_size == 0
+		&& node_at(list, offset)->previous != FREE_NODE;
+}
+
+
+/**
+ * @brief - maps the whole file, replacing the current mapping if any
+ *
+ * @param list - the list whose file to map
+ * @param size - the size of the file
+ *
+ * @return int - 1 if the file is mapped, 0 otherwise, leaving the current
+ * 	mapping as is
+ */
+static int map_file(mapped_list * list, size_t size)
+{
+	void * base = mmap(
+		NULL,
+		size,
+		PROT_READ | PROT_WRITE,
+		MAP_SHARED,
+		list->fd,
+		0);
+	if (base == MAP_FAILED)
+		return 0;
+
+	if (list->base != NULL)
+		munmap(list->base, list->mapped_size);
+
+	list->base = base;
+	list->mapped_size = size;
+
+	return 1;
+}
+
+
+/**
+ * @brief - doubles the room for nodes, extending the file and mapping it again
+ *
+ * @param list - the list to grow
+ *
+ * @return int - 1 if the list has grown, 0 otherwise
+ */
+static int grow(mapped_list * list)
+{
+	size_t node_size = (size_t) header_of(list)->node_size;
+	size_t growth = list->mapped_size - sizeof(mapped_header);
+	size_t size;
+
+	if (growth < node_size * INITIAL_CAPACITY)
+		growth = node_size * INITIAL_CAPACITY;
+
+	size = list->mapped_size + growth;
+	if (size < list->mapped_size || (off_t) size < 0) /* overflow */
+		return 0;
+
+	if (ftruncate(list->fd, (off_t) size) != 0)
+		return 0;
+
+	return map_file(list, size);
+}
+
+
+/**
+ * @brief - takes an unused node, reusing a removed one if any
+ *
+ * @param list - the list to take the node from
+ *
+ * @return uint64_t - the offset of the node, MAPPED_LIST_NOWHERE if the file
+ * 	couldn't grow
+ */
+static uint64_t take_node(mapped_list * list)
+{
+	mapped_header * header = header_of(list);
+	uint64_t offset = header->free_nodes;
+
+	if (offset != MAPPED_LIST_NOWHERE)
+	{
+		header->free_nodes = node_at(list, offset)->next;
+		return offset;
+	}
+
+	if (header->used + header->node_size > list->mapped_size)
+	{
+		if (! grow(list))
+			return MAPPED_LIST_NOWHERE;
+		header = header_of(list);
+	}
+
+	offset = header->used;
+	header->used += header->node_size;
+
+	return offset;
+}
+
+
+/**
+ * @brief - gives the node back, so it's reused by next insertions
+ *
+ * @param list - the list the node belongs to
+ * @param offset - the offset of the node
+ */
+static void release_node(mapped_list * list, uint64_t offset)
+{
+	mapped_header * header = header_of(list);
+	mapped_node * node = node_at(list, offset);
+
+	node->previous = FREE_NODE;
+	node->next = header->free_nodes;
+	header->free_nodes = offset;
+}
+
+
+/**
+ * @brief - link 2 nodes
+ *
+ * @param list - the list the nodes belong to
+ * @param before - the offset of the previous node
+ * @param after - the offset of the next node
+ */
+static void link_nodes(mapped_list * list, uint64_t before, uint64_t after)
+{
+	mapped_header * header = header_of(list);
+
+	if (before != MAPPED_LIST_NOWHERE)
+		node_at(list, before)->next = after;
+	else
+		header->first = after;
+
+	if (after != MAPPED_LIST_NOWHERE)
+		node_at(list, after)->previous = before;
+	else
+		header->last = before;
+}
+
+
+/**
+ * @brief - takes a node and copies the value into it, without linking it
+ *
+ * @param list - the list to take the node from
+ * @param value - the value to copy
+ *
+ * @return uint64_t - the offset of the node, MAPPED_LIST_NOWHERE if the file
+ * 	couldn't grow
+ */
+static uint64_t create_node(mapped_list * list, void const * value)
+{
+	uint64_t offset = take_node(list);
+
+	if (offset == MAPPED_LIST_NOWHERE)
+		return MAPPED_LIST_NOWHERE;
+
+	memcpy(
+		node_at(list, offset) + 1,
+		value,
+		(size_t) header_of(list)->value_size);
+	header_of(list)->size++;
+
+	return offset;
+}
+
+
+/**
+ * @brief - writes the header of a new list at the start of the file, with
+ * 	room for the first nodes
+ *
+ * @param list - the list whose file is empty
+ * @param value_size - how many bytes each value takes
+ *
+ * @return int - 1 if the list was set up, 0 otherwise
+ */
+static int create_file(mapped_list * list, size_t value_size)
+{
+	mapped_header * header;
+	size_t node_size;
+	size_t size;
+
+	/* nodes are kept aligned on their 64 bits links */
+	node_size = sizeof(mapped_node) + value_size;
+	node_size += (sizeof(uint64_t) - node_size % sizeof(uint64_t))
+		% sizeof(uint64_t);
+	if (node_size > ((size_t) -1 - sizeof(mapped_header)) / INITIAL_CAPACITY)
+		return 0;
+
+	size = sizeof(mapped_header) + INITIAL_CAPACITY * node_size;
+	if (ftruncate(list->fd, (off_t) size) != 0 || ! map_file(list, size))
+		return 0;
+
+	header = header_of(list);
+	memcpy(header->magic, MAPPED_LIST_MAGIC, sizeof(header->magic));
+	header->byte_order = BYTE_ORDER_MARK;
+	header->value_size = value_size;
+	header->node_size = node_size;
+	header->used = sizeof(mapped_header);
+	header->size = 0;
+	header->first = MAPPED_LIST_NOWHERE;
+	header->last = MAPPED_LIST_NOWHERE;
+	header->free_nodes = MAPPED_LIST_NOWHERE;
+
+	return 1;
+}
+
+
+/**
+ * @brief - checks if the mapped file holds a list of such values
+ *
+ * @param list - the list whose file is mapped
+ * @param value_size - how many bytes each value is expected to take
+ *
+ * @return int - 1 if the file holds such a list, 0 otherwise
+ */
+static int is_valid_file(mapped_list const * list, size_t value_size)
+{
+	mapped_header const * header = header_of(list);
+
+	return memcmp(header->magic, MAPPED_LIST_MAGIC, sizeof(header->magic)) == 0
+		&& header->byte_order == BYTE_ORDER_MARK
+		&& header->value_size == value_size
+		&& header->node_size >= sizeof(mapped_node) + value_size
+		&& header->node_size % sizeof(uint64_t) == 0
+		&& header->node_size <= ((size_t) -1 - sizeof(mapped_header))
+			/ INITIAL_CAPACITY
+		&& header->used >= sizeof(mapped_header)
+		&& header->used <= list->mapped_size;
+}
+
+
+
+
+mapped_list * mapped_list_open(char const * path, size_t value_size)
+{
+	mapped_list * list;
+	struct stat status;
+	int is_open;
+
+	if (path == NULL || value_size == 0)
+		return NULL;
+
+	list = calloc(1, sizeof(mapped_list));
+	if (list == NULL)
+		return NULL;
+
+	list->fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (list->fd < 0)
+	{
+		free(list);
+		return NULL;
+	}
+
+	if (fstat(list->fd, & status) != 0)
+		is_open = 0;
+	else if (status.st_size == 0)
+		is_open = create_file(list, value_size);
+	else
+	{
+		is_open = (size_t) status.st_size >= sizeof(mapped_header)
+			&& map_file(list, (size_t) status.st_size)
+			&& is_valid_file(list, value_size);
+	}
+
+	if (! is_open)
+		mapped_list_close(& list);
+
+	return list;
+}
+
+
+void mapped_list_close(mapped_list ** list)
+{
+	if (list == NULL || * list == NULL)
+		return;
+
+	if ((* list)->base != NULL)
+		munmap((* list)->base, (* list)->mapped_size);
+	close((* list)->fd);
+
+	free(* list);
+	* list = NULL;
+}
+
+
+int mapped_list_sync(mapped_list * list)
+{
+	if (list == NULL)
+		return 0;
+
+	return msync(list->base, list->mapped_size, MS_SYNC) == 0;
+}
+
+
+size_t mapped_list_size(mapped_list const * list)
+{
+	if (list == NULL)
+		return 0;
+
+	return (size_t) header_of(list)->size;
+}
+
+
+uint64_t mapped_list_append(mapped_list * list, void const * value)
+{
+	uint64_t offset;
+
+	if (list == NULL || value == NULL)
+		return MAPPED_LIST_NOWHERE;
+
+	offset = create_node(list, value);
+	if (offset == MAPPED_LIST_NOWHERE)
+		return MAPPED_LIST_NOWHERE;
+
+	link_nodes(list, header_of(list)->last, offset);
+	link_nodes(list, offset, MAPPED_LIST_NOWHERE);
+
+	return offset;
+}
+
+
+uint64_t mapped_list_prepend(mapped_list * list, void const * value)
+{
+	uint64_t offset;
+
+	if (list == NULL || value == NULL)
+		return MAPPED_LIST_NOWHERE;
+
+	offset = create_node(list, value);
+	if (offset == MAPPED_LIST_NOWHERE)
+		return MAPPED_LIST_NOWHERE;
+
+	link_nodes(list, offset, header_of(list)->first);
+	link_nodes(list, MAPPED_LIST_NOWHERE, offset);
+
+	return offset;
+}
+
+
+uint64_t mapped_list_remove(mapped_list * list, uint64_t offset)
+{
+	uint64_t next;
+
+	if (list == NULL || ! is_valid_offset(list, offset))
+		return MAPPED_LIST_NOWHERE;
+
+	next = node_at(list, offset)->next;
+	link_nodes(list, node_at(list, offset)->previous, next);
+	header_of(list)->size--;
+
+	release_node(list, offset);
+
+	return next;
+}
+
+
+uint64_t mapped_list_head(mapped_list const * list)
+{
+	if (list == NULL)
+		return MAPPED_LIST_NOWHERE;
+
+	return header_of(list)->first;
+}
+
+
+uint64_t mapped_list_tail(mapped_list const * list)
+{
+	if (list == NULL)
+		return MAPPED_LIST_NOWHERE;
+
+	return header_of(list)->last;
+}
+
+
+uint64_t mapped_list_next(mapped_list const * list, uint64_t offset)
+{
+	if (list == NULL || ! is_valid_offset(list, offset))
+		return MAPPED_LIST_NOWHERE;
+
+	return node_at(list, offset)->next;
+}
+
+
+uint64_t mapped_list_previous(mapped_list const * list, uint64_t offset)
+{
+	if (list == NULL || ! is_valid_offset(list, offset))
+		return MAPPED_LIST_NOWHERE;
+
+	return node_at(list, offset)->previous;
+}
+
+
+void * mapped_list_content(mapped_list const * list, uint64_t offset)
+{
+	if (list == NULL || ! is_valid_offset(list, offset))
+		return NULL;
+
+	return node_at(list, offset) + 1;
+}
+
+
+void * mapped_list_reduce(
+	mapped_list const * list,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * value))
+{
+	uint64_t offset;
+
+	if (list == NULL || reducer == NULL)
+		return accumulator;
+
+	for (offset = header_of(list)->first;
+		offset != MAPPED_LIST_NOWHERE;
+		offset = node_at(list, offset)->next)
+		reducer(accumulator, node_at(list, offset) + 1);
+
+	return accumulator;
+}
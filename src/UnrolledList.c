@@ -0,0 +1,350 @@
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../include/UnrolledList.h"
+
+
+/**
+ * @brief - how many values a node holds, chosen so a node fills 2 cache lines
+ */
+#define UNROLLED_NODE_CAPACITY 13
+
+
+
+
+struct unrolled_node
+{
+	/**
+	 * @brief - the previous node, NULL if none
+	 */
+	unrolled_node * previous;
+
+	/**
+	 * @brief - the next node, NULL if none
+	 */
+	unrolled_node * next;
+
+	/**
+	 * @brief - how many values are stored in the node, never 0
+	 */
+	size_t count;
+
+	/**
+	 * @brief - the values stored in the node, in order
+	 */
+	void * values[UNROLLED_NODE_CAPACITY];
+};
+
+
+struct unrolled_list
+{
+	/**
+	 * @brief - the first node of the list, NULL if empty
+	 */
+	unrolled_node * first_node;
+
+	/**
+	 * @brief - the last node of the list, NULL if empty
+	 */
+	unrolled_node * last_node;
+
+	/**
+	 * @brief - how many values are stored in the list
+	 */
+	size_t size;
+};
+
+
+
+
+/**
+ * @brief - creates a node without any value
+ *
+ * @return unrolled_node * - the created node, NULL if allocation failed
+ */
+static unrolled_node * create_empty_node(void)
+{
+	return calloc(1, sizeof(unrolled_node));
+}
+
+
+/**
+ * @brief - link 2 nodes
+ *
+ * @param before - the previous node
+ * @param after - the next node
+ */
+static void link_nodes(unrolled_node * before, unrolled_node * after)
+{
+	if (before != NULL)
+		before->next = after;
+	if (after != NULL)
+		after->previous = before;
+}
+
+
+/**
+ * @brief - unlinks the node from the list and deletes it
+ *
+ * @param list - the list the node belongs to
+ * @param node - the node to delete
+ */
+static void delete_node(unrolled_list * list, unrolled_node * node)
+{
+	link_nodes(node->previous, node->next);
+
+	if (list->first_node == node)
+		list->first_node = node->next;
+	if (list->last_node == node)
+		list->last_node = node->previous;
+
+	free(node);
+}
+
+
+/**
+ * @brief - moves the values of the next node into the given one and deletes
+ * 	the next node, if they both fit in a single node
+ *
+ * @param list - the list the node belongs to
+ * @param node - the node to merge the next one into
+ */
+static void merge_with_next_node(unrolled_list * list, unrolled_node * node)
+{
+	unrolled_node * next = node->next;
+
+	if (next == NULL || node->count + next->count > UNROLLED_NODE_CAPACITY)
+		return;
+
+	memcpy(
+		node->values + node->count,
+		next->values,
+		next->count * sizeof(void *));
+	node->count += next->count;
+
+	delete_node(list, next);
+}
+
+
+/**
+ * @brief - creates a cursor pointing nowhere
+ *
+ * @return unrolled_cursor - the cursor
+ */
+static unrolled_cursor nowhere(void)
+{
+	unrolled_cursor cursor;
+
+	cursor.node = NULL;
+	cursor.index = 0;
+
+	return cursor;
+}
+
+
+
+
+unrolled_list * unrolled_list_create(void)
+{
+	return calloc(1, sizeof(unrolled_list));
+}
+
+
+void unrolled_list_delete(unrolled_list ** list)
+{
+	unrolled_node * node;
+	unrolled_node * next;
+
+	if (list == NULL || * list == NULL)
+		return;
+
+	node = (* list)->first_node;
+	while (node != NULL)
+	{
+		next = node->next;
+		free(node);
+		node = next;
+	}
+
+	free(* list);
+	* list = NULL;
+}
+
+
+size_t unrolled_list_size(unrolled_list const * list)
+{
+	if (list == NULL)
+		return 0;
+
+	return list->size;
+}
+
+
+void unrolled_list_append(unrolled_list * list, void * value)
+{
+	unrolled_node * tail;
+
+	if (list == NULL)
+		return;
+
+	tail = list->last_node;
+	if (tail == NULL || tail->count == UNROLLED_NODE_CAPACITY)
+	{
+		tail = create_empty_node();
+		if (tail == NULL)
+			return;
+
+		link_nodes(list->last_node, tail);
+		list->last_node = tail;
+		if (list->first_node == NULL)
+			list->first_node = tail;
+	}
+
+	tail->values[tail->count++] = value;
+	list->size++;
+}
+
+
+void unrolled_list_prepend(unrolled_list * list, void * value)
+{
+	unrolled_node * head;
+
+	if (list == NULL)
+		return;
+
+	head = list->first_node;
+	if (head == NULL || head->count == UNROLLED_NODE_CAPACITY)
+	{
+		head = create_empty_node();
+		if (head == NULL)
+			return;
+
+		link_nodes(head, list->first_node);
+		list->first_node = head;
+		if (list->last_node == NULL)
+			list->last_node = head;
+	}
+
+	memmove(head->values + 1, head->values, head->count * sizeof(void *));
+	head->values[0] = value;
+	head->count++;
+	list->size++;
+}
+
+
+void unrolled_list_remove(unrolled_list * list, unrolled_cursor * cursor)
+{
+	unrolled_node * node;
+	size_t index;
+
+	if (list == NULL || cursor == NULL || cursor->node == NULL)
+		return;
+
+	node = cursor->node;
+	index = cursor->index;
+
+	node->count--;
+	memmove(
+		node->values + index,
+		node->values + index + 1,
+		(node->count - index) * sizeof(void *));
+	list->size--;
+
+	if (node->count == 0)
+	{
+		cursor->node = node->next;
+		cursor->index = 0;
+		delete_node(list, node);
+		return;
+	}
+
+	if (node->count < UNROLLED_NODE_CAPACITY / 2)
+		merge_with_next_node(list, node);
+
+	if (index == node->count)
+		* cursor = unrolled_list_next(* cursor);
+}
+
+
+unrolled_cursor unrolled_list_head(unrolled_list const * list)
+{
+	unrolled_cursor cursor = nowhere();
+
+	if (list == NULL)
+		return cursor;
+
+	cursor.node = list->first_node;
+	return cursor;
+}
+
+
+unrolled_cursor unrolled_list_tail(unrolled_list const * list)
+{
+	unrolled_cursor cursor = nowhere();
+
+	if (list == NULL || list->last_node == NULL)
+		return cursor;
+
+	cursor.node = list->last_node;
+	cursor.index = list->last_node->count - 1;
+	return cursor;
+}
+
+
+unrolled_cursor unrolled_list_next(unrolled_cursor cursor)
+{
+	if (cursor.node == NULL)
+		return cursor;
+
+	if (++cursor.index < cursor.node->count)
+		return cursor;
+
+	cursor.node = cursor.node->next;
+	cursor.index = 0;
+	return cursor;
+}
+
+
+unrolled_cursor unrolled_list_previous(unrolled_cursor cursor)
+{
+	if (cursor.node == NULL)
+		return cursor;
+
+	if (cursor.index-- > 0)
+		return cursor;
+
+	cursor.node = cursor.node->previous;
+	cursor.index = (cursor.node != NULL) ? cursor.node->count - 1 : 0;
+	return cursor;
+}
+
+
+void * unrolled_list_content(unrolled_cursor cursor)
+{
+	if (cursor.node == NULL)
+		return NULL;
+
+	return cursor.node->values[cursor.index];
+}
+
+
+void * unrolled_list_reduce(
+	unrolled_list const * list,
+	void * accumulator,
+	void (* reducer)(void * accumulator, void const * value))
+{
+	unrolled_node const * node;
+	size_t index;
+
+	if (list == NULL)
+		return accumulator;
+
+	for (node = list->first_node; node != NULL; node = node->next)
+	{
+		for (index = 0; index < node->count; index++)
+			reducer(accumulator, node->values[index]);
+	}
+
+	return accumulator;
+}
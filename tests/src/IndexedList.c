@@ -0,0 +1,215 @@
+
+#include <criterion/criterion.h>
+#include <string.h>
+
+#include "../../include/IndexedList.h"
+
+
+
+
+static void store_values_in_buffer_reducer(
+	void * accumulator,
+	void const * value)
+{
+	char * buffer = accumulator;
+
+	buffer[strlen(buffer)] = ((char *) value)[0];
+}
+
+
+
+
+Test(indexed_list, is_empty_on_creation)
+{
+	// given a new list
+	indexed_list * list = indexed_list_create();
+
+	// when checking its size
+	size_t size = indexed_list_size(list);
+
+	// then it should be 0
+	cr_assert_eq(size, 0, "list is not empty");
+	cr_assert_eq(
+		indexed_list_head(list),
+		INDEXED_LIST_NOWHERE,
+		"empty list has a head");
+}
+
+
+Test(indexed_list, append_and_prepend_keep_order)
+{
+	// given an empty list
+	indexed_list * list = indexed_list_create();
+
+	// when adding values from both ends
+	indexed_list_append(list, "2");
+	indexed_list_append(list, "3");
+	indexed_list_prepend(list, "1");
+
+	// then every value should be visited in order
+	char callback_buffer[4] = { 0 };
+	indexed_list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("123", callback_buffer, "values aren't in order");
+	cr_assert_eq(indexed_list_size(list), 3, "size doesn't match");
+}
+
+
+Test(indexed_list, positions_walk_both_ways)
+{
+	// given a list of 3 values
+	indexed_list * list = indexed_list_create();
+	uint32_t first = indexed_list_append(list, "1");
+	uint32_t second = indexed_list_append(list, "2");
+	uint32_t third = indexed_list_append(list, "3");
+
+	// when moving from the head to the tail and back
+	uint32_t forward = indexed_list_next(list, indexed_list_next(list, first));
+	uint32_t backward = indexed_list_previous(list, third);
+
+	// then positions should follow the links
+	cr_assert_eq(forward, third, "next doesn't follow the links");
+	cr_assert_eq(backward, second, "previous doesn't follow the links");
+	cr_assert_eq(indexed_list_tail(list), third, "wrong tail");
+}
+
+
+Test(indexed_list, remove_returns_next_position_and_reuses_slot)
+{
+	// given a list of 3 values
+	indexed_list * list = indexed_list_create();
+	indexed_list_append(list, "1");
+	uint32_t second = indexed_list_append(list, "2");
+	uint32_t third = indexed_list_append(list, "3");
+
+	// when removing the middle one then appending another value
+	uint32_t next = indexed_list_remove(list, second);
+	uint32_t reused = indexed_list_append(list, "4");
+
+	// then the removed slot should be reused
+	cr_assert_eq(next, third, "remove didn't return the next position");
+	cr_assert_eq(reused, second, "removed slot wasn't reused");
+	char callback_buffer[4] = { 0 };
+	indexed_list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("134", callback_buffer, "values aren't in order");
+}
+
+
+Test(indexed_list, removed_position_has_no_content)
+{
+	// given a list of 2 values
+	indexed_list * list = indexed_list_create();
+	uint32_t first = indexed_list_append(list, "1");
+	indexed_list_append(list, "2");
+
+	// when removing the first one
+	indexed_list_remove(list, first);
+
+	// then its position shouldn't lead anywhere anymore
+	cr_assert_null(indexed_list_content(list, first), "removed node has a value");
+	cr_assert_eq(
+		indexed_list_remove(list, first),
+		INDEXED_LIST_NOWHERE,
+		"removed node was removed twice");
+	cr_assert_eq(indexed_list_size(list), 1, "size was decremented twice");
+}
+
+
+Test(indexed_list, compact_renumbers_nodes_in_traversal_order)
+{
+	// given a list whose slots are out of order
+	indexed_list * list = indexed_list_create();
+	indexed_list_append(list, "3");
+	uint32_t removed = indexed_list_append(list, "x");
+	indexed_list_prepend(list, "2");
+	indexed_list_prepend(list, "1");
+	indexed_list_remove(list, removed);
+
+	// when compacting it
+	int compacted = indexed_list_compact(list);
+
+	// then each node should be stored at its rank in the list
+	cr_assert(compacted, "list wasn't compacted");
+	for (uint32_t position = 0; position < 3; position++)
+	{
+		char expected[2] = { (char) ('1' + position), '\0' };
+		cr_assert_str_eq(
+			indexed_list_content(list, position),
+			expected,
+			"node isn't stored at its rank");
+	}
+	cr_assert_eq(indexed_list_head(list), 0, "head isn't the first slot");
+	cr_assert_eq(indexed_list_tail(list), 2, "tail isn't the last slot");
+}
+
+
+Test(indexed_list, reduce_after_compaction_and_appends_keeps_order)
+{
+	// given a compacted list
+	indexed_list * list = indexed_list_create();
+	indexed_list_prepend(list, "2");
+	indexed_list_prepend(list, "1");
+	indexed_list_compact(list);
+
+	// when appending values, removing the tail then appending again
+	indexed_list_append(list, "3");
+	uint32_t tail = indexed_list_append(list, "x");
+	indexed_list_remove(list, tail);
+	indexed_list_append(list, "4");
+
+	// then values should still be visited in order
+	char callback_buffer[5] = { 0 };
+	indexed_list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("1234", callback_buffer, "values aren't in order");
+}
+
+
+Test(indexed_list, compact_empty_list_doesnt_crash)
+{
+	// given an emptied list
+	indexed_list * list = indexed_list_create();
+	indexed_list_remove(list, indexed_list_append(list, "1"));
+
+	// when compacting it
+	indexed_list_compact(list);
+
+	// then it should still be usable
+	indexed_list_append(list, "2");
+	cr_assert_str_eq(
+		indexed_list_content(list, indexed_list_head(list)),
+		"2",
+		"list isn't usable after compaction");
+}
+
+
+Test(indexed_list, delete_sets_list_to_null)
+{
+	// given a list with a few values
+	indexed_list * list = indexed_list_create();
+	indexed_list_append(list, "1");
+	indexed_list_append(list, "2");
+
+	// when deleting it
+	indexed_list_delete(& list);
+
+	// then it should have been set to NULL
+	cr_assert_null(list, "list hasn't been freed and set to NULL");
+}
+
+
+Test(indexed_list, many_appends_grow_the_array)
+{
+	// given an empty list
+	indexed_list * list = indexed_list_create();
+
+	// when appending more values than the initial capacity
+	for (int index = 0; index < 1000; index++)
+		indexed_list_append(list, "v");
+
+	// then every node should be reachable
+	size_t count = 0;
+	for (uint32_t position = indexed_list_head(list);
+		position != INDEXED_LIST_NOWHERE;
+		position = indexed_list_next(list, position))
+		count++;
+	cr_assert_eq(count, 1000, "not every node is reachable");
+}
@@ -1,16 +1,21 @@
 
 #include <criterion/criterion.h>
 #include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
 #include <time.h>
 
+#include "../../include/IntrusiveList.h"
 #include "../../include/List.h"
+#include "../../include/ListInline.h"
 
 #include "utils.h"
 
 /**
  * Some operations are in constant time O(1), but involve big lists to test
  * Those tests are disabled by default, since there's no reason they would go
- * back to O(n) complexity
+ * back to O(n) complexity, timings are tracked by make bench instead
  */
 // #define DO_CONSTANT_TIME_BENCHMARK_TESTS
 
@@ -515,6 +520,1221 @@ Test(linked_list, prepend_adds_at_the_beginning)
 }
 
 
+Test(linked_list, prepend_links_new_head_to_old_head)
+{
+	// given a list with a few elements
+	linked_list * list = small_list();
+	linked_list * old_head = list_head(list);
+
+	// when prepending another one
+	list_prepend(& list, "foo");
+
+	// then the old head should follow the new one
+	linked_list * new_head = list_head(list);
+	cr_assert_eq(list_next(new_head), old_head, "old head isn't after new one");
+	cr_assert_eq(list_previous(old_head), new_head, "new head isn't before old one");
+}
+
+
+Test(linked_list, pooled_is_empty_on_creation)
+{
+	// given a new pooled list
+	linked_list * list = list_create_pooled(0);
+
+	// when checking its size
+	size_t size = list_size(list);
+
+	// then it should be 0
+	cr_assert_eq(size, 0, "pooled list is not empty");
+	cr_assert_null(list_head(list), "empty pooled list has a head");
+}
+
+
+Test(linked_list, pooled_reduce_on_empty_list_visits_nothing)
+{
+	// given a new pooled list
+	linked_list * list = list_create_pooled(0);
+
+	// when applying a callback to its nodes
+	char callback_buffer[3] = { 0 };
+	list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+
+	// then no node should have been visited
+	cr_assert_str_eq("", callback_buffer, "anchor of pooled list was visited");
+}
+
+
+Test(linked_list, pooled_append_becomes_the_list)
+{
+	// given an empty pooled list
+	linked_list * list = list_create_pooled(0);
+
+	// when appending a value
+	list_append(& list, "first");
+
+	// then the list should start on that value
+	cr_assert_eq(list_size(list), 1, "length wasn't incremented");
+	cr_assert_eq(list_head(list), list, "list isn't its head");
+	cr_assert_str_eq(list_content(list), "first", "value wasn't stored");
+}
+
+
+Test(linked_list, pooled_keeps_appending_order_across_chunks)
+{
+	// given a pooled list with tiny chunks
+	linked_list * list = list_create_pooled(2);
+
+	// when appending more values than a chunk holds
+	list_append(& list, "1");
+	list_append(& list, "2");
+	list_append(& list, "3");
+	list_prepend(& list, "0");
+
+	// then every value should be reachable in order
+	char callback_buffer[5] = { 0 };
+	list_reduce(list_head(list), callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("0123", callback_buffer, "order was broken by chunks");
+	cr_assert_eq(list_size(list), 4, "size doesn't match appended nodes");
+}
+
+
+Test(linked_list, pooled_reuses_removed_nodes)
+{
+	// given a pooled list with a few elements
+	linked_list * list = list_create_pooled(0);
+	list_append(& list, "head");
+	list_append(& list, "tail");
+
+	// when removing the tail and appending another value
+	linked_list * old_tail = list_tail(list);
+	linked_list * node_to_remove = old_tail;
+	list_remove_node(& node_to_remove);
+	list_append(& list, "new tail");
+
+	// then the removed node should have been reused
+	cr_assert_eq(list_tail(list), old_tail, "removed node wasn't reused");
+	cr_assert_str_eq(list_content(old_tail), "new tail", "wrong value");
+}
+
+
+Test(linked_list, pooled_remove_last_node_makes_it_empty)
+{
+	// given a pooled list of 1 element
+	linked_list * list = list_create_pooled(0);
+	list_append(& list, "1");
+
+	// when removing it
+	list_remove_node(& list);
+
+	// then the list should be empty, led to by its anchor
+	cr_assert_not_null(list, "emptied pooled list wasn't handed back");
+	cr_assert_eq(list_size(list), 0, "pooled list is not empty");
+	cr_assert_null(list_head(list), "emptied pooled list has a head");
+	list_delete(& list);
+}
+
+
+Test(linked_list, emptied_pooled_list_keeps_its_pool)
+{
+	// given a pooled list, emptied node by node
+	linked_list * list = list_create_pooled(0);
+	list_append(& list, "1");
+	list_append(& list, "2");
+	linked_list * first = list;
+	linked_list * second = list_next(list);
+	list_remove_node(& list);
+	list_remove_node(& list);
+
+	// when adding to it again
+	list_append(& list, "3");
+	list_append(& list, "4");
+
+	// then the removed nodes should be reused
+	cr_assert_eq(list_size(list), 2, "wrong size");
+	cr_assert(list == first || list == second, "pool was dropped");
+	cr_assert(list_next(list) == first || list_next(list) == second, "pool was dropped");
+	list_delete(& list);
+}
+
+Test(linked_list, pooled_delete_sets_list_to_null)
+{
+	// given a pooled list with a few elements
+	linked_list * list = list_create_pooled(2);
+	list_append(& list, "1");
+	list_append(& list, "2");
+	list_append(& list, "3");
+
+	// when deleting the list from a middle node
+	linked_list * middle_node = list_next(list);
+	list_delete(& middle_node);
+
+	// then the node should have been set to NULL
+	cr_assert_null(middle_node, "node hasn't been freed and set to NULL");
+}
+
+
+Test(linked_list, deleting_empty_pooled_doesnt_crash)
+{
+	// given an empty pooled list
+	linked_list * empty_list = list_create_pooled(0);
+
+	// when deleting it
+	list_delete(& empty_list);
+
+	// then it should have been set to NULL
+	cr_assert_null(empty_list, "empty pooled list wasn't set to NULL");
+}
+
+
+typedef struct allocations_counter
+{
+	size_t allocations;
+	size_t releases;
+} allocations_counter;
+
+
+static void * counting_allocate(size_t size, void * context)
+{
+	((allocations_counter *) context)->allocations++;
+	return malloc(size);
+}
+
+
+static void counting_release(void * memory, void * context)
+{
+	((allocations_counter *) context)->releases++;
+	free(memory);
+}
+
+
+Test(linked_list, allocator_provides_header_and_nodes)
+{
+	// given a list with a counting allocator
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * list = list_create_with_allocator(& allocator);
+
+	// when adding a few elements
+	list_append(& list, "1");
+	list_append(& list, "2");
+	list_prepend(& list, "0");
+
+	// then the header and every node should come from the allocator
+	cr_assert_eq(counter.allocations, 4, "allocator wasn't used for every node");
+}
+
+
+Test(linked_list, allocator_gets_back_everything_on_delete)
+{
+	// given a list with a counting allocator and a few elements
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * list = list_create_with_allocator(& allocator);
+	list_append(& list, "1");
+	list_append(& list, "2");
+	list_append(& list, "3");
+
+	// when removing a node then deleting the list
+	linked_list * second_node = list_next(list);
+	list_remove_node(& second_node);
+	list_delete(& list);
+
+	// then every allocation should have been released
+	cr_assert_eq(
+		counter.allocations,
+		counter.releases,
+		"some memory wasn't given back to the allocator");
+}
+
+
+Test(linked_list, emptied_allocator_list_keeps_its_allocator)
+{
+	// given a list with a counting allocator, emptied node by node
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * list = list_create_with_allocator(& allocator);
+	list_append(& list, "1");
+	list_append(& list, "2");
+	list_remove_node(& list);
+	list_remove_node(& list);
+
+	// when adding to it again
+	cr_assert_not_null(list, "emptied list wasn't handed back");
+	cr_assert_eq(list_size(list), 0, "emptied list isn't empty");
+	size_t allocations = counter.allocations;
+	list_append(& list, "3");
+
+	// then the new node should still come from the allocator, which gets everything back
+	cr_assert_eq(counter.allocations, allocations + 1, "allocator was forgotten");
+	cr_assert_str_eq(list_content(list), "3", "list doesn't start on the new value");
+	list_delete(& list);
+	cr_assert_eq(counter.allocations, counter.releases, "some memory wasn't given back");
+}
+
+Test(linked_list, allocator_without_allocate_function_is_rejected)
+{
+	// given an allocator without allocation function
+	list_allocator allocator = { NULL, NULL, NULL };
+
+	// when creating a list with it
+	linked_list * list = list_create_with_allocator(& allocator);
+
+	// then no list should be created
+	cr_assert_null(list, "list was created without allocation function");
+}
+
+
+typedef struct bump_arena
+{
+	char memory[4096];
+	size_t used;
+} bump_arena;
+
+
+static void * bump_allocate(size_t size, void * context)
+{
+	bump_arena * arena = context;
+	void * memory = arena->memory + arena->used;
+
+	arena->used += (size + 15) & ~(size_t) 15;
+	return arena->used <= sizeof(arena->memory) ? memory : NULL;
+}
+
+
+Test(linked_list, arena_list_lives_in_the_arena)
+{
+	// given a list backed by an arena which can't release memory
+	bump_arena arena = { .used = 0 };
+	list_allocator allocator = { bump_allocate, NULL, & arena };
+	linked_list * list = list_create_with_allocator(& allocator);
+
+	// when adding a few elements
+	list_append(& list, "1");
+	list_append(& list, "2");
+
+	// then nodes should be stored in the arena
+	char * first_node = (char *) list_head(list);
+	cr_assert(
+		first_node >= arena.memory && first_node < arena.memory + arena.used,
+		"node wasn't allocated in the arena");
+	cr_assert_str_eq(list_content(list_tail(list)), "2", "wrong value");
+}
+
+
+Test(linked_list, deleting_big_list_doesnt_overflow_the_stack)
+{
+	// given a list with millions of elements
+	linked_list * list = big_list();
+
+	// when deleting it from its middle
+	for (size_t index = 0; index < BIG_LIST_SIZE / 2; index++)
+		list = list_next(list);
+	list_delete(& list);
+
+	// then it shouldn't crash
+	cr_assert_null(list, "node hasn't been freed and set to NULL");
+}
+
+
+Test(linked_list, append_array_to_empty_keeps_array_order)
+{
+	// given an empty list
+	linked_list * list = list_create();
+
+	// when appending an array of values
+	void * values[] = { "1", "2", "3" };
+	list_append_array(& list, values, 3);
+
+	// then every value should be stored in array order
+	char callback_buffer[4] = { 0 };
+	list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("123", callback_buffer, "array order wasn't kept");
+	cr_assert_eq(list_size(list), 3, "size doesn't match the array");
+	cr_assert_eq(list_head(list), list, "list isn't its head");
+}
+
+
+Test(linked_list, append_array_adds_after_the_tail)
+{
+	// given a list with a few elements
+	linked_list * list = small_list();
+	size_t previous_size = list_size(list);
+
+	// when appending an array of values
+	void * values[] = { "foo", "bar" };
+	list_append_array(& list, values, 2);
+
+	// then they should be the last nodes
+	linked_list * tail = list_tail(list);
+	cr_assert_str_eq(list_content(tail), "bar", "last value isn't the tail");
+	cr_assert_str_eq(list_content(list_previous(tail)), "foo", "wrong order");
+	cr_assert_eq(list_size(list), previous_size + 2, "size wasn't updated");
+	cr_assert_eq(list_size_forward(list), previous_size + 2, "broken links");
+}
+
+
+Test(linked_list, prepend_array_adds_before_the_head_in_array_order)
+{
+	// given a list of 1 element
+	linked_list * list = list_create();
+	list_append(& list, "3");
+
+	// when prepending an array of values
+	void * values[] = { "1", "2" };
+	list_prepend_array(& list, values, 2);
+
+	// then they should come first, in array order
+	char callback_buffer[4] = { 0 };
+	list_reduce(list_head(list), callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("123", callback_buffer, "values weren't put first");
+	cr_assert_eq(list_size_backward(list), 3, "broken links");
+}
+
+
+Test(linked_list, insert_array_after_node_goes_in_the_middle)
+{
+	// given a list of 2 elements
+	linked_list * list = list_create();
+	list_append(& list, "1");
+	list_append(& list, "4");
+
+	// when inserting an array of values after the first node
+	void * values[] = { "2", "3" };
+	list_insert_array_after(list, values, 2);
+
+	// then they should be between both nodes
+	char callback_buffer[5] = { 0 };
+	list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("1234", callback_buffer, "values weren't inserted");
+	cr_assert_eq(list_size(list), 4, "size wasn't updated");
+}
+
+
+Test(linked_list, insert_array_after_tail_moves_the_tail)
+{
+	// given a pooled list with a few elements
+	linked_list * list = list_create_pooled(2);
+	list_append(& list, "1");
+	list_append(& list, "2");
+
+	// when inserting an array of values after the tail
+	void * values[] = { "3", "4", "5" };
+	list_insert_array_after(list_tail(list), values, 3);
+
+	// then the last value should be the new tail
+	cr_assert_str_eq(list_content(list_tail(list)), "5", "tail wasn't moved");
+	cr_assert_eq(list_size(list), 5, "size wasn't updated");
+}
+
+
+Test(linked_list, append_array_to_allocator_list_releases_every_node)
+{
+	// given a list with a counting allocator and a few elements
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * list = list_create_with_allocator(& allocator);
+	list_append(& list, "1");
+
+	// when appending an array then removing one of its nodes and deleting
+	void * values[] = { "2", "3", "4" };
+	list_append_array(& list, values, 3);
+	linked_list * node_to_remove = list_next(list);
+	list_remove_node(& node_to_remove);
+	list_delete(& list);
+
+	// then every allocation should have been released
+	cr_assert_eq(
+		counter.allocations,
+		counter.releases,
+		"some memory wasn't given back to the allocator");
+}
+
+
+Test(linked_list, append_array_to_allocator_list_allocates_nodes_at_once)
+{
+	// given a list with a counting allocator and a few elements
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * list = list_create_with_allocator(& allocator);
+	list_append(& list, "1");
+	size_t allocations = counter.allocations;
+
+	// when appending an array of many values
+	void * values[64];
+	for (size_t index = 0; index < 64; index++)
+		values[index] = "2";
+	list_append_array(& list, values, 64);
+
+	// then its nodes should come from a few allocations, not one per value
+	cr_assert_lt(
+		counter.allocations - allocations,
+		5,
+		"nodes of the array were allocated one by one");
+	cr_assert_eq(list_size(list), 65, "size wasn't updated");
+	list_delete(& list);
+	cr_assert_eq(counter.allocations, counter.releases, "memory was leaked");
+}
+
+
+Test(linked_list, append_empty_array_has_no_effect)
+{
+	// given an empty list
+	linked_list * list = list_create();
+
+	// when appending an empty array
+	list_append_array(& list, NULL, 0);
+
+	// then the list should still be empty
+	cr_assert_null(list, "a list was created without values");
+}
+
+
+typedef struct hooked_item
+{
+	char const * name;
+	list_hook hook;
+} hooked_item;
+
+
+static void store_hooked_names_in_buffer_reducer(
+	void * accumulator,
+	void const * hook)
+{
+	hooked_item const * item = list_container_of(hook, hooked_item, hook);
+	char * buffer = accumulator;
+
+	buffer[strlen(buffer)] = item->name[0];
+}
+
+
+Test(linked_list, hooks_are_reachable_in_order)
+{
+	// given a few structures embedding a hook
+	hooked_item first = { .name = "1" };
+	hooked_item second = { .name = "2" };
+	hooked_item third = { .name = "3" };
+
+	// when adding them to a list from both ends
+	linked_list * list = list_create();
+	list_append_hook(& list, & second.hook);
+	list_append_hook(& list, & third.hook);
+	list_prepend_hook(& list, & first.hook);
+
+	// then every structure should be reachable in order
+	char callback_buffer[4] = { 0 };
+	list_reduce(
+		list_head(list),
+		callback_buffer,
+		store_hooked_names_in_buffer_reducer);
+	cr_assert_str_eq("123", callback_buffer, "hooks aren't in order");
+	cr_assert_eq(list_size(list), 3, "size doesn't match hooks count");
+}
+
+
+Test(linked_list, container_of_hook_gives_the_structure)
+{
+	// given a list holding a hooked structure
+	hooked_item item = { .name = "item" };
+	linked_list * list = list_create();
+	list_append_hook(& list, & item.hook);
+
+	// when getting the structure back from the list
+	hooked_item * container = list_container_of(list, hooked_item, hook);
+
+	// then it should be the original structure
+	cr_assert_eq(container, & item, "wrong structure");
+}
+
+
+Test(linked_list, removing_hook_unlinks_without_releasing)
+{
+	// given a list mixing hooks and regular nodes
+	hooked_item first = { .name = "1" };
+	hooked_item second = { .name = "2" };
+	linked_list * list = list_create();
+	list_append_hook(& list, & first.hook);
+	list_append(& list, "regular");
+	list_append_hook(& list, & second.hook);
+
+	// when removing the first hook
+	linked_list * node_to_remove = list;
+	list_remove_node(& node_to_remove);
+
+	// then the hook should be unlinked and the structure still usable
+	cr_assert_eq(list_size(node_to_remove), 2, "length wasn't decremented");
+	cr_assert_str_eq(first.name, "1", "hooked structure was released");
+	cr_assert_eq(
+		list_tail(node_to_remove),
+		& second.hook,
+		"last hook isn't the tail anymore");
+
+	list_delete(& node_to_remove);
+}
+
+
+#define NUMBERS_COUNT 100000
+
+
+static int numbers[NUMBERS_COUNT];
+
+
+static linked_list * numbers_list(void)
+{
+	linked_list * list = list_create();
+
+	for (int index = 0; index < NUMBERS_COUNT; index++)
+	{
+		numbers[index] = index;
+		list_append(& list, & numbers[index]);
+	}
+
+	return list;
+}
+
+
+Test(linked_list, to_array_copies_values_in_order)
+{
+	// given a big list of numbers, with a few prepended
+	linked_list * list = numbers_list();
+	static int prepended[] = { 7, 8 };
+	list_prepend(& list, & prepended[0]);
+	list_prepend(& list, & prepended[1]);
+
+	// when copying it into an array, from its tail
+	void ** values = list_to_array(list_tail(list));
+
+	// then the array should hold every value in list order
+	cr_assert_not_null(values, "no array was created");
+	cr_assert_eq(values[0], & prepended[1], "wrong first value");
+	cr_assert_eq(values[1], & prepended[0], "wrong second value");
+	for (int index = 0; index < NUMBERS_COUNT; index++)
+		cr_assert_eq(values[index + 2], & numbers[index], "wrong value at %d", index + 2);
+
+	free(values);
+}
+
+
+Test(linked_list, to_array_of_empty_list_is_null)
+{
+	// given an empty list and an empty pooled list
+	linked_list * list = list_create();
+	linked_list * pooled = list_create_pooled(0);
+
+	// when copying them into arrays
+	void ** values = list_to_array(list);
+	void ** pooled_values = list_to_array(pooled);
+
+	// then no array should be created
+	cr_assert_null(values, "array created from empty list");
+	cr_assert_null(pooled_values, "array created from empty pooled list");
+
+	list_delete(& pooled);
+}
+
+
+Test(linked_list, from_array_builds_list_in_order)
+{
+	// given an array of values
+	static int numbers_array[] = { 1, 2, 3, 4 };
+	void * values[] = {
+		& numbers_array[0], & numbers_array[1], & numbers_array[2], & numbers_array[3]
+	};
+
+	// when creating a list from it
+	linked_list * list = list_from_array(values, 4);
+
+	// then the list should hold the values in the same order
+	cr_assert_eq(list_size(list), 4, "wrong size");
+	linked_list * node = list_head(list);
+	for (int index = 0; index < 4; index++, node = list_next(node))
+		cr_assert_eq(list_content(node), values[index], "wrong value at %d", index);
+
+	list_delete(& list);
+}
+
+
+Test(linked_list, from_empty_array_is_empty_list)
+{
+	// given an empty array
+	void * values[] = { NULL };
+
+	// when creating a list from it
+	linked_list * list = list_from_array(values, 0);
+
+	// then the list should be empty
+	cr_assert_null(list, "list created from empty array");
+}
+
+
+
+static void assert_list_holds(linked_list * list, int const * expected, size_t count)
+{
+	cr_assert_eq(list_size(list), count, "wrong size");
+	linked_list * node = list_head(list);
+	for (size_t index = 0; index < count; index++, node = list_next(node))
+	{
+		cr_assert_not_null(node, "list ends at %zu", index);
+		cr_assert_eq(* (int *) list_content(node), expected[index], "wrong value at %zu", index);
+		cr_assert_eq(list_previous(list_next(node)), list_next(node) ? node : NULL, "broken link at %zu", index);
+	}
+	cr_assert_null(node, "list goes on");
+	cr_assert_eq(* (int *) list_content(list_tail(list)), expected[count - 1], "wrong tail");
+}
+
+
+static int ranks[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+
+static linked_list * ranks_list(list_allocator const * allocator, size_t from, size_t to)
+{
+	linked_list * list = allocator ? list_create_with_allocator(allocator) : list_create();
+	for (size_t index = from; index < to; index++)
+		list_append(& list, & ranks[index]);
+	return list;
+}
+
+
+Test(linked_list, concat_moves_every_node_of_the_other_list)
+{
+	// given 2 lists, and a node of the second one
+	linked_list * list = ranks_list(NULL, 0, 4);
+	linked_list * other = ranks_list(NULL, 4, 10);
+	linked_list * moved = list_next(other);
+
+	// when concatenating them
+	int concatenated = list_concat(& list, & other);
+
+	// then the first one should hold every node, reachable from any of them
+	cr_assert(concatenated, "lists weren't concatenated");
+	cr_assert_null(other, "other list wasn't taken");
+	assert_list_holds(list, ranks, 10);
+	cr_assert_eq(list_size(moved), 10, "moved node isn't bound to the list");
+	cr_assert_eq(list_head(moved), list, "moved node leads to another head");
+	list_delete(& moved);
+}
+
+
+Test(linked_list, concatenated_lists_give_back_everything_on_delete)
+{
+	// given lists with a same counting allocator, concatenated several times
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * first = ranks_list(& allocator, 0, 3);
+	linked_list * second = ranks_list(& allocator, 3, 6);
+	linked_list * third = ranks_list(& allocator, 6, 10);
+	linked_list * empty = list_create_with_allocator(& allocator);
+	cr_assert(list_concat(& second, & third), "lists weren't concatenated");
+	cr_assert(list_concat(& first, & second), "lists weren't concatenated");
+	cr_assert(list_concat(& first, & empty), "empty list wasn't concatenated");
+
+	// when removing nodes of every part, then deleting the list
+	linked_list * node_to_remove = list_tail(first);
+	list_remove_node(& node_to_remove);
+	node_to_remove = list_at(first, 4);
+	list_remove_node(& node_to_remove);
+	int const expected[] = { 0, 1, 2, 3, 5, 6, 7, 8 };
+	assert_list_holds(first, expected, 8);
+	list_delete(& first);
+
+	// then every allocation should have been released
+	cr_assert_eq(counter.allocations, counter.releases, "some memory wasn't given back");
+}
+
+
+Test(linked_list, concat_keeps_pooled_nodes_in_their_pool)
+{
+	// given 2 pooled lists
+	linked_list * list = list_create_pooled(2);
+	linked_list * other = list_create_pooled(2);
+	for (int index = 0; index < 5; index++)
+	{
+		list_append(& list, & ranks[index]);
+		list_append(& other, & ranks[index + 5]);
+	}
+
+	// when concatenating them, then reusing nodes of the other pool
+	cr_assert(list_concat(& list, & other), "lists weren't concatenated");
+	linked_list * node_to_remove = list_tail(list);
+	list_remove_node(& node_to_remove);
+	list_append(& list, & ranks[9]);
+
+	// then the list should go on as one
+	assert_list_holds(list, ranks, 10);
+	list_delete(& list);
+}
+
+
+Test(linked_list, concat_mixes_pooled_and_plain_lists)
+{
+	// given plain lists and pooled ones, one after the other
+	linked_list * list = ranks_list(NULL, 0, 2);
+	linked_list * pooled = list_create_pooled(2);
+	for (int index = 2; index < 5; index++)
+		list_append(& pooled, & ranks[index]);
+	linked_list * plain = ranks_list(NULL, 5, 7);
+	linked_list * other_pooled = list_create_pooled(0);
+	for (int index = 7; index < 10; index++)
+		list_append(& other_pooled, & ranks[index]);
+
+	// when concatenating them both ways, then removing and adding nodes of each kind
+	cr_assert(list_concat(& pooled, & plain), "plain list wasn't taken by a pooled one");
+	cr_assert(list_concat(& list, & pooled), "pooled list wasn't taken by a plain one");
+	cr_assert(list_concat(& list, & other_pooled), "pooled list wasn't taken by a plain one");
+	linked_list * node_to_remove = list_at(list, 1);
+	list_remove_node(& node_to_remove);
+	node_to_remove = list_at(list, 3);
+	list_remove_node(& node_to_remove);
+	list_insert_array_after(list_at(list, 2), (void * []) { & ranks[4] }, 1);
+	list_insert_array_after(list_head(list), (void * []) { & ranks[1] }, 1);
+
+	// then the list should go on as one, and give every node back on delete
+	assert_list_holds(list, ranks, 10);
+	list_delete(& list);
+}
+
+
+Test(linked_list, concat_refuses_lists_with_different_allocators)
+{
+	// given a pooled list and a list with its own allocator
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * pooled = list_create_pooled(0);
+	list_append(& pooled, & ranks[0]);
+	linked_list * other = ranks_list(& allocator, 1, 3);
+
+	// when concatenating them
+	int concatenated = list_concat(& pooled, & other);
+
+	// then both lists should be left as they were
+	cr_assert_not(concatenated, "lists were concatenated");
+	assert_list_holds(pooled, ranks, 1);
+	assert_list_holds(other, ranks + 1, 2);
+	list_delete(& pooled);
+	list_delete(& other);
+}
+
+
+Test(linked_list, arrays_made_lists_are_concatenated_and_split)
+{
+	// given a list appended to, and a list made from an array
+	void * values[5];
+	for (int index = 0; index < 5; index++)
+		values[index] = & ranks[index + 5];
+	linked_list * appended = ranks_list(NULL, 0, 5);
+	linked_list * from_array = list_from_array(values, 5);
+
+	// when concatenating them, then splitting the result
+	int concatenated = list_concat(& appended, & from_array);
+	linked_list * back = list_split_at(list_at(appended, 3));
+
+	// then both operations should have worked
+	cr_assert(concatenated, "lists weren't concatenated");
+	cr_assert_not_null(back, "list wasn't split");
+	assert_list_holds(appended, ranks, 3);
+	assert_list_holds(back, ranks + 3, 7);
+	list_delete(& appended);
+	list_delete(& back);
+}
+
+
+Test(linked_list, split_pooled_lists_share_their_chunks)
+{
+	// given a pooled list split in 2
+	linked_list * list = list_create_pooled(4);
+	for (int index = 0; index < 10; index++)
+		list_append(& list, & ranks[index]);
+	linked_list * back = list_split_at(list_at(list, 3));
+
+	// when deleting the first part, then using the other one
+	list_delete(& list);
+	linked_list * node_to_remove = list_tail(back);
+	list_remove_node(& node_to_remove);
+	list_append(& back, & ranks[9]);
+	list_prepend(& back, & ranks[2]);
+
+	// then the other part should still hold its nodes
+	assert_list_holds(back, ranks + 2, 8);
+	list_delete(& back);
+}
+
+
+Test(linked_list, splice_moves_pooled_nodes_to_plain_lists)
+{
+	// given a pooled list and a plain one
+	linked_list * pooled = list_create_pooled(2);
+	for (int index = 0; index < 6; index++)
+		list_append(& pooled, & ranks[index]);
+	linked_list * plain = ranks_list(NULL, 6, 10);
+
+	// when moving the tail of the pooled list to the head of the plain one, then deleting it
+	linked_list * first = list_at(pooled, 3);
+	int spliced = list_splice(& first, list_tail(pooled), list_at(plain, 0));
+	list_delete(& pooled);
+
+	// then the moved nodes should outlive their pooled list
+	cr_assert(spliced, "range wasn't spliced");
+	int const expected[] = { 6, 3, 4, 5, 7, 8, 9 };
+	assert_list_holds(plain, expected, 7);
+	list_delete(& plain);
+}
+
+
+Test(linked_list, split_at_makes_two_lists)
+{
+	// given a list of 10 nodes
+	linked_list * list = ranks_list(NULL, 0, 10);
+
+	// when splitting it near its end, then near its head
+	linked_list * back = list_split_at(list_at(list, 7));
+	linked_list * middle = list_split_at(list_at(list, 2));
+
+	// then each part should be a list of its own
+	assert_list_holds(list, ranks, 2);
+	assert_list_holds(middle, ranks + 2, 5);
+	assert_list_holds(back, ranks + 7, 3);
+	list_delete(& list);
+	list_delete(& middle);
+	list_delete(& back);
+}
+
+
+Test(linked_list, split_lists_give_back_everything_on_delete)
+{
+	// given a list with a counting allocator
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * list = ranks_list(& allocator, 0, 10);
+
+	// when splitting it at its head, near its head, then near its end
+	linked_list * whole = list_split_at(list);
+	linked_list * back = list_split_at(list_at(list, 1));
+	linked_list * tail = list_split_at(list_tail(back));
+
+	// then each part should be a list of its own, released with its nodes
+	cr_assert_eq(whole, list, "splitting at the head changed the list");
+	assert_list_holds(list, ranks, 1);
+	assert_list_holds(back, ranks + 1, 8);
+	assert_list_holds(tail, ranks + 9, 1);
+	list_delete(& list);
+	list_delete(& back);
+	list_delete(& tail);
+	cr_assert_eq(counter.allocations, counter.releases, "some memory wasn't given back");
+}
+
+
+Test(linked_list, splice_moves_a_range_to_another_list)
+{
+	// given 2 lists
+	linked_list * list = ranks_list(NULL, 0, 6);
+	linked_list * other = ranks_list(NULL, 6, 10);
+
+	// when moving the middle of the first one after the head of the second one
+	linked_list * first = list_at(list, 2);
+	int spliced = list_splice(& first, list_at(list, 4), other);
+
+	// then the range should have left its list for the other one
+	cr_assert(spliced, "range wasn't spliced");
+	cr_assert_eq(* (int *) list_content(first), 5, "handle isn't set to the next node");
+	int const left[] = { 0, 1, 5 };
+	int const taken[] = { 6, 2, 3, 4, 7, 8, 9 };
+	assert_list_holds(list, left, 3);
+	assert_list_holds(other, taken, 7);
+	cr_assert_eq(list_index_of(list_at(other, 3)), 3, "moved nodes aren't bound to their list");
+	list_delete(& list);
+	list_delete(& other);
+}
+
+
+Test(linked_list, splice_reorders_a_list)
+{
+	// given a list
+	linked_list * list = ranks_list(NULL, 0, 6);
+
+	// when moving its tail after its head, then its head after its tail
+	linked_list * first = list_tail(list);
+	cr_assert(list_splice(& first, first, list), "tail wasn't spliced");
+	first = list;
+	cr_assert(list_splice(& first, first, list_tail(first)), "head wasn't spliced");
+
+	// then nodes should be reordered
+	int const expected[] = { 5, 1, 2, 3, 4, 0 };
+	assert_list_holds(list_head(first), expected, 6);
+	linked_list * head = list_head(first);
+	cr_assert_not(list_splice(& head, list_tail(head), list_tail(head)), "range ending at its target was spliced");
+	list_delete(& first);
+}
+
+
+Test(linked_list, moved_nodes_find_their_list_after_split_and_splice)
+{
+	// given a list of 1000 nodes split in 2, then a range of the back moved into the front
+	int values[1000];
+	linked_list * nodes[1000];
+	linked_list * list = NULL;
+	for (int index = 0; index < 1000; index++)
+	{
+		values[index] = index;
+		list_append(& list, & values[index]);
+	}
+	linked_list * back = list_split_at(list_at(list, 500));
+	linked_list * first = list_at(back, 100);
+	cr_assert(list_splice(& first, list_at(back, 199), list_at(list, 249)), "range wasn't spliced");
+
+	// when looking for the list of every node, in no particular order
+	size_t index = 0;
+	for (linked_list * node = list; node != NULL; node = list_next(node))
+		nodes[index++] = node;
+	for (linked_list * node = back; node != NULL; node = list_next(node))
+		nodes[index++] = node;
+
+	// then each node should lead to its list, at its position
+	cr_assert_eq(list_size(list), 600, "front has a wrong size");
+	cr_assert_eq(list_size(back), 400, "back has a wrong size");
+	for (index = 0; index < 1000; index++)
+	{
+		size_t shuffled = index * 7 % 1000;
+		linked_list * head = (shuffled < 600) ? list : back;
+		cr_assert_eq(list_head(nodes[shuffled]), head, "node %zu leads to another list", shuffled);
+		cr_assert_eq(list_index_of(nodes[shuffled]), (shuffled < 600) ? shuffled : shuffled - 600, "node %zu is misplaced", shuffled);
+	}
+	cr_assert_eq(* (int *) list_content(list_at(list, 250)), 600, "range isn't in the front");
+	cr_assert_eq(* (int *) list_content(list_tail(back)), 999, "back has a wrong tail");
+	list_delete(& list);
+	list_delete(& back);
+}
+
+
+Test(linked_list, lists_exchanging_nodes_give_back_everything_on_delete)
+{
+	// given split lists with a same counting allocator, moving ranges both ways
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * list = ranks_list(& allocator, 0, 10);
+	linked_list * back = list_split_at(list_at(list, 5));
+	linked_list * first = list_at(list, 1);
+	cr_assert(list_splice(& first, list_at(list, 3), back), "range wasn't spliced");
+	first = list_at(back, 4);
+	cr_assert(list_splice(& first, list_tail(back), list), "range wasn't spliced back");
+	linked_list * other = ranks_list(& allocator, 0, 3);
+	cr_assert(list_concat(& other, & back), "lists weren't concatenated");
+
+	// when removing a moved node, then deleting the lists one after the other
+	linked_list * node_to_remove = list_at(other, 4);
+	list_remove_node(& node_to_remove);
+	int const kept[] = { 0, 6, 7, 8, 9, 4 };
+	assert_list_holds(list, kept, 6);
+	list_delete(& list);
+
+	// then the other list should outlive it, and every allocation should be released
+	int const taken[] = { 0, 1, 2, 5, 2, 3 };
+	assert_list_holds(other, taken, 6);
+	list_delete(& other);
+	cr_assert_eq(counter.allocations, counter.releases, "some memory wasn't given back");
+}
+
+
+Test(linked_list, lists_of_different_splits_give_back_everything_on_delete)
+{
+	// given 2 lists with a same counting allocator, each one split in 2
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * first_list = ranks_list(& allocator, 0, 5);
+	linked_list * second_list = ranks_list(& allocator, 5, 10);
+	linked_list * first_back = list_split_at(list_at(first_list, 2));
+	linked_list * second_back = list_split_at(list_at(second_list, 2));
+
+	// when moving a whole part to the other list, and a range back
+	linked_list * range = first_back;
+	cr_assert(list_splice(& range, list_tail(first_back), second_list), "part wasn't spliced");
+	first_back = range;
+	cr_assert_eq(list_size(first_back), 0, "emptied part still holds nodes");
+	range = second_back;
+	cr_assert(list_splice(& range, list_next(second_back), first_list), "range wasn't spliced");
+	second_back = range;
+
+	// then each list should hold its nodes until deleted, and give back everything
+	int const first_expected[] = { 0, 7, 8, 1 };
+	int const second_expected[] = { 5, 2, 3, 4, 6 };
+	assert_list_holds(second_list, second_expected, 5);
+	list_delete(& second_list);
+	assert_list_holds(first_list, first_expected, 4);
+	assert_list_holds(second_back, ranks + 9, 1);
+	list_delete(& first_list);
+	assert_list_holds(second_back, ranks + 9, 1);
+	list_delete(& second_back);
+	list_delete(& first_back);
+	cr_assert_eq(counter.allocations, counter.releases, "some memory wasn't given back");
+}
+
+
+static int is_multiple(void const * value, void * context)
+{
+	return * (int const *) value % * (int *) context == 0;
+}
+
+
+static int is_multiple_counting(void const * value, void * context)
+{
+	return is_multiple(value, & ((int *) context)[1]);
+}
+
+
+static void count_destroyed_values(void * value, void * context)
+{
+	(void) value;
+	((int *) context)[0]++;
+}
+
+
+Test(linked_list, remove_if_removes_every_matching_node)
+{
+	// given a list of numbers, handled through a node to remove
+	linked_list * list = numbers_list();
+	list_enable_position_index(list);
+	linked_list * handle = list_at(list, 300);
+
+	// when removing multiples of 3
+	int context[2] = { 0, 3 };
+	size_t removed = list_remove_if(& handle, is_multiple_counting, context, count_destroyed_values);
+
+	// then other numbers should be left in order, and removed values destroyed
+	cr_assert_eq(removed, (NUMBERS_COUNT + 2) / 3, "wrong count of removed nodes");
+	cr_assert_eq(context[0], (int) removed, "destructor wasn't called on every value");
+	cr_assert_eq(handle, list_head(handle), "handle isn't set to the head");
+	cr_assert_eq(list_size(handle), NUMBERS_COUNT - removed, "wrong size");
+	size_t position = 0;
+	for (linked_list * node = handle; node != NULL; node = list_next(node), position++)
+	{
+		int expected = (int) (position / 2 * 3 + position % 2 + 1);
+		cr_assert_eq(* (int *) list_content(node), expected, "wrong value at %zu", position);
+		cr_assert_eq(list_index_of(node), position, "wrong position of %d", expected);
+		cr_assert_eq(list_next(node) ? list_previous(list_next(node)) : node, node, "broken link at %zu", position);
+	}
+	cr_assert_eq(* (int *) list_content(list_tail(handle)), NUMBERS_COUNT - 2, "wrong tail");
+	list_delete(& handle);
+}
+
+
+Test(linked_list, remove_if_gives_pooled_nodes_back)
+{
+	// given a pooled list
+	linked_list * list = list_create_pooled(4);
+	for (int index = 0; index < 10; index++)
+		list_append(& list, & ranks[index]);
+
+	// when removing even values, then appending as many
+	int two = 2;
+	size_t removed = list_remove_if(& list, is_multiple, & two, NULL);
+	for (int index = 0; index < 5; index++)
+		list_append(& list, & ranks[index * 2]);
+
+	// then the list should reuse the nodes and hold every value
+	int const expected[] = { 1, 3, 5, 7, 9, 0, 2, 4, 6, 8 };
+	cr_assert_eq(removed, 5, "wrong count of removed nodes");
+	assert_list_holds(list, expected, 10);
+	list_delete(& list);
+}
+
+
+Test(linked_list, remove_if_deletes_emptied_lists_unless_configured)
+{
+	// given a plain list, a list with a counting allocator, and a synchronized list
+	allocations_counter counter = { 0 };
+	list_allocator allocator = { counting_allocate, counting_release, & counter };
+	linked_list * plain = ranks_list(NULL, 0, 10);
+	linked_list * list = ranks_list(& allocator, 0, 10);
+	linked_list * synchronized = list_create_synchronized();
+	for (int index = 0; index < 10; index++)
+		list_append(& synchronized, & ranks[index]);
+
+	// when removing every node of them
+	int context[2] = { 0, 1 };
+	list_remove_if(& plain, is_multiple_counting, context, count_destroyed_values);
+	list_remove_if(& list, is_multiple_counting, context, count_destroyed_values);
+	list_remove_if(& synchronized, is_multiple_counting, context, count_destroyed_values);
+
+	// then the plain list should be deleted, and the configured ones kept empty
+	cr_assert_geq(context[0], 20, "destructor wasn't called on every value");
+	cr_assert_null(plain, "emptied list wasn't deleted");
+	cr_assert_not_null(list, "allocator list was deleted");
+	cr_assert_eq(list_size(list), 0, "allocator list isn't empty");
+	cr_assert_null(list_head(list), "empty list has a head");
+	cr_assert_not_null(synchronized, "synchronized list was deleted");
+	cr_assert_eq(list_size(synchronized), 0, "synchronized list isn't empty");
+	cr_assert_null(list_next(synchronized), "empty list leads to a node");
+	list_delete(& list);
+	cr_assert_eq(counter.allocations, counter.releases, "some memory wasn't given back");
+	list_delete(& synchronized);
+	cr_assert_eq(context[0], 30, "retired values weren't destroyed");
+}
+
+
+
+
+Test(linked_list, inlined_walk_visits_same_nodes_as_list_next)
+{
+	// given a big list of numbers
+	linked_list * list = numbers_list();
+
+	// when walking it with the inlined iteration from one of its nodes
+	linked_list * expected = list_head(list);
+	linked_list * node;
+	size_t visited = 0;
+	list_for_each(node, list_tail(list))
+	{
+		// then every node should be the one list_next leads to
+		cr_assert_eq(node, expected, "node %zu differs", visited);
+		cr_assert_eq(list_fast_content(node), list_content(node), "value %zu differs", visited);
+		expected = list_next(expected);
+		visited++;
+	}
+	cr_assert_null(expected, "walk stopped early");
+	cr_assert_eq(visited, NUMBERS_COUNT, "visited %zu nodes", visited);
+}
+
+
+Test(linked_list, inlined_reverse_walk_visits_same_nodes_as_list_previous)
+{
+	// given a big list of numbers, with a node removed
+	linked_list * list = numbers_list();
+	linked_list * node_to_remove = list_next(list_head(list));
+	list_remove_node(& node_to_remove);
+
+	// when walking it backward with the inlined iteration
+	linked_list * expected = list_tail(list);
+	linked_list * node;
+	size_t visited = 0;
+	list_for_each_reverse(node, list)
+	{
+		// then every node should be the one list_previous leads to
+		cr_assert_eq(node, expected, "node %zu differs", visited);
+		cr_assert_eq(list_fast_previous(node), list_previous(node), "link %zu differs", visited);
+		cr_assert_eq(list_fast_next(node), list_next(node), "link %zu differs", visited);
+		expected = list_previous(expected);
+		visited++;
+	}
+	cr_assert_null(expected, "walk stopped early");
+	cr_assert_eq(visited, NUMBERS_COUNT - 1, "visited %zu nodes", visited);
+}
+
+
+Test(linked_list, inlined_walk_of_empty_list_visits_nothing)
+{
+	// given an empty list
+	linked_list * list = list_create();
+
+	// when walking it with the inlined iteration
+	linked_list * node;
+	size_t visited = 0;
+	list_for_each(node, list)
+		visited++;
+
+	// then no node should be visited
+	cr_assert_eq(visited, 0, "visited %zu nodes", visited);
+	list_delete(& list);
+}
+
+
 
 
 #ifdef DO_CONSTANT_TIME_BENCHMARK_TESTS
@@ -669,4 +1889,136 @@ Test(linked_list, prepending_time_doesnt_depend_of_size)
 		"prepending elements isn't in constant time");
 }
 
+
+
+/**
+ * Only user time is measured: pooled chunks are big enough to be given back
+ * to the system, while freed nodes stay in the allocator, kernel time spent
+ * unmapping memory would blur the comparison
+ * The pooled list is deleted first, otherwise releasing its chunks would make
+ * malloc consolidate the millions of nodes freed by the regular list
+ */
+static double user_time(void)
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, & usage);
+	return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+}
+
+
+static double benchmark_deleting_time(linked_list * list)
+{
+	double start = user_time();
+	list_delete(& list);
+	double end = user_time();
+	return end - start;
+}
+
+
+Test(linked_list, deleting_pooled_list_is_faster_than_node_by_node)
+{
+	// given 2 big lists, a regular one and a pooled one
+	linked_list * regular = big_list();
+	linked_list * pooled = big_pooled_list();
+
+	// when measuring time it takes to delete the pooled list...
+	double pooled_deleting_time = benchmark_deleting_time(pooled);
+	// ... and measuring time it takes to delete the regular list
+	double regular_deleting_time = benchmark_deleting_time(regular);
+
+	// then releasing chunks should be much faster than freeing every node
+	cr_assert_lt(
+		pooled_deleting_time * 4,
+		regular_deleting_time,
+		"pooled list isn't released chunk by chunk");
+}
+
+
+static double wall_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, & now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+#define SORTED_LIST_SIZE 2000000
+
+
+static linked_list * shuffled_numbers_list(int * values)
+{
+	linked_list * list = NULL;
+	for (long index = 0; index < SORTED_LIST_SIZE; index++)
+	{
+		values[index] = (int) ((index * 1000003L) % SORTED_LIST_SIZE);
+		list_append(& list, & values[index]);
+	}
+	return list;
+}
+
+
+static int is_expired(void const * value, void * context)
+{
+	(void) value;
+	return (* (size_t *) context)++ % 10 < 3;
+}
+
+
+Test(linked_list, remove_if_is_faster_than_removing_nodes_one_by_one)
+{
+	// given 2 big lists
+	linked_list * list = big_list();
+	linked_list * other = big_list();
+
+	// when measuring time it takes to remove 30% of a list in a single sweep...
+	size_t seen = 0;
+	double start = wall_time();
+	list_remove_if(& list, is_expired, & seen, NULL);
+	double sweep_time = wall_time() - start;
+	// ... and time it takes to remove them one by one
+	seen = 0;
+	linked_list * kept = list_next(list_next(list_next(other))); // 4th node stays
+	start = wall_time();
+	linked_list * node = other;
+	while (node != NULL)
+	{
+		if (is_expired(list_content(node), & seen))
+			list_remove_node(& node);
+		else
+			node = list_next(node);
+	}
+	double loop_time = wall_time() - start;
+
+	// then the single sweep should be faster
+	cr_assert_lt(sweep_time, loop_time, "single sweep is slower than a removal loop");
+	list_delete(& list);
+	list_delete(& kept);
+}
+
+
+Test(linked_list, inlined_walk_is_faster_than_walking_with_list_next)
+{
+	// given a big list
+	linked_list * list = shuffled_numbers_list(malloc(SORTED_LIST_SIZE * sizeof(int)));
+	long sum = 0;
+
+	// when measuring time it takes to walk it with list_next...
+	double start = wall_time();
+	for (linked_list * node = list_head(list); node != NULL; node = list_next(node))
+		sum += * (int *) list_content(node);
+	double called_time = wall_time() - start;
+	// ... and time it takes to walk it with the inlined iteration
+	linked_list * node;
+	start = wall_time();
+	list_for_each(node, list)
+		sum -= * (int *) list_fast_content(node);
+	double inlined_time = wall_time() - start;
+
+	// then the bare pointer walk should be faster
+	cr_assert_eq(sum, 0, "walks didn't visit the same values");
+	cr_assert_lt(inlined_time, called_time, "inlined walk is slower than list_next walk");
+	free(list_content(list_head(list)));
+	list_delete(& list);
+}
+
 #endif /* DO_CONSTANT_TIME_BENCHMARK_TESTS */
@@ -0,0 +1,702 @@
+#include <criterion/criterion.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../include/List.h"
+
+#include "utils.h"
+
+/**
+ * Some operations are in constant time O(1), but involve big lists to test
+ * Those tests are disabled by default, since there's no reason they would go
+ * back to O(n) complexity, timings are tracked by make bench instead
+ */
+// #define DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+
+
+
+#define NUMBERS_COUNT 100000
+
+
+static int numbers[NUMBERS_COUNT];
+
+
+static void sum_reducer(void * accumulator, void const * value)
+{
+	* (long *) accumulator += * (int const *) value;
+}
+
+
+#define PRODUCERS_COUNT 8
+#define PRODUCED_COUNT 20000
+
+
+typedef struct produced_value
+{
+	int producer;
+	int sequence;
+} produced_value;
+
+
+static produced_value produced_values[PRODUCERS_COUNT][PRODUCED_COUNT];
+
+
+typedef struct producer
+{
+	linked_list * list;
+	int id;
+	pthread_t thread;
+} producer;
+
+
+static void * produce(void * argument)
+{
+	producer * self = argument;
+
+	for (int sequence = 0; sequence < PRODUCED_COUNT; sequence++)
+	{
+		produced_value * value = & produced_values[self->id][sequence];
+		value->producer = self->id;
+		value->sequence = sequence;
+
+		if (sequence % 2 == 0)
+			list_append(& self->list, value);
+		else
+			list_prepend(& self->list, value);
+	}
+
+	return NULL;
+}
+
+
+static void start_producers(producer * producers, linked_list * list)
+{
+	for (int index = 0; index < PRODUCERS_COUNT; index++)
+	{
+		producers[index].list = list;
+		producers[index].id = index;
+		pthread_create(& producers[index].thread, NULL, produce, & producers[index]);
+	}
+}
+
+
+static void join_producers(producer * producers)
+{
+	for (int index = 0; index < PRODUCERS_COUNT; index++)
+		pthread_join(producers[index].thread, NULL);
+}
+
+
+Test(list_concurrency, concurrent_producers_lose_no_node)
+{
+	// given a concurrent list fed by several threads at both ends
+	linked_list * list = list_create_concurrent();
+	producer producers[PRODUCERS_COUNT];
+	start_producers(producers, list);
+	join_producers(producers);
+
+	// when draining it
+	cr_assert_eq(list_size(list), PRODUCERS_COUNT * PRODUCED_COUNT, "wrong pending size");
+	linked_list * drained = list_drain(list);
+
+	// then every node should be there, prepended ones first, in each producer order
+	cr_assert_eq(list_size(drained), PRODUCERS_COUNT * PRODUCED_COUNT, "nodes were lost");
+	cr_assert_eq(list_size(list), 0, "drained nodes are still counted");
+	int last_prepended[PRODUCERS_COUNT];
+	int last_appended[PRODUCERS_COUNT];
+	for (int index = 0; index < PRODUCERS_COUNT; index++)
+	{
+		last_prepended[index] = PRODUCED_COUNT + 1;
+		last_appended[index] = -2;
+	}
+	int appending = 0;
+	size_t walked = 0;
+	for (linked_list * node = list_head(drained); node != NULL; node = list_next(node))
+	{
+		produced_value const * value = list_content(node);
+		if (value->sequence % 2 == 0)
+		{
+			appending = 1;
+			cr_assert_gt(value->sequence, last_appended[value->producer], "appended out of order");
+			last_appended[value->producer] = value->sequence;
+		}
+		else
+		{
+			cr_assert_not(appending, "prepended node after appended ones");
+			cr_assert_lt(value->sequence, last_prepended[value->producer], "prepended out of order");
+			last_prepended[value->producer] = value->sequence;
+		}
+		cr_assert_eq(list_previous(node) == NULL, walked == 0, "broken previous link");
+		walked++;
+	}
+	cr_assert_eq(walked, PRODUCERS_COUNT * PRODUCED_COUNT, "broken next link");
+
+	list_delete(& drained);
+	list_delete(& list);
+}
+
+
+Test(list_concurrency, draining_a_list_that_isnt_concurrent_gives_nothing)
+{
+	// given a pooled list, and a plain list concatenated to another one
+	linked_list * pooled = list_create_pooled(4);
+	static int values[] = { 1, 2, 3 };
+	list_append(& pooled, & values[0]);
+	linked_list * list = NULL;
+	list_append(& list, & values[1]);
+	linked_list * other = NULL;
+	list_append(& other, & values[2]);
+	list_concat(& list, & other);
+
+	// when draining them
+	// then nothing should be drained
+	cr_assert_null(list_drain(list_head(pooled)), "pooled list was drained");
+	cr_assert_null(list_drain(list_tail(list)), "concatenated list was drained");
+	cr_assert_eq(list_size(list), 2, "concatenated list changed");
+	list_delete(& pooled);
+	list_delete(& list);
+}
+
+
+Test(list_concurrency, draining_while_producing_loses_no_node)
+{
+	// given a concurrent list fed by several threads
+	linked_list * list = list_create_concurrent();
+	producer producers[PRODUCERS_COUNT];
+	start_producers(producers, list);
+
+	// when draining it while they produce, and once they are done
+	size_t drained_count = 0;
+	for (int drain = 0; drain < 100; drain++)
+	{
+		linked_list * drained = list_drain(list);
+		drained_count += list_size(drained);
+		list_delete(& drained);
+		cr_assert_leq(list_size(list), PRODUCERS_COUNT * PRODUCED_COUNT, "pending size wrapped");
+	}
+	join_producers(producers);
+	linked_list * drained = list_drain(list);
+	drained_count += list_size(drained);
+	list_delete(& drained);
+
+	// then every node should have been drained once
+	cr_assert_eq(drained_count, PRODUCERS_COUNT * PRODUCED_COUNT, "wrong drained count");
+	cr_assert_null(list_drain(list), "nodes drained twice");
+
+	list_delete(& list);
+}
+
+
+Test(list_concurrency, concurrent_list_behaves_as_empty)
+{
+	// given a concurrent list with pending nodes
+	linked_list * list = list_create_concurrent();
+	static int values[] = { 1, 2 };
+	list_append(& list, & values[0]);
+	list_prepend(& list, & values[1]);
+
+	// when using it as a regular list
+	// then it should look empty but count the pending nodes
+	cr_assert_eq(list_size(list), 2, "pending nodes aren't counted");
+	cr_assert_null(list_head(list), "concurrent list has a head");
+	cr_assert_null(list_at(list, 0), "concurrent list has a node at 0");
+	cr_assert_null(list_drain(list_create()), "regular list was drained");
+
+	list_delete(& list);
+	cr_assert_null(list, "list wasn't deleted");
+}
+
+
+Test(list_concurrency, synchronized_list_keeps_its_handle)
+{
+	// given a synchronized list
+	linked_list * list = list_create_synchronized();
+	linked_list * handle = list;
+
+	// when adding nodes through it, and removing them all
+	static int values[] = { 1, 2, 3 };
+	list_append(& list, & values[1]);
+	list_prepend(& list, & values[0]);
+	list_append(& list, & values[2]);
+	long sum = 0;
+	list_reduce(list, & sum, sum_reducer);
+	cr_assert_eq(list, handle, "handle was replaced");
+	cr_assert_eq(list_next(list), list_head(list), "handle doesn't lead to the head");
+	cr_assert_eq(sum, 6, "handle doesn't reduce the whole list");
+	linked_list * node_to_remove = list_head(list);
+	while (node_to_remove != NULL)
+		list_remove_node(& node_to_remove);
+
+	// then the list should be empty, but still usable
+	cr_assert_eq(list_size(list), 0, "list isn't empty");
+	cr_assert_null(list_head(list), "empty list has a head");
+	list_append(& list, & values[0]);
+	cr_assert_eq(list_content(list_head(list)), & values[0], "list isn't usable anymore");
+	list_delete(& list);
+}
+
+
+#define WRITERS_COUNT 4
+#define READERS_COUNT 4
+#define WRITES_COUNT 5000
+
+
+typedef struct list_user
+{
+	linked_list * list;
+	int id;
+	int failed;
+	pthread_t thread;
+} list_user;
+
+
+static void * write_and_remove(void * argument)
+{
+	list_user * self = argument;
+
+	for (int write = 0; write < WRITES_COUNT; write++)
+	{
+		list_append(& self->list, & numbers[self->id]);
+		list_prepend(& self->list, & numbers[self->id]);
+
+		// removes one of its own nodes, found while reading
+		linked_list * node_to_remove = NULL;
+		list_lock_reading(self->list);
+		for (linked_list * node = list_next(self->list); node != NULL; node = list_next(node))
+		{
+			if (list_content(node) == & numbers[self->id])
+			{
+				node_to_remove = node;
+				break;
+			}
+		}
+		list_unlock_reading(self->list);
+
+		// only this thread removes its nodes, so it can't be gone meanwhile
+		list_remove_node(& node_to_remove);
+	}
+
+	return NULL;
+}
+
+
+static void * read_and_check(void * argument)
+{
+	list_user * self = argument;
+
+	for (int read = 0; read < WRITES_COUNT / 10; read++)
+	{
+		long sum = 0;
+		list_reduce(self->list, & sum, sum_reducer);
+
+		list_lock_reading(self->list);
+		size_t walked = 0;
+		for (linked_list * node = list_head(self->list); node != NULL; node = list_next(node))
+		{
+			linked_list * next = list_next(node);
+			if (next != NULL && list_previous(next) != node)
+				self->failed = 1;
+			walked++;
+		}
+		if (walked != list_size(self->list))
+			self->failed = 1;
+		list_unlock_reading(self->list);
+	}
+
+	return NULL;
+}
+
+
+Test(list_concurrency, synchronized_list_is_consistent_under_readers_and_writers)
+{
+	// given a synchronized list
+	linked_list * list = list_create_synchronized();
+	for (int index = 0; index < WRITERS_COUNT; index++)
+		numbers[index] = 1;
+
+	// when several threads write to it and remove from it, while others read it
+	list_user users[WRITERS_COUNT + READERS_COUNT];
+	for (int index = 0; index < WRITERS_COUNT + READERS_COUNT; index++)
+	{
+		users[index].list = list;
+		users[index].id = index;
+		users[index].failed = 0;
+		pthread_create(
+			& users[index].thread,
+			NULL,
+			index < WRITERS_COUNT ? write_and_remove : read_and_check,
+			& users[index]);
+	}
+	for (int index = 0; index < WRITERS_COUNT + READERS_COUNT; index++)
+		pthread_join(users[index].thread, NULL);
+
+	// then readers should only have seen consistent lists, and no node be lost
+	for (int index = WRITERS_COUNT; index < WRITERS_COUNT + READERS_COUNT; index++)
+		cr_assert_not(users[index].failed, "reader %d saw a broken list", index);
+	cr_assert_eq(list_size(list), WRITERS_COUNT * WRITES_COUNT, "wrong size");
+	long sum = 0;
+	list_reduce(list, & sum, sum_reducer);
+	cr_assert_eq(sum, WRITERS_COUNT * WRITES_COUNT, "wrong nodes");
+
+	list_delete(& list);
+}
+
+
+Test(list_concurrency, removed_nodes_are_kept_while_a_reader_is_in_an_epoch)
+{
+	// given a synchronized list, walked from its head in an epoch
+	linked_list * list = list_create_synchronized();
+	static int values[] = { 1, 2, 3, 4 };
+	for (int index = 0; index < 4; index++)
+		list_append(& list, & values[index]);
+	size_t epoch = list_enter_epoch(list);
+	linked_list * head = list_next(list);
+
+	// when removing the head, and the rest of the list after it
+	linked_list * node_to_remove = head;
+	while (node_to_remove != NULL)
+		list_remove_node(& node_to_remove);
+
+	// then the walk should go on through the removed nodes until the epoch ends
+	cr_assert_eq(list_size(list), 0, "list isn't empty");
+	cr_assert_null(list_next(list), "empty list leads to a node");
+	long sum = 0;
+	for (linked_list * node = head; node != NULL; node = list_next(node))
+		sum += * (int *) list_content(node);
+	cr_assert_eq(sum, 10, "removed nodes were released during the walk");
+	list_leave_epoch(list, epoch);
+	list_append(& list, & values[0]);
+	cr_assert_eq(list_content(list_head(list)), & values[0], "list isn't usable anymore");
+	list_delete(& list);
+}
+
+
+Test(list_concurrency, synchronized_list_with_retired_array_nodes_is_deleted)
+{
+	// given a synchronized list filled from an array, with a node removed
+	linked_list * list = list_create_synchronized();
+	static int values[8];
+	void * array[8];
+	for (int index = 0; index < 8; index++)
+		array[index] = & values[index];
+	list_append_array(& list, array, 8);
+	linked_list * node_to_remove = list_next(list_head(list));
+	list_remove_node(& node_to_remove);
+
+	// when deleting it
+	list_delete(& list);
+
+	// then the retired node should have been released before its chunk
+	cr_assert_null(list, "list wasn't deleted");
+}
+
+
+static void * shrink_list(void * argument)
+{
+	list_user * self = argument;
+
+	for (int write = 0; write < WRITES_COUNT; write++)
+	{
+		if (write % 2 == 0)
+			list_append(& self->list, & numbers[self->id]);
+
+		// removes one of its own nodes, found while walking without locking
+		linked_list * node_to_remove = NULL;
+		size_t epoch = list_enter_epoch(self->list);
+		for (linked_list * node = list_next(self->list); node != NULL; node = list_next(node))
+		{
+			if (list_content(node) == & numbers[self->id])
+			{
+				node_to_remove = node;
+				break;
+			}
+		}
+		list_remove_node(& node_to_remove);
+		list_leave_epoch(self->list, epoch);
+	}
+
+	return NULL;
+}
+
+
+static void * walk_in_epochs(void * argument)
+{
+	list_user * self = argument;
+
+	for (int read = 0; read < WRITES_COUNT / 10; read++)
+	{
+		long sum = 0;
+		list_reduce(self->list, & sum, sum_reducer);
+		if (sum > WRITERS_COUNT * WRITES_COUNT)
+			self->failed = 1;
+
+		size_t epoch = list_enter_epoch(self->list);
+		for (linked_list * node = list_next(self->list); node != NULL; node = list_next(node))
+		{
+			if (* (int *) list_content(node) != 1)
+				self->failed = 1;
+		}
+		list_leave_epoch(self->list, epoch);
+	}
+
+	return NULL;
+}
+
+
+Test(list_concurrency, synchronized_list_shrinks_under_readers_walking_without_locking)
+{
+	// given a synchronized list, with nodes of several writers
+	linked_list * list = list_create_synchronized();
+	for (int index = 0; index < WRITERS_COUNT; index++)
+		numbers[index] = 1;
+	for (int write = 0; write < WRITES_COUNT / 2; write++)
+	{
+		for (int index = 0; index < WRITERS_COUNT; index++)
+			list_append(& list, & numbers[index]);
+	}
+
+	// when writers remove their nodes faster than they add them, while others walk it
+	list_user users[WRITERS_COUNT + READERS_COUNT];
+	for (int index = 0; index < WRITERS_COUNT + READERS_COUNT; index++)
+	{
+		users[index].list = list;
+		users[index].id = index;
+		users[index].failed = 0;
+		pthread_create(
+			& users[index].thread,
+			NULL,
+			index < WRITERS_COUNT ? shrink_list : walk_in_epochs,
+			& users[index]);
+	}
+	for (int index = 0; index < WRITERS_COUNT + READERS_COUNT; index++)
+		pthread_join(users[index].thread, NULL);
+
+	// then readers should only have seen live values, and the list be empty
+	for (int index = WRITERS_COUNT; index < WRITERS_COUNT + READERS_COUNT; index++)
+		cr_assert_not(users[index].failed, "reader %d saw a released node", index);
+	cr_assert_eq(list_size(list), 0, "list isn't empty");
+	cr_assert_null(list_next(list), "empty list leads to a node");
+
+	list_delete(& list);
+}
+
+
+static void * read_ends_without_locking(void * argument)
+{
+	list_user * self = argument;
+
+	for (int read = 0; read < WRITES_COUNT / 10; read++)
+	{
+		// may meet nodes removed meanwhile, never released ones
+		size_t epoch = list_enter_epoch(self->list);
+		linked_list * head = list_head(self->list);
+		linked_list * tail = list_tail(self->list);
+		linked_list * middle = list_at(self->list, list_size(self->list) / 2);
+		if ((head != NULL && * (int *) list_content(head) != 1)
+			|| (tail != NULL && * (int *) list_content(tail) != 1)
+			|| (middle != NULL && * (int *) list_content(middle) != 1))
+			self->failed = 1;
+		list_leave_epoch(self->list, epoch);
+
+		void ** values = list_to_array(self->list);
+		for (size_t index = 0; values != NULL && index < 16; index++)
+		{
+			if (values[index] != NULL && * (int *) values[index] != 1)
+				self->failed = 1;
+		}
+		free(values);
+	}
+
+	return NULL;
+}
+
+
+Test(list_concurrency, synchronized_list_ends_are_read_without_locking_while_it_shrinks)
+{
+	// given a synchronized list, with nodes of several writers
+	linked_list * list = list_create_synchronized();
+	for (int index = 0; index < WRITERS_COUNT; index++)
+		numbers[index] = 1;
+	for (int write = 0; write < WRITES_COUNT / 2; write++)
+	{
+		for (int index = 0; index < WRITERS_COUNT; index++)
+			list_append(& list, & numbers[index]);
+	}
+
+	// when writers remove their nodes, while others read its ends, size and values
+	list_user users[WRITERS_COUNT + READERS_COUNT];
+	for (int index = 0; index < WRITERS_COUNT + READERS_COUNT; index++)
+	{
+		users[index].list = list;
+		users[index].id = index;
+		users[index].failed = 0;
+		pthread_create(
+			& users[index].thread,
+			NULL,
+			index < WRITERS_COUNT ? shrink_list : read_ends_without_locking,
+			& users[index]);
+	}
+	for (int index = 0; index < WRITERS_COUNT + READERS_COUNT; index++)
+		pthread_join(users[index].thread, NULL);
+
+	// then readers should only have seen live values
+	for (int index = WRITERS_COUNT; index < WRITERS_COUNT + READERS_COUNT; index++)
+		cr_assert_not(users[index].failed, "reader %d saw a released node", index);
+	cr_assert_eq(list_size(list), 0, "list isn't empty");
+	cr_assert_null(list_head(list), "empty list has a head");
+	cr_assert_null(list_tail(list), "empty list has a tail");
+
+	list_delete(& list);
+}
+
+
+static int is_any(void const * value, void * context)
+{
+	(void) value;
+	(void) context;
+	return 1;
+}
+
+
+static void poison_and_free(void * value, void * context)
+{
+	(void) context;
+	* (int *) value = -1;
+	free(value);
+}
+
+
+static void * fill_and_empty(void * argument)
+{
+	list_user * self = argument;
+
+	for (int write = 0; write < WRITES_COUNT / 10; write++)
+	{
+		for (int index = 0; index < 64; index++)
+		{
+			int * value = malloc(sizeof(* value));
+			* value = 1;
+			list_append(& self->list, value);
+		}
+		list_remove_if(& self->list, is_any, NULL, poison_and_free);
+	}
+
+	return NULL;
+}
+
+
+static void live_values_reducer(void * accumulator, void const * value)
+{
+	if (* (int const *) value != 1)
+		* (int *) accumulator = 1;
+	sched_yield(); // lets the writer remove the value while it's being reached
+}
+
+
+static void * reduce_live_values(void * argument)
+{
+	list_user * self = argument;
+
+	for (int read = 0; read < WRITES_COUNT / 10; read++)
+		list_reduce(self->list, & self->failed, live_values_reducer);
+
+	return NULL;
+}
+
+
+Test(list_concurrency, removed_values_are_destroyed_once_readers_are_gone)
+{
+	// given a synchronized list
+	linked_list * list = list_create_synchronized();
+
+	// when a writer fills it and empties it with a destructor, while others reduce it
+	list_user users[1 + READERS_COUNT];
+	for (int index = 0; index < 1 + READERS_COUNT; index++)
+	{
+		users[index].list = list;
+		users[index].id = index;
+		users[index].failed = 0;
+		pthread_create(
+			& users[index].thread,
+			NULL,
+			index == 0 ? fill_and_empty : reduce_live_values,
+			& users[index]);
+	}
+	for (int index = 0; index < 1 + READERS_COUNT; index++)
+		pthread_join(users[index].thread, NULL);
+
+	// then readers should never have seen a destroyed value
+	for (int index = 1; index < 1 + READERS_COUNT; index++)
+		cr_assert_not(users[index].failed, "reader %d saw a destroyed value", index);
+	cr_assert_eq(list_size(list), 0, "list isn't empty");
+
+	list_delete(& list);
+}
+
+
+
+
+#ifdef DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+static pthread_mutex_t appending_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+static void * produce_under_mutex(void * argument)
+{
+	producer * self = argument;
+
+	for (int sequence = 0; sequence < PRODUCED_COUNT; sequence++)
+	{
+		pthread_mutex_lock(& appending_mutex);
+		list_append(& self->list, & produced_values[self->id][sequence]);
+		pthread_mutex_unlock(& appending_mutex);
+	}
+
+	return NULL;
+}
+
+
+static double wall_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, & now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+Test(list_concurrency, concurrent_appends_are_faster_than_appends_under_mutex)
+{
+	// given a concurrent list and a regular one
+	linked_list * concurrent = list_create_concurrent();
+	linked_list * regular = small_list();
+	producer producers[PRODUCERS_COUNT];
+
+	// when measuring time it takes several threads to feed the concurrent list...
+	double start = wall_time();
+	start_producers(producers, concurrent);
+	join_producers(producers);
+	double concurrent_time = wall_time() - start;
+	// ... and measuring time it takes them to feed the regular one under a mutex
+	start = wall_time();
+	for (int index = 0; index < PRODUCERS_COUNT; index++)
+	{
+		producers[index].list = regular;
+		producers[index].id = index;
+		pthread_create(& producers[index].thread, NULL, produce_under_mutex, & producers[index]);
+	}
+	join_producers(producers);
+	double mutex_time = wall_time() - start;
+
+	// then appending without locking should scale better, given several cores
+	if (sysconf(_SC_NPROCESSORS_ONLN) > 1)
+		cr_assert_lt(
+			concurrent_time,
+			mutex_time,
+			"concurrent appends are slower than appends under mutex");
+}
+
+#endif /* DO_CONSTANT_TIME_BENCHMARK_TESTS */
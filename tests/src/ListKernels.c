@@ -0,0 +1,154 @@
+#include <criterion/criterion.h>
+#include <stdint.h>
+
+#include "../../include/List.h"
+#include "../../include/ListKernels.h"
+
+
+
+
+#define VALUES_COUNT 1003
+
+
+static int ints[VALUES_COUNT];
+
+
+static double doubles[VALUES_COUNT];
+
+
+static linked_list * ints_list(void)
+{
+	linked_list * list = list_create();
+
+	for (int index = 0; index < VALUES_COUNT; index++)
+	{
+		ints[index] = (index * 7919) % 2003 - 1001;
+		list_append(& list, & ints[index]);
+	}
+
+	return list;
+}
+
+
+static linked_list * doubles_list(void)
+{
+	linked_list * list = list_create();
+
+	for (int index = 0; index < VALUES_COUNT; index++)
+	{
+		doubles[index] = ((index * 7919) % 2003 - 1001) / 4.0;
+		list_append(& list, & doubles[index]);
+	}
+
+	return list;
+}
+
+
+
+
+Test(list_kernels, sum_ints_matches_sequential_sum)
+{
+	// given a list of ints
+	linked_list * list = ints_list();
+
+	// when summing it by batches
+	int64_t sum = 0;
+	list_reduce_batch(list, & sum, list_sum_ints);
+
+	// then it should match the sequential sum
+	int64_t expected = 0;
+	for (int index = 0; index < VALUES_COUNT; index++)
+		expected += ints[index];
+	cr_assert_eq(sum, expected, "wrong sum");
+}
+
+
+Test(list_kernels, sum_ints_doesnt_overflow_int)
+{
+	// given a list of huge ints
+	static int huge[10] = {
+		INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX,
+		INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX
+	};
+	linked_list * list = list_create();
+	for (int index = 0; index < 10; index++)
+		list_append(& list, & huge[index]);
+
+	// when summing it by batches
+	int64_t sum = 0;
+	list_reduce_batch(list, & sum, list_sum_ints);
+
+	// then it should be summed on 64 bits
+	cr_assert_eq(sum, (int64_t) INT32_MAX * 10, "sum overflowed");
+}
+
+
+Test(list_kernels, sum_doubles_matches_sequential_sum)
+{
+	// given a list of doubles, exactly representable
+	linked_list * list = doubles_list();
+
+	// when summing it by batches
+	double sum = 0;
+	list_reduce_batch(list, & sum, list_sum_doubles);
+
+	// then it should match the sequential sum
+	double expected = 0;
+	for (int index = 0; index < VALUES_COUNT; index++)
+		expected += doubles[index];
+	cr_assert_float_eq(sum, expected, 1e-9, "wrong sum");
+}
+
+
+Test(list_kernels, min_and_max_ints_are_found)
+{
+	// given a list of ints
+	linked_list * list = ints_list();
+
+	// when looking for its extrema by batches
+	int min = ints[0];
+	list_reduce_batch(list, & min, list_min_ints);
+	int max = ints[0];
+	list_reduce_batch(list, & max, list_max_ints);
+
+	// then they should be found
+	cr_assert_eq(min, -1001, "wrong minimum");
+	cr_assert_eq(max, 1001, "wrong maximum");
+}
+
+
+Test(list_kernels, min_and_max_doubles_are_found)
+{
+	// given a list of doubles
+	linked_list * list = doubles_list();
+
+	// when looking for its extrema by batches
+	double min = doubles[0];
+	list_reduce_batch(list, & min, list_min_doubles);
+	double max = doubles[0];
+	list_reduce_batch(list, & max, list_max_doubles);
+
+	// then they should be found
+	cr_assert_float_eq(min, -1001 / 4.0, 1e-9, "wrong minimum");
+	cr_assert_float_eq(max, 1001 / 4.0, 1e-9, "wrong maximum");
+}
+
+
+Test(list_kernels, extremum_in_last_partial_batch_is_found)
+{
+	// given a list whose extrema are its last values, out of any vector
+	linked_list * list = ints_list();
+	static int extrema[] = { -5000, 5000 };
+	list_append(& list, & extrema[0]);
+	list_append(& list, & extrema[1]);
+
+	// when looking for its extrema by batches
+	int min = 0;
+	list_reduce_batch(list, & min, list_min_ints);
+	int max = 0;
+	list_reduce_batch(list, & max, list_max_ints);
+
+	// then they should be found
+	cr_assert_eq(min, -5000, "wrong minimum");
+	cr_assert_eq(max, 5000, "wrong maximum");
+}
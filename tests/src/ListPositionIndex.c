@@ -0,0 +1,123 @@
+#include <criterion/criterion.h>
+
+#include "../../include/List.h"
+
+#include "utils.h"
+
+
+
+
+static void assert_positions_match_walk(linked_list const * list)
+{
+	size_t position = 0;
+
+	for (linked_list * node = list_head(list); node != NULL; node = list_next(node))
+	{
+		cr_assert_eq(list_at(list, position), node, "wrong node at %zu", position);
+		cr_assert_eq(list_index_of(node), position, "wrong position of node %zu", position);
+		cr_assert_eq(list_size_backward(node), position + 1, "wrong backward size");
+		cr_assert_eq(list_size_forward(node), list_size(list) - position, "wrong forward size");
+		position++;
+	}
+	cr_assert_eq(position, list_size(list), "walk doesn't match size");
+}
+
+
+Test(list_position_index, positions_without_index_are_found_by_walking)
+{
+	// given a list without position index
+	linked_list * list = list_of_size(100);
+
+	// when looking for positions
+	// then they should match a walk of the list
+	assert_positions_match_walk(list);
+	cr_assert_null(list_at(list, 100), "out of list position gave a node");
+}
+
+
+Test(list_position_index, positions_with_index_match_walk)
+{
+	// given an indexed list, grown on both ends past its spare positions
+	linked_list * list = list_of_size(10);
+	cr_assert_eq(list_enable_position_index(list), 1, "index wasn't built");
+	static int values[1000];
+	for (int index = 0; index < 1000; index++)
+	{
+		if (index % 3 == 0)
+			list_prepend(& list, & values[index]);
+		else
+			list_append(& list, & values[index]);
+	}
+
+	// when looking for positions
+	// then they should match a walk of the list
+	assert_positions_match_walk(list);
+	cr_assert_null(list_at(list, list_size(list)), "out of list position gave a node");
+}
+
+
+Test(list_position_index, positions_with_index_follow_removals_and_insertions)
+{
+	// given an indexed list
+	linked_list * list = list_of_size(200);
+	list_enable_position_index(list);
+
+	// when removing nodes, and inserting some in the middle
+	for (int index = 0; index < 50; index++)
+	{
+		linked_list * node_to_remove = list_at(list, (size_t) index * 3);
+		list = list_next(node_to_remove);
+		list_remove_node(& node_to_remove);
+	}
+	static int values[] = { 1, 2, 3 };
+	void * inserted[] = { & values[0], & values[1], & values[2] };
+	list_insert_array_after(list_at(list, 10), inserted, 3);
+
+	// then positions should match a walk of the list
+	cr_assert_eq(list_size(list), 153, "wrong size");
+	cr_assert_eq(list_content(list_at(list, 12)), & values[1], "inserted node misplaced");
+	assert_positions_match_walk(list);
+}
+
+
+Test(list_position_index, positions_with_index_follow_reused_nodes)
+{
+	// given an indexed pooled list
+	linked_list * list = list_create_pooled(16);
+	static int values[300];
+	for (int index = 0; index < 100; index++)
+		list_append(& list, & values[index]);
+	list_enable_position_index(list);
+
+	// when removing nodes from the head, their memory being reused by appends
+	for (int index = 100; index < 300; index++)
+	{
+		linked_list * node_to_remove = list;
+		list = list_next(list);
+		list_remove_node(& node_to_remove);
+		list_append(& list, & values[index]);
+		cr_assert_eq(list_index_of(list_tail(list)), 99, "appended node misplaced");
+	}
+
+	// then positions should match a walk of the list
+	cr_assert_eq(list_content(list_at(list, 0)), & values[200], "wrong head");
+	assert_positions_match_walk(list);
+	list_delete(& list);
+}
+
+
+Test(list_position_index, position_index_survives_being_disabled)
+{
+	// given an indexed list whose index gets disabled
+	linked_list * list = list_of_size(50);
+	list_enable_position_index(list);
+	list_disable_position_index(list);
+
+	// when growing it
+	static int value;
+	list_prepend(& list, & value);
+	list_append(& list, & value);
+
+	// then positions should be found by walking
+	assert_positions_match_walk(list);
+}
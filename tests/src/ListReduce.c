@@ -0,0 +1,381 @@
+#include <criterion/criterion.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../include/List.h"
+
+#include "utils.h"
+
+/**
+ * Some operations are in constant time O(1), but involve big lists to test
+ * Those tests are disabled by default, since there's no reason they would go
+ * back to O(n) complexity, timings are tracked by make bench instead
+ */
+// #define DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+
+
+
+#define NUMBERS_COUNT 100000
+
+
+static int numbers[NUMBERS_COUNT];
+
+
+static linked_list * numbers_list(void)
+{
+	linked_list * list = list_create();
+
+	for (int index = 0; index < NUMBERS_COUNT; index++)
+	{
+		numbers[index] = index;
+		list_append(& list, & numbers[index]);
+	}
+
+	return list;
+}
+
+
+static void * create_sum(void)
+{
+	return calloc(1, sizeof(long));
+}
+
+
+static void sum_reducer(void * accumulator, void const * value)
+{
+	* (long *) accumulator += * (int const *) value;
+}
+
+
+static void sum_combiner(void * accumulator, void * partial_accumulator)
+{
+	* (long *) accumulator += * (long *) partial_accumulator;
+	free(partial_accumulator);
+}
+
+
+Test(list_reduce, parallel_reduce_gives_same_result_as_reduce)
+{
+	// given a big list of numbers
+	linked_list * list = numbers_list();
+
+	// when summing it with several threads
+	long parallel_sum = 0;
+	list_reduce_parallel(list, 4, & parallel_sum, create_sum, sum_reducer, sum_combiner);
+
+	// then it should match the single threaded sum
+	long sum = 0;
+	list_reduce(list, & sum, sum_reducer);
+	cr_assert_eq(parallel_sum, sum, "parallel sum doesn't match");
+}
+
+
+Test(list_reduce, parallel_reduce_after_removal_gives_same_result)
+{
+	// given a big list of numbers, with a few removed
+	linked_list * list = numbers_list();
+	linked_list * node_to_remove = list_tail(list);
+	list_remove_node(& node_to_remove);
+	node_to_remove = list_next(list_next(list));
+	list_remove_node(& node_to_remove);
+
+	// when summing it twice with several threads
+	long first_sum = 0;
+	list_reduce_parallel(list, 3, & first_sum, create_sum, sum_reducer, sum_combiner);
+	long second_sum = 0;
+	list_reduce_parallel(list, 3, & second_sum, create_sum, sum_reducer, sum_combiner);
+
+	// then both should match the single threaded sum
+	long sum = 0;
+	list_reduce(list, & sum, sum_reducer);
+	cr_assert_eq(first_sum, sum, "parallel sum doesn't match after removal");
+	cr_assert_eq(second_sum, sum, "rebuilt split points are wrong");
+}
+
+
+static void * create_digits_buffer(void)
+{
+	return calloc(NUMBERS_COUNT + 1, 1);
+}
+
+
+static void last_digit_reducer(void * accumulator, void const * value)
+{
+	char * buffer = accumulator;
+
+	buffer[strlen(buffer)] = (char) ('0' + * (int const *) value % 10);
+}
+
+
+static void concatenation_combiner(void * accumulator, void * partial_accumulator)
+{
+	strcat(accumulator, partial_accumulator);
+	free(partial_accumulator);
+}
+
+
+Test(list_reduce, parallel_reduce_combines_in_list_order)
+{
+	// given a big list of numbers, with a few prepended
+	linked_list * list = numbers_list();
+	static int prepended[] = { 7, 8, 9 };
+	for (int index = 0; index < 3; index++)
+		list_prepend(& list, & prepended[index]);
+
+	// when concatenating their last digit with several threads
+	char * parallel_digits = calloc(NUMBERS_COUNT + 4, 1);
+	list_reduce_parallel(
+		list,
+		8,
+		parallel_digits,
+		create_digits_buffer,
+		last_digit_reducer,
+		concatenation_combiner);
+
+	// then the digits should be in list order
+	char * digits = calloc(NUMBERS_COUNT + 4, 1);
+	list_reduce(list_head(list), digits, last_digit_reducer);
+	cr_assert_str_eq(parallel_digits, digits, "ranges weren't combined in order");
+}
+
+
+Test(list_reduce, parallel_reduce_on_empty_list_keeps_accumulator)
+{
+	// given an empty list
+	linked_list * list = list_create();
+
+	// when summing it with several threads
+	long sum = 42;
+	list_reduce_parallel(list, 4, & sum, create_sum, sum_reducer, sum_combiner);
+
+	// then the accumulator should be untouched
+	cr_assert_eq(sum, 42, "accumulator was changed");
+}
+
+
+Test(list_reduce, parallel_reduce_with_index_gives_same_result)
+{
+	// given a big indexed list of numbers, with a few removed
+	linked_list * list = numbers_list();
+	list_enable_position_index(list);
+	linked_list * node_to_remove = list_next(list);
+	list_remove_node(& node_to_remove);
+
+	// when summing it with several threads
+	long parallel_sum = 0;
+	list_reduce_parallel(list, 4, & parallel_sum, create_sum, sum_reducer, sum_combiner);
+
+	// then it should match the single threaded sum
+	long sum = 0;
+	list_reduce(list, & sum, sum_reducer);
+	cr_assert_eq(parallel_sum, sum, "parallel sum doesn't match");
+}
+
+
+Test(list_reduce, prefetching_reduce_gives_same_result_as_reduce)
+{
+	// given a big list of numbers
+	linked_list * list = numbers_list();
+
+	// when summing it with and without prefetching, at various distances
+	long sum = 0;
+	list_reduce(list, & sum, sum_reducer);
+	long unprefetched_sum = 0;
+	list_reduce_prefetch(list, 0, & unprefetched_sum, sum_reducer);
+	long prefetched_sum = 0;
+	list_reduce_prefetch(list, 8, & prefetched_sum, sum_reducer);
+	long far_prefetched_sum = 0;
+	list_reduce_prefetch(list, NUMBERS_COUNT * 2, & far_prefetched_sum, sum_reducer);
+
+	// then every sum should match
+	cr_assert_eq(unprefetched_sum, sum, "sum without prefetching doesn't match");
+	cr_assert_eq(prefetched_sum, sum, "sum with prefetching doesn't match");
+	cr_assert_eq(far_prefetched_sum, sum, "sum prefetching past the tail doesn't match");
+}
+
+
+Test(list_reduce, prefetching_reduce_on_empty_list_keeps_accumulator)
+{
+	// given an empty pooled list
+	linked_list * list = list_create_pooled(0);
+
+	// when summing it with prefetching
+	long sum = 42;
+	list_reduce_prefetch(list, 8, & sum, sum_reducer);
+
+	// then the accumulator should be untouched
+	cr_assert_eq(sum, 42, "accumulator was changed");
+}
+
+
+typedef struct batches_record
+{
+	size_t batches_count;
+	size_t largest_batch;
+	long sum;
+	int last_value;
+	int in_order;
+} batches_record;
+
+
+static void recording_batch_reducer(
+	void * accumulator,
+	void const * const * values,
+	size_t count)
+{
+	batches_record * record = accumulator;
+
+	record->batches_count++;
+	if (count > record->largest_batch)
+		record->largest_batch = count;
+
+	for (size_t index = 0; index < count; index++)
+	{
+		int value = * (int const *) values[index];
+		record->in_order = record->in_order && value == record->last_value + 1;
+		record->last_value = value;
+		record->sum += value;
+	}
+}
+
+
+Test(list_reduce, batch_reduce_gives_every_value_in_order)
+{
+	// given a big list of numbers
+	linked_list * list = numbers_list();
+
+	// when reducing it by batches
+	batches_record record = { 0, 0, 0, -1, 1 };
+	list_reduce_batch(list, & record, recording_batch_reducer);
+
+	// then every value should be given once, in order, in full batches
+	long sum = 0;
+	list_reduce(list, & sum, sum_reducer);
+	cr_assert_eq(record.sum, sum, "sum of batches doesn't match");
+	cr_assert(record.in_order, "values weren't given in order");
+	cr_assert_eq(record.largest_batch, LIST_BATCH_SIZE, "batches aren't full");
+	cr_assert_eq(
+		record.batches_count,
+		(NUMBERS_COUNT + LIST_BATCH_SIZE - 1) / LIST_BATCH_SIZE,
+		"wrong batches count");
+}
+
+
+Test(list_reduce, batch_reduce_on_empty_list_doesnt_call_reducer)
+{
+	// given an empty list
+	linked_list * list = list_create_pooled(0);
+
+	// when reducing it by batches
+	batches_record record = { 0, 0, 0, -1, 1 };
+	list_reduce_batch(list, & record, recording_batch_reducer);
+
+	// then the reducer shouldn't be called
+	cr_assert_eq(record.batches_count, 0, "reducer was called");
+}
+
+
+typedef struct record
+{
+	int id;
+	int version;
+} record;
+
+
+
+
+#ifdef DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+/**
+ * Nodes and values of a big list are handed out in shuffled order by an
+ * arena, so walking the list jumps all over memory like a long lived heap
+ */
+typedef struct shuffled_arena
+{
+	char * memory;
+	size_t * order;
+	size_t next;
+} shuffled_arena;
+
+
+static void * shuffled_allocate(size_t size, void * context)
+{
+	shuffled_arena * arena = context;
+
+	if (size > 64)
+		return malloc(size); // header
+	return arena->memory + arena->order[arena->next++] * 64;
+}
+
+
+static void shuffle(size_t * order, size_t count)
+{
+	for (size_t index = 0; index < count; index++)
+		order[index] = index;
+
+	srand(42);
+	for (size_t index = count - 1; index > 0; index--)
+	{
+		size_t other = ((size_t) rand() * RAND_MAX + rand()) % (index + 1);
+		size_t swapped = order[index];
+		order[index] = order[other];
+		order[other] = swapped;
+	}
+}
+
+
+static linked_list * scattered_list(shuffled_arena * arena, int * values)
+{
+	size_t * values_order = malloc(BIG_LIST_SIZE * sizeof(size_t));
+	shuffle(values_order, BIG_LIST_SIZE);
+
+	arena->memory = malloc((size_t) BIG_LIST_SIZE * 64);
+	arena->order = malloc(BIG_LIST_SIZE * sizeof(size_t));
+	arena->next = 0;
+	shuffle(arena->order, BIG_LIST_SIZE);
+
+	list_allocator allocator = { shuffled_allocate, NULL, arena };
+	linked_list * list = list_create_with_allocator(& allocator);
+	for (size_t index = 0; index < BIG_LIST_SIZE; index++)
+		list_append(& list, & values[values_order[index] * 16]);
+
+	free(values_order);
+	return list;
+}
+
+
+static double benchmark_reducing_time(linked_list * list, size_t distance)
+{
+	long sum = 0;
+	clock_t start = clock();
+	if (distance == 0)
+		list_reduce(list, & sum, sum_reducer);
+	else
+		list_reduce_prefetch(list, distance, & sum, sum_reducer);
+	clock_t end = clock();
+	return ((double)(end - start)) / CLOCKS_PER_SEC;
+}
+
+
+Test(list_reduce, prefetching_reduce_is_faster_on_scattered_list)
+{
+	// given a big list whose nodes and values are scattered in memory
+	shuffled_arena arena;
+	int * values = calloc((size_t) BIG_LIST_SIZE * 16, sizeof(int));
+	linked_list * list = scattered_list(& arena, values);
+
+	// when measuring time it takes to reduce it...
+	double reducing_time = benchmark_reducing_time(list, 0);
+	// ... and measuring time it takes to reduce it with prefetching
+	double prefetching_time = benchmark_reducing_time(list, 8);
+
+	// then prefetching should hide part of the cache misses
+	cr_assert_lt(
+		prefetching_time,
+		reducing_time,
+		"prefetching doesn't speed the reduction up");
+}
+
+#endif /* DO_CONSTANT_TIME_BENCHMARK_TESTS */
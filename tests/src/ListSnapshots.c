@@ -0,0 +1,313 @@
+#include <criterion/criterion.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../include/List.h"
+
+/**
+ * Some operations are in constant time O(1), but involve big lists to test
+ * Those tests are disabled by default, since there's no reason they would go
+ * back to O(n) complexity, timings are tracked by make bench instead
+ */
+// #define DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+
+
+
+static int ranks[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+
+static linked_list * ranks_list(list_allocator const * allocator, size_t from, size_t to)
+{
+	linked_list * list = allocator ? list_create_with_allocator(allocator) : list_create();
+	for (size_t index = from; index < to; index++)
+		list_append(& list, & ranks[index]);
+	return list;
+}
+
+
+static int compare_ints(void const * first, void const * second)
+{
+	int a = * (int const *) first;
+	int b = * (int const *) second;
+	return (a > b) - (a < b);
+}
+
+
+#define SNAPSHOT_VALUES_COUNT 1000
+
+
+static int snapshot_values[SNAPSHOT_VALUES_COUNT];
+
+
+typedef struct collected_values
+{
+	int values[SNAPSHOT_VALUES_COUNT];
+	size_t count;
+} collected_values;
+
+
+static void collect_reducer(void * accumulator, void const * value)
+{
+	collected_values * collected = accumulator;
+	collected->values[collected->count++] = * (int const *) value;
+}
+
+
+static void assert_view_holds(list_view const * view, int const * expected, size_t count)
+{
+	cr_assert_eq(list_view_size(view), count, "wrong view size");
+	collected_values collected = { .count = 0 };
+	list_view_reduce(view, & collected, collect_reducer);
+	cr_assert_eq(collected.count, count, "wrong count of reduced values");
+	for (size_t index = 0; index < count; index++)
+	{
+		cr_assert_eq(collected.values[index], expected[index], "wrong value at %zu", index);
+		cr_assert_eq(* (int *) list_view_at(view, index), expected[index], "wrong value at position %zu", index);
+	}
+	cr_assert_null(list_view_at(view, count), "view goes on");
+}
+
+
+Test(list_snapshots, snapshot_keeps_its_values_while_the_list_changes)
+{
+	// given a list with snapshots, and a snapshot of it
+	linked_list * list = ranks_list(NULL, 0, 5);
+	cr_assert_eq(list_enable_snapshots(list), 1, "snapshots weren't enabled");
+	list_view * view = list_snapshot(list);
+	list_view * same = list_snapshot(list);
+
+	// when appending, prepending and removing values
+	list_append(& list, & ranks[7]);
+	list_prepend(& list, & ranks[9]);
+	linked_list * removed = list_at(list, 3);
+	list_remove_node(& removed);
+	list_view * changed = list_snapshot(list);
+
+	// then the snapshot should be unchanged, while a new one follows the list
+	assert_view_holds(view, (int []) { 0, 1, 2, 3, 4 }, 5);
+	assert_view_holds(changed, (int []) { 9, 0, 1, 3, 4, 7 }, 6);
+	cr_assert_eq(list_view_version(view), list_view_version(same), "unchanged list changed version");
+	cr_assert_gt(list_view_version(changed), list_view_version(view), "changed list kept its version");
+	list_view_release(& view);
+	list_view_release(& same);
+	list_view_release(& changed);
+	cr_assert_null(view, "view wasn't set to NULL");
+	list_delete(& list);
+}
+
+
+Test(list_snapshots, snapshot_of_list_without_snapshots_copies_it)
+{
+	// given a list without snapshots
+	linked_list * list = ranks_list(NULL, 0, 10);
+
+	// when taking a snapshot then emptying the list
+	list_view * view = list_snapshot(list);
+	list_delete(& list);
+
+	// then the snapshot should still hold the values, outliving the list
+	assert_view_holds(view, ranks, 10);
+	cr_assert_eq(list_view_version(view), 0, "copy has a version");
+	list_view_release(& view);
+}
+
+
+Test(list_snapshots, snapshots_taken_along_changes_keep_their_values)
+{
+	// given a list with snapshots
+	for (int index = 0; index < SNAPSHOT_VALUES_COUNT; index++)
+		snapshot_values[index] = index;
+	linked_list * list = NULL;
+	list_append(& list, & snapshot_values[0]);
+	list_enable_snapshots(list);
+	int expected[SNAPSHOT_VALUES_COUNT] = { 0 };
+	size_t size = 1;
+
+	// when changing it at random, taking snapshots along
+	static int expected_views[20][SNAPSHOT_VALUES_COUNT];
+	size_t view_sizes[20];
+	list_view * views[20];
+	unsigned int seed = 7;
+	for (int change = 0; change < 2000; change++)
+	{
+		int * value = & snapshot_values[rand_r(& seed) % SNAPSHOT_VALUES_COUNT];
+		int kind = rand_r(& seed) % 3;
+		if (kind == 0 && size < SNAPSHOT_VALUES_COUNT)
+		{
+			list_append(& list, value);
+			expected[size++] = * value;
+		}
+		else if (kind == 1 && size < SNAPSHOT_VALUES_COUNT)
+		{
+			list_prepend(& list, value);
+			memmove(expected + 1, expected, size++ * sizeof(int));
+			expected[0] = * value;
+		}
+		else if (size > 1)
+		{
+			// the handle is kept, so the list isn't emptied
+			size_t position = rand_r(& seed) % size;
+			linked_list * node = list_at(list, position);
+			if (node == list)
+				continue;
+			list_remove_node(& node);
+			memmove(expected + position, expected + position + 1, (--size - position) * sizeof(int));
+		}
+		if (change % 100 == 0)
+		{
+			views[change / 100] = list_snapshot(list);
+			memcpy(expected_views[change / 100], expected, size * sizeof(int));
+			view_sizes[change / 100] = size;
+		}
+	}
+
+	// then every snapshot should hold the values the list had then
+	for (int index = 0; index < 20; index++)
+	{
+		assert_view_holds(views[index], expected_views[index], view_sizes[index]);
+		list_view_release(& views[index]);
+	}
+	list_view * view = list_snapshot(list);
+	assert_view_holds(view, expected, size);
+	list_view_release(& view);
+	list_delete(& list);
+}
+
+
+Test(list_snapshots, snapshot_after_moving_nodes_follows_the_list)
+{
+	// given a list with snapshots, in reverse order, and a snapshot of it
+	linked_list * list = NULL;
+	for (int index = 9; index >= 0; index--)
+		list_append(& list, & ranks[index]);
+	list_enable_snapshots(list);
+	list_view * reversed = list_snapshot(list);
+
+	// when sorting it, then appending to it
+	list_sort(& list, compare_ints);
+	list_append(& list, & ranks[0]);
+	list_view * sorted = list_snapshot(list);
+
+	// then the snapshots should hold the values in their order then
+	assert_view_holds(reversed, (int []) { 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 }, 10);
+	assert_view_holds(sorted, (int []) { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0 }, 11);
+	list_view_release(& reversed);
+	list_view_release(& sorted);
+	list_delete(& list);
+}
+
+
+static void * append_values(void * argument)
+{
+	linked_list * list = argument;
+
+	for (int index = 0; index < SNAPSHOT_VALUES_COUNT; index++)
+		list_append(& list, & snapshot_values[index]);
+
+	return NULL;
+}
+
+
+Test(list_snapshots, snapshots_of_synchronized_list_are_consistent_while_it_grows)
+{
+	// given a synchronized list with snapshots
+	for (int index = 0; index < SNAPSHOT_VALUES_COUNT; index++)
+		snapshot_values[index] = index;
+	linked_list * list = list_create_synchronized();
+	cr_assert_eq(list_enable_snapshots(list), 1, "snapshots weren't enabled");
+
+	// when taking snapshots while a writer appends values
+	pthread_t writer;
+	pthread_create(& writer, NULL, append_values, list);
+	size_t last_size = 0;
+	int failed = 0;
+	while (last_size < SNAPSHOT_VALUES_COUNT)
+	{
+		list_view * view = list_snapshot(list);
+		collected_values collected = { .count = 0 };
+		list_view_reduce(view, & collected, collect_reducer);
+		failed |= collected.count < last_size;
+		for (size_t index = 0; index < collected.count; index++)
+			failed |= collected.values[index] != (int) index;
+		last_size = collected.count;
+		list_view_release(& view);
+	}
+	pthread_join(writer, NULL);
+
+	// then every snapshot should have held the values appended so far
+	cr_assert_not(failed, "a snapshot saw values out of order");
+	list_delete(& list);
+}
+
+
+Test(list_snapshots, concurrent_list_has_no_snapshot)
+{
+	// given a concurrent list
+	linked_list * list = list_create_concurrent();
+
+	// when taking snapshots of it
+	int enabled = list_enable_snapshots(list);
+	list_view * view = list_snapshot(list);
+
+	// then it should be refused
+	cr_assert_eq(enabled, 0, "concurrent list has snapshots");
+	cr_assert_null(view, "concurrent list was snapshot");
+	list_delete(& list);
+}
+
+
+
+
+#ifdef DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+static double wall_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, & now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+#define SORTED_LIST_SIZE 2000000
+
+
+static linked_list * shuffled_numbers_list(int * values)
+{
+	linked_list * list = NULL;
+	for (long index = 0; index < SORTED_LIST_SIZE; index++)
+	{
+		values[index] = (int) ((index * 1000003L) % SORTED_LIST_SIZE);
+		list_append(& list, & values[index]);
+	}
+	return list;
+}
+
+
+Test(list_snapshots, snapshot_is_faster_than_copying_the_list)
+{
+	// given a big list with snapshots
+	linked_list * list = shuffled_numbers_list(malloc(SORTED_LIST_SIZE * sizeof(int)));
+	list_enable_snapshots(list);
+
+	// when measuring time it takes to take a snapshot of it...
+	double start = wall_time();
+	list_view * view = list_snapshot(list);
+	double snapshot_time = wall_time() - start;
+	// ... and time it takes to copy its values
+	start = wall_time();
+	void ** copy = list_to_array(list);
+	double copying_time = wall_time() - start;
+
+	// then taking the snapshot should be faster
+	cr_assert_eq(list_view_size(view), SORTED_LIST_SIZE, "snapshot misses values");
+	cr_assert_lt(snapshot_time, copying_time, "snapshot is slower than copying");
+	list_view_release(& view);
+	free(copy);
+	free(list_content(list_head(list)));
+	list_delete(& list);
+}
+
+#endif /* DO_CONSTANT_TIME_BENCHMARK_TESTS */
@@ -0,0 +1,247 @@
+#include <criterion/criterion.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../include/List.h"
+
+/**
+ * Some operations are in constant time O(1), but involve big lists to test
+ * Those tests are disabled by default, since there's no reason they would go
+ * back to O(n) complexity, timings are tracked by make bench instead
+ */
+// #define DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+
+
+
+static void assert_list_holds(linked_list * list, int const * expected, size_t count)
+{
+	cr_assert_eq(list_size(list), count, "wrong size");
+	linked_list * node = list_head(list);
+	for (size_t index = 0; index < count; index++, node = list_next(node))
+	{
+		cr_assert_not_null(node, "list ends at %zu", index);
+		cr_assert_eq(* (int *) list_content(node), expected[index], "wrong value at %zu", index);
+		cr_assert_eq(list_previous(list_next(node)), list_next(node) ? node : NULL, "broken link at %zu", index);
+	}
+	cr_assert_null(node, "list goes on");
+	cr_assert_eq(* (int *) list_content(list_tail(list)), expected[count - 1], "wrong tail");
+}
+
+
+static int compare_ints(void const * first, void const * second)
+{
+	int a = * (int const *) first;
+	int b = * (int const *) second;
+	return (a > b) - (a < b);
+}
+
+
+static int compare_tens(void const * first, void const * second)
+{
+	int a = * (int const *) first / 10;
+	int b = * (int const *) second / 10;
+	return (a > b) - (a < b);
+}
+
+
+Test(list_sort, sort_orders_values)
+{
+	// given a list in reverse order, with an odd size
+	static int values[999];
+	linked_list * list = NULL;
+	for (int index = 0; index < 999; index++)
+	{
+		values[index] = index;
+		list_prepend(& list, & values[index]);
+	}
+
+	// when sorting it, from a node in its middle
+	linked_list * handle = list_at(list, 500);
+	list_sort(& handle, compare_ints);
+
+	// then values should be in order, and the handle be the head
+	assert_list_holds(handle, values, 999);
+	cr_assert_eq(handle, list_head(handle), "handle isn't the head");
+	list_delete(& handle);
+}
+
+
+Test(list_sort, sort_keeps_the_order_of_equal_values)
+{
+	// given a list of shuffled values, some of them equal once compared
+	static int values[100];
+	linked_list * list = NULL;
+	for (int index = 0; index < 100; index++)
+	{
+		values[index] = (index * 37) % 100;
+		list_append(& list, & values[index]);
+	}
+
+	// when sorting it by tens
+	list_sort(& list, compare_tens);
+
+	// then tens should be in order, and equal tens in their former order
+	linked_list * previous = list;
+	for (linked_list * node = list_next(list); node != NULL; node = list_next(node))
+	{
+		int const * before = list_content(previous);
+		int const * value = list_content(node);
+		cr_assert(* before / 10 <= * value / 10, "%d is before %d", * before, * value);
+		if (* before / 10 == * value / 10)
+			cr_assert(before < value, "%d moved before %d", * value, * before);
+		previous = node;
+	}
+	cr_assert_eq(list_size(list), 100, "nodes were lost");
+	list_delete(& list);
+}
+
+
+Test(list_sort, sort_renumbers_positions)
+{
+	// given an indexed list of shuffled values
+	static int values[64];
+	linked_list * list = NULL;
+	for (int index = 0; index < 64; index++)
+	{
+		values[index] = (index * 5) % 64;
+		list_append(& list, & values[index]);
+	}
+	list_enable_position_index(list);
+
+	// when sorting it
+	list_sort(& list, compare_ints);
+
+	// then positions should follow the new order
+	for (int index = 0; index < 64; index++)
+	{
+		linked_list * node = list_at(list, index);
+		cr_assert_eq(* (int *) list_content(node), index, "wrong node at %d", index);
+		cr_assert_eq(list_index_of(node), (size_t) index, "wrong position of %d", index);
+	}
+	list_delete(& list);
+}
+
+
+static void assert_sorted_stably(linked_list * list, size_t size, int (* comparator)(void const *, void const *))
+{
+	cr_assert_eq(list_size(list), size, "nodes were lost");
+	cr_assert_eq(list_head(list), list, "list isn't set to its head");
+	cr_assert_null(list_previous(list), "head has a previous node");
+	size_t walked = 1;
+	for (linked_list * node = list_next(list); node != NULL; node = list_next(node), walked++)
+	{
+		int const * before = list_content(list_previous(node));
+		int const * value = list_content(node);
+		cr_assert(comparator(before, value) <= 0, "%d is before %d", * before, * value);
+		if (comparator(before, value) == 0)
+			cr_assert(before < value, "%d moved before %d", * value, * before);
+	}
+	cr_assert_eq(walked, size, "links are broken");
+	cr_assert_null(list_next(list_tail(list)), "tail has a next node");
+}
+
+
+Test(list_sort, sort_parallel_orders_values_stably)
+{
+	// given lists of shuffled values, with many equal ones once compared by tens
+	static int values[10007];
+	for (size_t threads_count = 1; threads_count <= 9; threads_count += 4)
+	{
+		linked_list * list = NULL;
+		for (int index = 0; index < 10007; index++)
+		{
+			values[index] = (int) ((index * 7919L) % 10007);
+			list_append(& list, & values[index]);
+		}
+		linked_list * by_tens = NULL;
+		for (int index = 0; index < 10007; index += 7)
+			list_append(& by_tens, & values[index]);
+
+		// when sorting them with several threads
+		list_sort_parallel(& list, threads_count, compare_ints);
+		list_sort_parallel(& by_tens, threads_count, compare_tens);
+
+		// then they should be sorted, equal values kept in their former order
+		assert_sorted_stably(list, 10007, compare_ints);
+		assert_sorted_stably(by_tens, 1430, compare_tens);
+		list_delete(& list);
+		list_delete(& by_tens);
+	}
+}
+
+
+Test(list_sort, sort_parallel_falls_back_on_small_lists)
+{
+	// given a list too small to be cut in runs
+	static int values[100];
+	linked_list * list = NULL;
+	for (int index = 0; index < 100; index++)
+	{
+		values[index] = 99 - index;
+		list_append(& list, & values[99 - index]);
+	}
+
+	// when sorting it with many threads
+	list_sort_parallel(& list, 64, compare_ints);
+
+	// then it should still be sorted
+	assert_sorted_stably(list, 100, compare_ints);
+	list_delete(& list);
+}
+
+
+
+
+#ifdef DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+static double wall_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, & now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+#define SORTED_LIST_SIZE 2000000
+
+
+static linked_list * shuffled_numbers_list(int * values)
+{
+	linked_list * list = NULL;
+	for (long index = 0; index < SORTED_LIST_SIZE; index++)
+	{
+		values[index] = (int) ((index * 1000003L) % SORTED_LIST_SIZE);
+		list_append(& list, & values[index]);
+	}
+	return list;
+}
+
+
+Test(list_sort, parallel_sort_is_faster_than_sort)
+{
+	// given 2 lists of the same shuffled values
+	int * values = malloc(SORTED_LIST_SIZE * sizeof(int));
+	linked_list * list = shuffled_numbers_list(values);
+	linked_list * other = shuffled_numbers_list(values);
+	long threads_count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	// when measuring time it takes to sort one on a single thread...
+	double start = wall_time();
+	list_sort(& list, compare_ints);
+	double sequential_time = wall_time() - start;
+	// ... and time it takes to sort the other one on every core
+	start = wall_time();
+	list_sort_parallel(& other, threads_count, compare_ints);
+	double parallel_time = wall_time() - start;
+
+	// then sorting in parallel should be faster, given several cores
+	if (threads_count > 1)
+		cr_assert_lt(parallel_time, sequential_time, "parallel sort is slower than sort");
+	list_delete(& list);
+	list_delete(& other);
+	free(values);
+}
+
+#endif /* DO_CONSTANT_TIME_BENCHMARK_TESTS */
@@ -0,0 +1,297 @@
+#include <criterion/criterion.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../include/List.h"
+#include "../../include/ListNode.h"
+
+/**
+ * Some operations are in constant time O(1), but involve big lists to test
+ * Those tests are disabled by default, since there's no reason they would go
+ * back to O(n) complexity, timings are tracked by make bench instead
+ */
+// #define DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+
+
+
+static size_t encode_string(void const * value, void * bytes, size_t capacity)
+{
+	size_t size = strlen(value);
+	if (size <= capacity)
+		memcpy(bytes, value, size);
+	return size;
+}
+
+
+static void * decode_string(void const * bytes, size_t size)
+{
+	char * value = malloc(size + 1);
+	memcpy(value, bytes, size);
+	value[size] = '\0';
+	return value;
+}
+
+
+static void * refuse_long_strings(void const * bytes, size_t size)
+{
+	return (size < 5) ? decode_string(bytes, size) : NULL;
+}
+
+
+static void delete_strings(linked_list ** list)
+{
+	for (linked_list * node = list_head(* list); node != NULL; node = list_next(node))
+		free(list_content(node));
+	list_delete(list);
+}
+
+
+static linked_list * strings_list(char (* strings)[8], int count)
+{
+	linked_list * list = NULL;
+	for (int index = 0; index < count; index++)
+	{
+		sprintf(strings[index], "%d", index);
+		list_append(& list, strings[index]);
+	}
+	return list;
+}
+
+
+static void assert_same_strings(linked_list * list, linked_list * other)
+{
+	cr_assert_eq(list_size(list), list_size(other), "sizes differ");
+	for (linked_list * node = list_head(other); node != NULL; node = list_next(node))
+	{
+		cr_assert_str_eq(list_content(list), list_content(node), "values differ");
+		list = list_next(list);
+	}
+}
+
+
+Test(list_stream, written_list_is_read_back)
+{
+	// given a file holding a list spanning several chunks, one value not
+	// fitting in a chunk, and another list after it
+	static char strings[50000][8];
+	linked_list * list = strings_list(strings, 50000);
+	char * big = malloc(200000);
+	memset(big, 'x', 199999);
+	big[199999] = '\0';
+	list_insert_array_after(list_at(list, 20000), (void * []) { big }, 1);
+	linked_list * other = strings_list(strings, 3);
+	FILE * file = tmpfile();
+	cr_assert_eq(list_write(fileno(file), list, encode_string), 1, "list wasn't written");
+	cr_assert_eq(list_write(fileno(file), other, encode_string), 1, "other list wasn't written");
+	lseek(fileno(file), 0, SEEK_SET);
+
+	// when reading both lists
+	linked_list * read = NULL;
+	int is_read = list_read(fileno(file), & read, decode_string);
+	linked_list * other_read = NULL;
+	int is_other_read = list_read(fileno(file), & other_read, decode_string);
+
+	// then they should hold the same values
+	cr_assert(is_read && is_other_read, "lists weren't read");
+	assert_same_strings(list, read);
+	assert_same_strings(other, other_read);
+	fclose(file);
+	free(big);
+	delete_strings(& read);
+	delete_strings(& other_read);
+}
+
+
+Test(list_stream, read_list_nodes_are_allocated_at_once)
+{
+	// given a file holding a list
+	static char strings[5000][8];
+	linked_list * list = strings_list(strings, 5000);
+	FILE * file = tmpfile();
+	list_write(fileno(file), list, encode_string);
+	lseek(fileno(file), 0, SEEK_SET);
+
+	// when reading it
+	linked_list * read = NULL;
+	list_read(fileno(file), & read, decode_string);
+
+	// then its nodes should follow each other in memory
+	for (linked_list * node = list_head(read); list_next(node) != NULL; node = list_next(node))
+		cr_assert_eq(list_next(node), node + 1, "nodes aren't contiguous");
+	fclose(file);
+	delete_strings(& read);
+}
+
+
+Test(list_stream, empty_list_is_written_and_read_back)
+{
+	// given a file holding an empty list
+	FILE * file = tmpfile();
+	cr_assert_eq(list_write(fileno(file), NULL, encode_string), 1, "list wasn't written");
+	lseek(fileno(file), 0, SEEK_SET);
+
+	// when reading it
+	linked_list * read = NULL;
+	int is_read = list_read(fileno(file), & read, decode_string);
+
+	// then nothing should be read
+	cr_assert_eq(is_read, 1, "list wasn't read");
+	cr_assert_null(read, "values were read");
+	fclose(file);
+}
+
+
+Test(list_stream, reading_stops_at_invalid_values_keeping_previous_ones)
+{
+	// given a file holding a list with a value too long for the decoder
+	static char strings[20000][8];
+	linked_list * list = strings_list(strings, 20000);
+	FILE * file = tmpfile();
+	list_write(fileno(file), list, encode_string);
+	lseek(fileno(file), 0, SEEK_SET);
+
+	// when reading it
+	linked_list * read = NULL;
+	int is_read = list_read(fileno(file), & read, refuse_long_strings);
+
+	// then the values before it should be read
+	cr_assert_eq(is_read, 0, "invalid value was read");
+	cr_assert_eq(list_size(read), 10000, "wrong number of values read");
+	cr_assert_str_eq(list_content(list_tail(read)), "9999", "wrong last value");
+	fclose(file);
+	delete_strings(& read);
+}
+
+
+Test(list_stream, forged_count_only_reserves_nodes_for_read_values)
+{
+	// given a file holding a list, whose count claims far more values
+	static char strings[100][8];
+	linked_list * list = strings_list(strings, 100);
+	FILE * file = tmpfile();
+	list_write(fileno(file), list, encode_string);
+	unsigned char forged_count[8] = { 0, 0, 0, 0, 0, 1, 0, 0 }; // 2^40
+	pwrite(fileno(file), forged_count, sizeof(forged_count), 4);
+	lseek(fileno(file), 0, SEEK_SET);
+
+	// when reading it in a pooled list
+	linked_list * read = list_create_pooled(0);
+	int is_read = list_read(fileno(file), & read, decode_string);
+
+	// then only the values actually there should be read, without reserving the others
+	cr_assert_eq(is_read, 0, "forged list was read");
+	cr_assert_eq(list_size(read), 100, "wrong number of values read");
+	fclose(file);
+	delete_strings(& read);
+	list_delete(& list);
+}
+
+
+Test(list_stream, reading_truncated_or_foreign_stream_fails)
+{
+	// given a file holding a truncated list, and one holding something else
+	static char strings[100][8];
+	linked_list * list = strings_list(strings, 100);
+	FILE * file = tmpfile();
+	list_write(fileno(file), list, encode_string);
+	ftruncate(fileno(file), lseek(fileno(file), 0, SEEK_CUR) - 1);
+	lseek(fileno(file), 0, SEEK_SET);
+	FILE * foreign = tmpfile();
+	write(fileno(foreign), "not a list, at all", 18);
+	lseek(fileno(foreign), 0, SEEK_SET);
+
+	// when reading them
+	linked_list * read = NULL;
+	int is_read = list_read(fileno(file), & read, decode_string);
+	linked_list * foreign_read = NULL;
+	int is_foreign_read = list_read(fileno(foreign), & foreign_read, decode_string);
+
+	// then reading should fail
+	cr_assert_eq(is_read, 0, "truncated list was read");
+	cr_assert_null(read, "truncated chunk was kept");
+	cr_assert_eq(is_foreign_read, 0, "foreign data was read");
+	cr_assert_null(foreign_read, "foreign values were read");
+	fclose(file);
+	fclose(foreign);
+}
+
+
+
+
+#ifdef DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+static double wall_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, & now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+#define SORTED_LIST_SIZE 2000000
+
+
+static linked_list * shuffled_numbers_list(int * values)
+{
+	linked_list * list = NULL;
+	for (long index = 0; index < SORTED_LIST_SIZE; index++)
+	{
+		values[index] = (int) ((index * 1000003L) % SORTED_LIST_SIZE);
+		list_append(& list, & values[index]);
+	}
+	return list;
+}
+
+
+static size_t encode_int(void const * value, void * bytes, size_t capacity)
+{
+	if (sizeof(int) <= capacity)
+		memcpy(bytes, value, sizeof(int));
+	return sizeof(int);
+}
+
+
+static void * decode_int(void const * bytes, size_t size)
+{
+	static int values[SORTED_LIST_SIZE];
+	static size_t count = 0;
+	memcpy(& values[count], bytes, size);
+	return & values[count++];
+}
+
+
+Test(list_stream, reading_list_is_faster_than_appending_values_one_by_one)
+{
+	// given a file holding a big list
+	linked_list * list = shuffled_numbers_list(malloc(SORTED_LIST_SIZE * sizeof(int)));
+	FILE * file = tmpfile();
+	list_write(fileno(file), list, encode_int);
+	lseek(fileno(file), 0, SEEK_SET);
+
+	// when measuring time it takes to read it...
+	double start = wall_time();
+	linked_list * read = NULL;
+	list_read(fileno(file), & read, decode_int);
+	double reading_time = wall_time() - start;
+	// ... and time it takes to append its values one by one
+	start = wall_time();
+	linked_list * appended = NULL;
+	for (linked_list * node = list_head(list); node != NULL; node = list_next(node))
+		list_append(& appended, list_content(node));
+	double appending_time = wall_time() - start;
+
+	// then reading should be faster
+	cr_assert_eq(list_size(read), SORTED_LIST_SIZE, "list wasn't read");
+	cr_assert_lt(reading_time, appending_time, "reading is slower than appending");
+	fclose(file);
+	free(list_content(list_head(list)));
+	list_delete(& list);
+	list_delete(& read);
+	list_delete(& appended);
+}
+
+#endif /* DO_CONSTANT_TIME_BENCHMARK_TESTS */
@@ -0,0 +1,272 @@
+#include <criterion/criterion.h>
+#include <time.h>
+
+#include "../../include/List.h"
+
+/**
+ * Some operations are in constant time O(1), but involve big lists to test
+ * Those tests are disabled by default, since there's no reason they would go
+ * back to O(n) complexity, timings are tracked by make bench instead
+ */
+// #define DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+
+
+
+static int compare_ints(void const * first, void const * second)
+{
+	int a = * (int const *) first;
+	int b = * (int const *) second;
+	return (a > b) - (a < b);
+}
+
+
+static int equals_int(void const * value, void const * key)
+{
+	return * (int const *) value == * (int const *) key;
+}
+
+
+static size_t hash_int(void const * key)
+{
+	return (size_t) * (int const *) key;
+}
+
+
+static linked_list * find_by_walking(linked_list const * list, int key)
+{
+	for (linked_list * node = list_head(list); node != NULL; node = list_next(node))
+	{
+		if (* (int *) list_content(node) == key)
+			return node;
+	}
+	return NULL;
+}
+
+
+Test(list_value_index, find_gives_first_matching_node)
+{
+	// given a list holding a value twice
+	static int values[] = { 4, 8, 15, 8 };
+	linked_list * list = NULL;
+	for (int index = 0; index < 4; index++)
+		list_append(& list, & values[index]);
+
+	// when looking for values
+	int key = 8;
+	linked_list * found = list_find(list, & key, equals_int);
+	key = 16;
+	linked_list * missing = list_find(list, & key, equals_int);
+
+	// then the first holder should be found, and nothing for missing ones
+	cr_assert_eq(list_content(found), & values[1], "wrong node found");
+	cr_assert_null(missing, "missing value was found");
+	cr_assert_eq(list_find(list, & values[3], NULL), list_tail(list), "value address wasn't found");
+	list_delete(& list);
+}
+
+
+Test(list_value_index, find_with_value_index_matches_walk)
+{
+	// given an indexed list holding duplicates, grown on both ends past its
+	// spare entries, with nodes removed and inserted in the middle
+	static int values[3000];
+	linked_list * list = NULL;
+	list_append(& list, & values[0]);
+	cr_assert_eq(list_enable_value_index(list, hash_int, NULL), 1, "index wasn't built");
+	for (int index = 1; index < 3000; index++)
+	{
+		values[index] = index % 700;
+		if (index % 3 == 0)
+			list_prepend(& list, & values[index]);
+		else
+			list_append(& list, & values[index]);
+	}
+	for (int key = 0; key < 700; key += 7)
+	{
+		linked_list * node_to_remove = list_find(list, & key, equals_int);
+		list = (list_next(node_to_remove) != NULL) ? list_next(node_to_remove) : list_head(list);
+		list_remove_node(& node_to_remove);
+	}
+	static int inserted_values[] = { 1, 2, 3 };
+	void * inserted[] = { & inserted_values[0], & inserted_values[1], & inserted_values[2] };
+	list_insert_array_after(list_at(list, 10), inserted, 3);
+
+	// when looking for every value, and a missing one
+	// then the first holder should be found
+	for (int key = 0; key < 701; key++)
+		cr_assert_eq(list_find(list, & key, equals_int), find_by_walking(list, key), "wrong node for %d", key);
+	list_delete(& list);
+}
+
+
+typedef struct record
+{
+	int id;
+	int version;
+} record;
+
+
+static void const * id_of(void const * value)
+{
+	return & ((record const *) value)->id;
+}
+
+
+Test(list_value_index, find_then_remove_with_keys_drops_duplicates)
+{
+	// given an indexed list of records, keyed by their id
+	static record records[1000];
+	linked_list * list = NULL;
+	for (int index = 0; index < 1000; index++)
+	{
+		records[index].id = index;
+		list_append(& list, & records[index]);
+	}
+	list_enable_value_index(list, hash_int, id_of);
+
+	// when appending new versions, dropping the previous ones
+	static record updates[500];
+	for (int index = 0; index < 500; index++)
+	{
+		updates[index].id = index * 2;
+		updates[index].version = 1;
+		linked_list * previous = list_find(list, & updates[index].id, equals_int);
+		if (previous == list)
+			list = list_next(list);
+		list_remove_node(& previous);
+		list_append(& list, & updates[index]);
+	}
+
+	// then every id should be held once, by its latest version
+	cr_assert_eq(list_size(list), 1000, "wrong size");
+	for (int id = 0; id < 1000; id++)
+	{
+		record const * found = list_content(list_find(list, & id, equals_int));
+		cr_assert_eq(found->version, id % 2 == 0, "wrong version of %d", id);
+	}
+	cr_assert_eq(list_find(list, & updates[3], NULL), list_find(list, & updates[3].id, equals_int), "record address wasn't found");
+	list_delete(& list);
+}
+
+
+Test(list_value_index, find_with_value_index_follows_sort_and_split)
+{
+	// given an indexed list of values
+	static int values[200];
+	linked_list * list = NULL;
+	for (int index = 0; index < 200; index++)
+	{
+		values[index] = 199 - index;
+		list_append(& list, & values[index]);
+	}
+	list_enable_value_index(list, NULL, NULL);
+
+	// when sorting it, then splitting it in its middle
+	list_sort(& list, compare_ints);
+	linked_list * back = list_split_at(list_at(list, 100));
+
+	// then values should be found in the half holding them
+	cr_assert_eq(list_find(list, & values[199], NULL), list_head(list), "wrong node for lowest value");
+	cr_assert_null(list_find(list, & values[0], NULL), "moved value was found");
+	cr_assert_eq(list_find(back, & values[0], NULL), list_tail(back), "wrong node for greatest value");
+	list_delete(& list);
+	list_delete(& back);
+}
+
+
+Test(list_value_index, find_with_value_index_doesnt_give_removed_nodes)
+{
+	// given an indexed list holding a value 3 times among others
+	static int values[] = { 5, 7, 5, 9, 5 };
+	linked_list * list = NULL;
+	for (int index = 0; index < 5; index++)
+		list_append(& list, & values[index]);
+	list_enable_value_index(list, hash_int, NULL);
+
+	// when removing every holder of the value
+	int key = 5;
+	list = list_next(list);
+	for (linked_list * node; (node = list_find(list, & key, equals_int)) != NULL; )
+		list_remove_node(& node);
+
+	// then it shouldn't be found anymore, unlike the others
+	cr_assert_eq(list_size(list), 2, "wrong size");
+	cr_assert_null(list_find(list, & key, equals_int), "removed value was found");
+	cr_assert_eq(list_find(list, & values[3], NULL), list_tail(list), "kept value wasn't found");
+	list_delete(& list);
+}
+
+
+Test(list_value_index, value_index_isnt_built_for_shared_lists)
+{
+	// given a synchronized list
+	linked_list * list = list_create_synchronized();
+	static int values[] = { 1, 2 };
+	list_append(& list, & values[0]);
+	list_append(& list, & values[1]);
+
+	// when indexing it
+	int indexed = list_enable_value_index(list, hash_int, NULL);
+
+	// then it should be refused, but values still be found
+	cr_assert_eq(indexed, 0, "shared list was indexed");
+	cr_assert_eq(list_content(list_find(list, & values[1], equals_int)), & values[1], "value wasn't found");
+	list_delete(& list);
+}
+
+
+
+
+#ifdef DO_CONSTANT_TIME_BENCHMARK_TESTS
+
+static double wall_time(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, & now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+#define LOOKED_UP_LIST_SIZE 20000
+
+
+static double find_and_remove_every_value(linked_list * list, int * values)
+{
+	double start = wall_time();
+	for (int index = LOOKED_UP_LIST_SIZE - 1; index > 0; index--)
+	{
+		linked_list * node = list_find(list, & values[index], equals_int);
+		list_remove_node(& node);
+	}
+	return wall_time() - start;
+}
+
+
+Test(list_value_index, find_with_value_index_is_faster_than_walking)
+{
+	// given 2 lists of the same values, only one of them indexed
+	static int values[LOOKED_UP_LIST_SIZE];
+	linked_list * list = NULL;
+	linked_list * indexed = NULL;
+	for (int index = 0; index < LOOKED_UP_LIST_SIZE; index++)
+	{
+		values[index] = index;
+		list_append(& list, & values[index]);
+		list_append(& indexed, & values[index]);
+	}
+	list_enable_value_index(indexed, hash_int, NULL);
+
+	// when measuring time it takes to find and remove every value but the
+	// first one, from the end, in each list
+	double walking_time = find_and_remove_every_value(list, values);
+	double indexed_time = find_and_remove_every_value(indexed, values);
+
+	// then the indexed list should be faster
+	cr_assert_eq(list_size(indexed), 1, "values weren't all removed");
+	cr_assert_lt(indexed_time, walking_time, "indexed lookups are slower than walks");
+	list_delete(& list);
+	list_delete(& indexed);
+}
+
+#endif /* DO_CONSTANT_TIME_BENCHMARK_TESTS */
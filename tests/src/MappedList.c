@@ -0,0 +1,210 @@
+
+#include <criterion/criterion.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../include/MappedList.h"
+
+
+
+
+static char const * temporary_path(void)
+{
+	static char path[] = "/tmp/mapped_list_XXXXXX";
+	strcpy(path + strlen(path) - 6, "XXXXXX");
+	close(mkstemp(path));
+	unlink(path);
+	return path;
+}
+
+
+static void store_values_in_buffer_reducer(
+	void * accumulator,
+	void const * value)
+{
+	char * buffer = accumulator;
+
+	buffer[strlen(buffer)] = ((char *) value)[0];
+}
+
+
+static void sum_reducer(void * accumulator, void const * value)
+{
+	* (long *) accumulator += * (int const *) value;
+}
+
+
+
+
+Test(mapped_list, is_empty_on_creation)
+{
+	// given a new list
+	char const * path = temporary_path();
+	mapped_list * list = mapped_list_open(path, sizeof(int));
+
+	// when checking its size
+	size_t size = mapped_list_size(list);
+
+	// then it should be 0
+	cr_assert_not_null(list, "list wasn't created");
+	cr_assert_eq(size, 0, "list is not empty");
+	cr_assert_eq(
+		mapped_list_head(list),
+		MAPPED_LIST_NOWHERE,
+		"empty list has a head");
+	mapped_list_close(& list);
+	unlink(path);
+}
+
+
+Test(mapped_list, append_and_prepend_keep_order)
+{
+	// given an empty list
+	char const * path = temporary_path();
+	mapped_list * list = mapped_list_open(path, 1);
+
+	// when adding values from both ends
+	mapped_list_append(list, "2");
+	mapped_list_append(list, "3");
+	mapped_list_prepend(list, "1");
+
+	// then every value should be visited in order
+	char callback_buffer[4] = { 0 };
+	mapped_list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("123", callback_buffer, "values aren't in order");
+	cr_assert_eq(mapped_list_size(list), 3, "size doesn't match");
+	mapped_list_close(& list);
+	unlink(path);
+}
+
+
+Test(mapped_list, offsets_walk_both_ways)
+{
+	// given a list of 3 values
+	char const * path = temporary_path();
+	mapped_list * list = mapped_list_open(path, 1);
+	uint64_t first = mapped_list_append(list, "1");
+	uint64_t second = mapped_list_append(list, "2");
+	uint64_t third = mapped_list_append(list, "3");
+
+	// when moving from the head to the tail and back
+	uint64_t forward = mapped_list_next(list, mapped_list_next(list, first));
+	uint64_t backward = mapped_list_previous(list, third);
+
+	// then offsets should follow the links
+	cr_assert_eq(forward, third, "next doesn't follow the links");
+	cr_assert_eq(backward, second, "previous doesn't follow the links");
+	cr_assert_eq(mapped_list_tail(list), third, "wrong tail");
+	mapped_list_close(& list);
+	unlink(path);
+}
+
+
+Test(mapped_list, remove_returns_next_offset_and_reuses_node)
+{
+	// given a list of 3 values
+	char const * path = temporary_path();
+	mapped_list * list = mapped_list_open(path, 1);
+	mapped_list_append(list, "1");
+	uint64_t second = mapped_list_append(list, "2");
+	uint64_t third = mapped_list_append(list, "3");
+
+	// when removing the middle one then appending another value
+	uint64_t next = mapped_list_remove(list, second);
+	uint64_t reused = mapped_list_append(list, "4");
+
+	// then the removed node should be reused
+	cr_assert_eq(next, third, "remove didn't return the next offset");
+	cr_assert_eq(reused, second, "removed node wasn't reused");
+	char callback_buffer[4] = { 0 };
+	mapped_list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("134", callback_buffer, "values aren't in order");
+	mapped_list_close(& list);
+	unlink(path);
+}
+
+
+Test(mapped_list, removed_offset_has_no_content)
+{
+	// given a list of 2 values
+	char const * path = temporary_path();
+	mapped_list * list = mapped_list_open(path, 1);
+	uint64_t first = mapped_list_append(list, "1");
+	mapped_list_append(list, "2");
+
+	// when removing the first one
+	mapped_list_remove(list, first);
+
+	// then its offset shouldn't lead anywhere anymore
+	cr_assert_null(mapped_list_content(list, first), "removed node has a value");
+	cr_assert_eq(
+		mapped_list_remove(list, first),
+		MAPPED_LIST_NOWHERE,
+		"removed node was removed twice");
+	cr_assert_eq(mapped_list_size(list), 1, "size was decremented twice");
+	mapped_list_close(& list);
+	unlink(path);
+}
+
+
+Test(mapped_list, list_grown_past_its_file_is_found_again_once_reopened)
+{
+	// given a list grown well past the room of a new file, with removals
+	char const * path = temporary_path();
+	mapped_list * list = mapped_list_open(path, sizeof(int));
+	long expected_sum = 0;
+	for (int value = 0; value < 10000; value++)
+	{
+		uint64_t offset = (value % 2 == 0)
+			? mapped_list_append(list, & value)
+			: mapped_list_prepend(list, & value);
+		cr_assert_neq(offset, MAPPED_LIST_NOWHERE, "list didn't grow");
+		if (value % 5 == 0)
+			mapped_list_remove(list, offset);
+		else
+			expected_sum += value;
+	}
+	uint64_t head = mapped_list_head(list);
+	cr_assert_eq(mapped_list_sync(list), 1, "list wasn't synced");
+	mapped_list_close(& list);
+
+	// when opening it again
+	list = mapped_list_open(path, sizeof(int));
+
+	// then it should hold the same values, at the same offsets
+	cr_assert_not_null(list, "list wasn't opened");
+	cr_assert_eq(mapped_list_size(list), 8000, "size doesn't match");
+	cr_assert_eq(mapped_list_head(list), head, "head moved");
+	cr_assert_eq(* (int *) mapped_list_content(list, head), 9999, "wrong head value");
+	long sum = 0;
+	mapped_list_reduce(list, & sum, sum_reducer);
+	cr_assert_eq(sum, expected_sum, "values don't match");
+	mapped_list_close(& list);
+	unlink(path);
+}
+
+
+Test(mapped_list, file_of_other_values_isnt_opened)
+{
+	// given a file holding a list of ints, and a file holding something else
+	char const * path = temporary_path();
+	mapped_list * list = mapped_list_open(path, sizeof(int));
+	int value = 1;
+	mapped_list_append(list, & value);
+	mapped_list_close(& list);
+	char foreign_path[] = "/tmp/mapped_list_foreign_XXXXXX";
+	int fd = mkstemp(foreign_path);
+	cr_assert_eq(write(fd, "not a list, not at all, really not a list", 42), 42, "file wasn't written");
+	close(fd);
+
+	// when opening them as lists
+	mapped_list * doubles = mapped_list_open(path, sizeof(double));
+	mapped_list * foreign = mapped_list_open(foreign_path, sizeof(int));
+
+	// then they should be refused
+	cr_assert_null(doubles, "list of ints was opened as doubles");
+	cr_assert_null(foreign, "foreign file was opened");
+	unlink(path);
+	unlink(foreign_path);
+}
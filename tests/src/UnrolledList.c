@@ -0,0 +1,206 @@
+
+#include <criterion/criterion.h>
+#include <string.h>
+
+#include "../../include/UnrolledList.h"
+
+
+
+
+static unrolled_list * unrolled_list_of_size(size_t size)
+{
+	static char const * const digits = "0123456789";
+	unrolled_list * list = unrolled_list_create();
+
+	for (size_t index = 0; index < size; index++)
+		unrolled_list_append(list, (void *) (digits + index % 10));
+
+	return list;
+}
+
+
+static void store_values_in_buffer_reducer(
+	void * accumulator,
+	void const * value)
+{
+	char * buffer = accumulator;
+
+	buffer[strlen(buffer)] = ((char *) value)[0];
+}
+
+
+
+
+Test(unrolled_list, is_empty_on_creation)
+{
+	// given a new list
+	unrolled_list * list = unrolled_list_create();
+
+	// when checking its size
+	size_t size = unrolled_list_size(list);
+
+	// then it should be 0
+	cr_assert_eq(size, 0, "list is not empty");
+	cr_assert_null(unrolled_list_head(list).node, "empty list has a head");
+}
+
+
+Test(unrolled_list, append_adds_at_the_end)
+{
+	// given a list spanning several nodes
+	unrolled_list * list = unrolled_list_of_size(40);
+
+	// when appending another value
+	unrolled_list_append(list, "foo");
+
+	// then it should be the last value
+	cr_assert_str_eq(
+		unrolled_list_content(unrolled_list_tail(list)),
+		"foo",
+		"value wasn't added at the end");
+	cr_assert_eq(unrolled_list_size(list), 41, "length wasn't incremented");
+}
+
+
+Test(unrolled_list, prepend_adds_at_the_beginning)
+{
+	// given a list spanning several nodes
+	unrolled_list * list = unrolled_list_of_size(40);
+
+	// when prepending another value
+	unrolled_list_prepend(list, "foo");
+
+	// then it should be the first value
+	cr_assert_str_eq(
+		unrolled_list_content(unrolled_list_head(list)),
+		"foo",
+		"value wasn't added at the beginning");
+	cr_assert_eq(unrolled_list_size(list), 41, "length wasn't incremented");
+}
+
+
+Test(unrolled_list, reduce_applies_to_every_value_in_order)
+{
+	// given a list filled from both ends
+	unrolled_list * list = unrolled_list_create();
+	unrolled_list_append(list, "3");
+	unrolled_list_prepend(list, "2");
+	unrolled_list_append(list, "4");
+	unrolled_list_prepend(list, "1");
+
+	// when applying a callback to its values
+	char callback_buffer[5] = { 0 };
+	unrolled_list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+
+	// then it should have visited every value in order
+	cr_assert_str_eq("1234", callback_buffer, "values weren't visited in order");
+}
+
+
+Test(unrolled_list, cursor_walks_across_nodes_both_ways)
+{
+	// given a list spanning several nodes
+	unrolled_list * list = unrolled_list_of_size(30);
+
+	// when walking to the end then back to the beginning
+	size_t forward_steps = 0;
+	unrolled_cursor cursor = unrolled_list_head(list);
+	unrolled_cursor last = cursor;
+	while (cursor.node != NULL)
+	{
+		last = cursor;
+		cursor = unrolled_list_next(cursor);
+		forward_steps++;
+	}
+	size_t backward_steps = 0;
+	for (cursor = last; cursor.node != NULL; cursor = unrolled_list_previous(cursor))
+		backward_steps++;
+
+	// then every value should have been reached in both directions
+	cr_assert_eq(forward_steps, 30, "not every value was reached forward");
+	cr_assert_eq(backward_steps, 30, "not every value was reached backward");
+}
+
+
+Test(unrolled_list, remove_moves_cursor_to_next_value)
+{
+	// given a list spanning several nodes
+	unrolled_list * list = unrolled_list_of_size(30);
+
+	// when removing every even digit
+	unrolled_cursor cursor = unrolled_list_head(list);
+	while (cursor.node != NULL)
+	{
+		if ((*(char *) unrolled_list_content(cursor) - '0') % 2 == 0)
+			unrolled_list_remove(list, & cursor);
+		else
+			cursor = unrolled_list_next(cursor);
+	}
+
+	// then only odd digits should be left, in order
+	char callback_buffer[16] = { 0 };
+	unrolled_list_reduce(list, callback_buffer, store_values_in_buffer_reducer);
+	cr_assert_str_eq("135791357913579", callback_buffer, "wrong values left");
+	cr_assert_eq(unrolled_list_size(list), 15, "length wasn't decremented");
+}
+
+
+Test(unrolled_list, removing_every_value_makes_it_empty)
+{
+	// given a list spanning several nodes
+	unrolled_list * list = unrolled_list_of_size(30);
+
+	// when removing values from the head until there is none
+	unrolled_cursor cursor = unrolled_list_head(list);
+	while (cursor.node != NULL)
+		unrolled_list_remove(list, & cursor);
+
+	// then the list should be empty
+	cr_assert_eq(unrolled_list_size(list), 0, "list is not empty");
+	cr_assert_null(unrolled_list_tail(list).node, "empty list has a tail");
+}
+
+
+Test(unrolled_list, remove_from_tail_moves_the_tail)
+{
+	// given a list spanning several nodes
+	unrolled_list * list = unrolled_list_of_size(14);
+
+	// when removing the last value
+	unrolled_cursor tail = unrolled_list_tail(list);
+	unrolled_list_remove(list, & tail);
+
+	// then the value before should be the tail
+	cr_assert_null(tail.node, "cursor moved past the end");
+	char const * new_tail = unrolled_list_content(unrolled_list_tail(list));
+	cr_assert_eq(new_tail[0], '2', "tail wasn't moved");
+}
+
+
+Test(unrolled_list, delete_sets_list_to_null)
+{
+	// given a list spanning several nodes
+	unrolled_list * list = unrolled_list_of_size(30);
+
+	// when deleting it
+	unrolled_list_delete(& list);
+
+	// then it should have been set to NULL
+	cr_assert_null(list, "list hasn't been freed and set to NULL");
+}
+
+
+Test(unrolled_list, operations_on_null_dont_crash)
+{
+	// given no list
+	unrolled_list * of_nothing = NULL;
+
+	// when trying to use it
+	unrolled_list_append(of_nothing, "foo");
+	unrolled_list_prepend(of_nothing, "foo");
+	unrolled_list_remove(of_nothing, NULL);
+	unrolled_list_delete(& of_nothing);
+
+	// then it shouldn't crash
+	cr_assert_eq(unrolled_list_size(of_nothing), 0, "no list has a size");
+}
@@ -6,10 +6,8 @@
 
 
 
-static linked_list * list_of_size(size_t size)
+static linked_list * fill_list(linked_list * list, size_t size)
 {
-	linked_list * list = list_create();
-
 	list_append(& list, "head");
 	list_append(& list, "second node");
 	list_append(& list, "third node");
@@ -23,6 +21,12 @@ static linked_list * list_of_size(size_t size)
 }
 
 
+linked_list * list_of_size(size_t size)
+{
+	return fill_list(list_create(), size);
+}
+
+
 linked_list * small_list(void)
 {
 	return list_of_size(4);
@@ -33,3 +37,9 @@ linked_list * big_list(void)
 {
 	return list_of_size(BIG_LIST_SIZE);
 }
+
+
+linked_list * big_pooled_list(void)
+{
+	return fill_list(list_create_pooled(0), BIG_LIST_SIZE);
+}
@@ -8,6 +8,17 @@
 
 
 
+/**
+ * @brief - creates a list with the given count of elements (at least 4) and
+ * 	returns it
+ *
+ * @param size - how many elements the list holds
+ *
+ * @return linked_list * - the created list
+ */
+linked_list * list_of_size(size_t size);
+
+
 /**
  * @brief - creates a list with a few elements (less than 10) and returns it
  *
@@ -25,6 +36,15 @@ linked_list * small_list(void);
 linked_list * big_list(void);
 
 
+/**
+ * @brief - creates a pooled list with a lot of elements (expected to be
+ * 	> 1 million) and returns it
+ *
+ * @return linked_list * - the pooled linked list
+ */
+linked_list * big_pooled_list(void);
+
+
 
 
 #endif /* LIST_UTILS_HEADER */